@@ -0,0 +1,74 @@
+-- Moves the entities back and forth along x between two columns. Behaviours
+-- get every entity using them at once, as arrays indexed 1 to view.count.
+behaviour("patrol", function(view, dt)
+    local x, vx = view.x, view.vx
+    for i = 1, view.count do
+        if x[i] < 400 then
+            vx[i] = 40
+        elseif x[i] > 700 then
+            vx[i] = -40
+        end
+    end
+end)
+
+Level = {
+    entities = {
+        {
+            group = "enemies",
+            components = {
+                transform = {
+                    position = { x = 500, y = 10 },
+                    scale = { x = 1, y = 1 },
+                    rotation = 0,
+                },
+                rigidbody = { velocity = { x = 40, y = 0 } },
+                sprite = {
+                    texture_asset_id = "tank-image",
+                    width = 32,
+                    height = 32,
+                    z_index = 1,
+                },
+                boxcollider = { width = 32, height = 32 },
+                health = { health_percentage = 100 },
+                projectile_emitter = {
+                    projectile_velocity = { x = 100, y = 0 },
+                    repeat_frequency = 5000,
+                    projectile_duration = 3000,
+                    hit_percentage_damage = 10,
+                    friendly = false,
+                    texture_asset_id = "bullet-image",
+                    sound_asset_id = "shot-sound",
+                },
+                script = { behaviour = "patrol" },
+            },
+        },
+        {
+            group = "enemies",
+            components = {
+                transform = {
+                    position = { x = 10, y = 10 },
+                    scale = { x = 1, y = 1 },
+                    rotation = 0,
+                },
+                rigidbody = { velocity = { x = 0, y = 0 } },
+                sprite = {
+                    texture_asset_id = "truck-image",
+                    width = 32,
+                    height = 32,
+                    z_index = 2,
+                },
+                boxcollider = { width = 32, height = 32 },
+                health = { health_percentage = 100 },
+                projectile_emitter = {
+                    projectile_velocity = { x = 0, y = 100 },
+                    repeat_frequency = 2000,
+                    projectile_duration = 5000,
+                    hit_percentage_damage = 10,
+                    friendly = false,
+                    texture_asset_id = "bullet-image",
+                    sound_asset_id = "shot-sound",
+                },
+            },
+        },
+    },
+}
@@ -0,0 +1,208 @@
+////////////////////////////////////////////////////////////////////////////////
+// BlitterBench
+////////////////////////////////////////////////////////////////////////////////
+// Draws the same frames of randomly placed, scaled and alpha blended sprites
+// with SDL's software renderer and with the CPU blitter backend, then reports
+// frames per second for both and how many pixels of the last frame differ.
+//
+// Usage: blitbench [--sprites <count>] [--frames <count>] [--threads <count>]
+////////////////////////////////////////////////////////////////////////////////
+#include "../src/Renderer/CpuRenderBackend.h"
+#include "../src/Renderer/SoftwareRenderBackend.h"
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+// SDL's unscaled blend path rounds with >> 8 instead of / 255, so pixels of
+// sprites drawn at scale 1 can be off by one or two
+const int CHANNEL_TOLERANCE = 2;
+
+struct BenchSprite {
+    int      texture;
+    SDL_Rect srcRect;
+    SDL_Rect dstRect;
+};
+
+struct BenchResult {
+    double fps;
+    double msPerFrame;
+};
+
+// Sprite sheets with soft edges, fully transparent corners and opaque cores
+std::vector<SDL_Surface*> MakeTextures(std::mt19937& rng) {
+    std::vector<SDL_Surface*> surfaces;
+    for (int i = 0; i < 6; i++) {
+        const int    size = 32 << (i % 3);
+        SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(
+            0, size, size, 32, SDL_PIXELFORMAT_ARGB8888);
+        Uint32* pixels = static_cast<Uint32*>(surface->pixels);
+        for (int y = 0; y < size; y++) {
+            for (int x = 0; x < size; x++) {
+                const int dx = x - size / 2;
+                const int dy = y - size / 2;
+                const int distance =
+                    (dx * dx + dy * dy) * 255 / (size * size / 4);
+                const Uint32 alpha = distance >= 255 ? 0 : 255 - distance;
+                pixels[y * surface->pitch / 4 + x] =
+                    (alpha << 24) | (rng() & 0x00FFFFFF);
+            }
+        }
+        surfaces.push_back(surface);
+    }
+    return surfaces;
+}
+
+std::vector<BenchSprite> MakeScene(std::mt19937& rng,
+                                   const std::vector<SDL_Surface*>& surfaces,
+                                   int width, int height, int numSprites) {
+    std::vector<BenchSprite> sprites;
+    for (int i = 0; i < numSprites; i++) {
+        BenchSprite sprite;
+        sprite.texture = rng() % surfaces.size();
+        const int size = surfaces[sprite.texture]->w;
+        const int srcSize = size / 2 + rng() % (size / 2);
+        sprite.srcRect = {static_cast<int>(rng() % (size - srcSize + 1)),
+                          static_cast<int>(rng() % (size - srcSize + 1)),
+                          srcSize, srcSize};
+
+        // Mix of unscaled, upscaled and downscaled sprites
+        const int scale = rng() % 4;
+        int       dstSize = srcSize;
+        if (scale == 1) {
+            dstSize = srcSize * 2;
+        } else if (scale == 2) {
+            dstSize = srcSize * 3 / 2;
+        } else if (scale == 3) {
+            dstSize = std::max(1, srcSize / 2);
+        }
+        sprite.dstRect = {static_cast<int>(rng() % (width - dstSize)),
+                          static_cast<int>(rng() % (height - dstSize)),
+                          dstSize, dstSize};
+        sprites.push_back(sprite);
+    }
+    return sprites;
+}
+
+BenchResult RunFrames(RenderBackend&                   backend,
+                      const std::vector<SDL_Texture*>& textures,
+                      const std::vector<BenchSprite>& sprites, int numFrames) {
+    Uint64 start = 0;
+    // The first frame warms up caches and worker threads
+    for (int frame = -1; frame < numFrames; frame++) {
+        if (frame == 0) {
+            start = SDL_GetPerformanceCounter();
+        }
+        backend.Clear({21, 21, 21, 255});
+        for (const auto& sprite : sprites) {
+            backend.DrawTexture(textures[sprite.texture], &sprite.srcRect,
+                                &sprite.dstRect);
+        }
+        backend.Present();
+    }
+    double seconds = static_cast<double>(SDL_GetPerformanceCounter() - start) /
+                     SDL_GetPerformanceFrequency();
+    return {numFrames / seconds, seconds * 1000.0 / numFrames};
+}
+
+bool CompareFrames(SDL_Surface* expected, SDL_Surface* actual) {
+    long long mismatches = 0;
+    int       maxDifference = 0;
+    for (int y = 0; y < expected->h; y++) {
+        const Uint32* expectedRow = reinterpret_cast<const Uint32*>(
+            static_cast<Uint8*>(expected->pixels) + y * expected->pitch);
+        const Uint32* actualRow = reinterpret_cast<const Uint32*>(
+            static_cast<Uint8*>(actual->pixels) + y * actual->pitch);
+        for (int x = 0; x < expected->w; x++) {
+            if (expectedRow[x] == actualRow[x]) {
+                continue;
+            }
+            mismatches++;
+            for (int shift = 0; shift < 32; shift += 8) {
+                int difference = std::abs(
+                    static_cast<int>((expectedRow[x] >> shift) & 0xFF) -
+                    static_cast<int>((actualRow[x] >> shift) & 0xFF));
+                maxDifference = std::max(maxDifference, difference);
+            }
+        }
+    }
+
+    const bool      isMatch = maxDifference <= CHANNEL_TOLERANCE;
+    const long long numPixels =
+        static_cast<long long>(expected->w) * expected->h;
+    std::printf("  pixels differing: %lld of %lld (%.3f%%), max channel "
+                "difference %d -> %s\n",
+                mismatches, numPixels, 100.0 * mismatches / numPixels,
+                maxDifference, isMatch ? "PASS" : "FAIL");
+    return isMatch;
+}
+
+bool RunResolution(int width, int height, int numSprites, int numFrames,
+                   int numThreads) {
+    std::mt19937              rng(1234);
+    std::vector<SDL_Surface*> surfaces = MakeTextures(rng);
+    std::vector<BenchSprite>  sprites =
+        MakeScene(rng, surfaces, width, height, numSprites);
+
+    SoftwareRenderBackend sdlBackend;
+    CpuRenderBackend      cpuBackend("", numThreads);
+    if (!sdlBackend.Initialize(width, height) ||
+        !cpuBackend.Initialize(width, height)) {
+        return false;
+    }
+
+    std::vector<SDL_Texture*> sdlTextures;
+    std::vector<SDL_Texture*> cpuTextures;
+    for (auto surface : surfaces) {
+        sdlTextures.push_back(sdlBackend.CreateTexture(surface));
+        cpuTextures.push_back(cpuBackend.CreateTexture(surface));
+        SDL_FreeSurface(surface);
+    }
+
+    BenchResult sdl = RunFrames(sdlBackend, sdlTextures, sprites, numFrames);
+    BenchResult cpu = RunFrames(cpuBackend, cpuTextures, sprites, numFrames);
+
+    std::printf("%dx%d, %d sprites, %d frames\n", width, height, numSprites,
+                numFrames);
+    std::printf("  sdl software: %8.1f fps (%.2f ms/frame)\n", sdl.fps,
+                sdl.msPerFrame);
+    std::printf("  cpu blitter:  %8.1f fps (%.2f ms/frame), %.2fx\n", cpu.fps,
+                cpu.msPerFrame, cpu.fps / sdl.fps);
+    bool isMatch =
+        CompareFrames(sdlBackend.GetSurface(), cpuBackend.GetSurface());
+
+    sdlBackend.Destroy();
+    cpuBackend.Destroy();
+    return isMatch;
+}
+
+int main(int argc, char* argv[]) {
+    int numSprites = 2000;
+    int numFrames = 200;
+    int numThreads = 0;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        if (arg == "--sprites") {
+            numSprites = std::atoi(argv[i + 1]);
+        } else if (arg == "--frames") {
+            numFrames = std::atoi(argv[i + 1]);
+        } else if (arg == "--threads") {
+            numThreads = std::atoi(argv[i + 1]);
+        }
+    }
+
+    if (SDL_Init(SDL_INIT_TIMER) != 0) {
+        std::fprintf(stderr, "Error initializing SDL: %s\n", SDL_GetError());
+        return 1;
+    }
+    std::printf("row blending path: %s\n", SpriteBlitter::GetSimdPath());
+
+    bool isMatch = RunResolution(800, 600, numSprites, numFrames, numThreads);
+    isMatch &= RunResolution(1920, 1080, numSprites, numFrames, numThreads);
+
+    SDL_Quit();
+    return isMatch ? 0 : 1;
+}
@@ -0,0 +1,477 @@
+////////////////////////////////////////////////////////////////////////////////
+// EcsBench
+////////////////////////////////////////////////////////////////////////////////
+// Times the registry, component storage, tag and group queries, the event bus
+// and the movement, collision and render systems at a range of entity counts.
+// Every case repeats its batch until the minimum time went by and reports
+// nanoseconds per operation. The results go out as JSON, stamped with the
+// commit the bench was built from, so runs can be compared across commits;
+// progress goes to stderr.
+//
+// Usage: ecsbench [--entities <count,count,...>] [--min-time <seconds>]
+//                 [--max-collision <count>] [--json <file>]
+////////////////////////////////////////////////////////////////////////////////
+#include "../src/AssetStore/AssetStore.h"
+#include "../src/Components/BoxColliderComponent.h"
+#include "../src/Components/ProjectileComponent.h"
+#include "../src/Components/RigidBodyComponent.h"
+#include "../src/Components/SpriteComponent.h"
+#include "../src/Components/TransformComponent.h"
+#include "../src/ECS/ECS.h"
+#include "../src/EventBus/EventBus.h"
+#include "../src/Events/CollisionEvent.h"
+#include "../src/Logger/Logger.h"
+#include "../src/Renderer/NullRenderBackend.h"
+#include "../src/Systems/CollisionSystem.h"
+#include "../src/Systems/MovementSystem.h"
+#include "../src/Systems/ProjectileLifecycleSystem.h"
+#include "../src/Systems/RenderSystem.h"
+#include "../src/Timers/TimerWheel.h"
+#include <SDL2/SDL.h>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#ifndef BENCH_COMMIT
+#define BENCH_COMMIT "unknown"
+#endif
+
+const double BENCH_DELTA_TIME = 1.0 / 60.0;
+// Events emitted per batch of the event bus cases
+const int BENCH_NUM_EVENTS = 100000;
+const int BENCH_SUBSCRIBER_COUNTS[] = {1, 10, 100};
+// Textures the sprites are spread over, never loaded
+const int BENCH_NUM_TEXTURES = 8;
+
+struct BenchResult {
+    std::string name;
+    int         numEntities;
+    int         numSubscribers;
+    long long   numOps;
+    double      nsPerOp;
+};
+
+struct BenchOptions {
+    std::vector<int> entityCounts = {1000, 10000, 100000, 1000000};
+    double           minSeconds = 0.2;
+    // The collision system tests every pair, past this it takes minutes
+    int         maxCollisionEntities = 10000;
+    std::string jsonPath;
+};
+
+// Keeps the optimizer from dropping the loops that only read components
+volatile float g_sink;
+
+// Runs the batch until the minimum time went by, the batch returns how many
+// operations it did
+template <typename TBatch>
+BenchResult Measure(const BenchOptions& options, const std::string& name,
+                    int numEntities, TBatch batch) {
+    const Uint64 minTicks = static_cast<Uint64>(
+        options.minSeconds * SDL_GetPerformanceFrequency());
+    Uint64    elapsed = 0;
+    long long numOps = 0;
+    do {
+        Uint64 start = SDL_GetPerformanceCounter();
+        numOps += batch();
+        elapsed += SDL_GetPerformanceCounter() - start;
+    } while (elapsed < minTicks);
+
+    BenchResult result;
+    result.name = name;
+    result.numEntities = numEntities;
+    result.numSubscribers = 0;
+    result.numOps = numOps;
+    result.nsPerOp = elapsed * 1e9 / SDL_GetPerformanceFrequency() / numOps;
+    return result;
+}
+
+void Report(std::vector<BenchResult>& results, const BenchResult& result) {
+    if (result.numSubscribers > 0) {
+        std::fprintf(stderr, "%-24s %8d subscribers %9.1f ns/op\n",
+                     result.name.c_str(), result.numSubscribers,
+                     result.nsPerOp);
+    } else {
+        std::fprintf(stderr, "%-24s %8d entities %12.1f ns/op\n",
+                     result.name.c_str(), result.numEntities, result.nsPerOp);
+    }
+    results.push_back(result);
+}
+
+std::vector<Entity> CreateEntities(Registry& registry, int numEntities) {
+    std::vector<Entity> entities;
+    entities.reserve(numEntities);
+    for (int i = 0; i < numEntities; i++) {
+        entities.push_back(registry.CreateEntity());
+    }
+    return entities;
+}
+
+// Spread on a grid further apart than their size, nothing collides
+glm::vec2 GridPosition(int i) {
+    return glm::vec2((i % 1000) * 40.0f, (i / 1000) * 40.0f);
+}
+
+void BenchRegistry(const BenchOptions& options, int numEntities,
+                   std::vector<BenchResult>& results) {
+    Registry registry;
+    Report(results, Measure(options, "registry.create_kill", numEntities, [&] {
+        auto entities = CreateEntities(registry, numEntities);
+        for (auto entity : entities) {
+            entity.AddComponent<TransformComponent>();
+        }
+        registry.Update();
+        for (auto entity : entities) {
+            entity.Kill();
+        }
+        registry.Update();
+        return static_cast<long long>(numEntities);
+    }));
+}
+
+// Projectiles of the volley cases are gone before they expire, the ones in
+// flight during the lifecycle ticks never expire
+const int BENCH_PROJECTILE_DURATION = 1000;
+const int BENCH_IDLE_PROJECTILE_DURATION = 1 << 30;
+const int BENCH_TICK_MS = 16;
+
+// Arms a projectile the way the ProjectileEmitSystem does
+void ArmProjectile(Entity projectile, int i,
+                   int duration = BENCH_PROJECTILE_DURATION) {
+    projectile.AddComponent<TransformComponent>(GridPosition(i));
+    projectile.AddComponent<RigidBodyComponent>(glm::vec2(100.0, 0.0));
+    projectile.AddComponent<SpriteComponent>(INVALID_TEXTURE_HANDLE, 4, 4, 4);
+    projectile.AddComponent<BoxColliderComponent>(4, 4);
+    projectile.AddComponent<ProjectileComponent>(true, 10, duration);
+}
+
+// A volley of projectiles fired and gone again, through new entities and
+// through the pool, then a tick of the lifecycle with a volley in flight
+void BenchProjectiles(const BenchOptions& options, int numEntities,
+                      std::vector<BenchResult>& results) {
+    TimerWheel timers;
+    Registry   registry;
+    registry.AddSystem<MovementSystem>();
+    registry.AddSystem<CollisionSystem>();
+    registry.AddSystem<RenderSystem>();
+    registry.AddSystem<ProjectileLifecycleSystem>(timers);
+    std::vector<Entity> projectiles;
+    projectiles.reserve(numEntities);
+
+    // The expiry timers of the volley come due, and are dropped as stale
+    auto expireVolley = [&] {
+        timers.Advance(timers.GetTime() + BENCH_PROJECTILE_DURATION + 1);
+    };
+
+    Report(results,
+           Measure(options, "projectile.create_kill", numEntities, [&] {
+               projectiles.clear();
+               for (int i = 0; i < numEntities; i++) {
+                   projectiles.push_back(registry.CreateEntity());
+                   projectiles.back().Group("projectiles");
+                   ArmProjectile(projectiles.back(), i);
+               }
+               registry.Update();
+               for (auto projectile : projectiles) {
+                   projectile.Kill();
+               }
+               registry.Update();
+               expireVolley();
+               return static_cast<long long>(numEntities);
+           }));
+
+    Report(results, Measure(options, "projectile.pooled", numEntities, [&] {
+        projectiles.clear();
+        for (int i = 0; i < numEntities; i++) {
+            projectiles.push_back(registry.CreatePooledEntity("projectiles"));
+            ArmProjectile(projectiles.back(), i);
+        }
+        registry.Update();
+        for (auto projectile : projectiles) {
+            projectile.Recycle();
+        }
+        registry.Update();
+        expireVolley();
+        return static_cast<long long>(numEntities);
+    }));
+
+    for (int i = 0; i < numEntities; i++) {
+        ArmProjectile(registry.CreatePooledEntity("projectiles"), i,
+                      BENCH_IDLE_PROJECTILE_DURATION);
+    }
+    registry.Update();
+    auto& lifecycleSystem = registry.GetSystem<ProjectileLifecycleSystem>();
+    Report(results,
+           Measure(options, "projectile.lifecycle_tick", numEntities, [&] {
+               timers.Advance(timers.GetTime() + BENCH_TICK_MS);
+               lifecycleSystem.Update();
+               return 1LL;
+           }));
+}
+
+void BenchComponents(const BenchOptions& options, int numEntities,
+                     std::vector<BenchResult>& results) {
+    Registry registry;
+    auto     entities = CreateEntities(registry, numEntities);
+    for (int i = 0; i < numEntities; i++) {
+        entities[i].AddComponent<TransformComponent>(GridPosition(i));
+    }
+    registry.Update();
+
+    Report(results, Measure(options, "component.add_remove", numEntities, [&] {
+        for (auto entity : entities) {
+            entity.AddComponent<RigidBodyComponent>();
+        }
+        for (auto entity : entities) {
+            entity.RemoveComponent<RigidBodyComponent>();
+        }
+        return 2LL * numEntities;
+    }));
+
+    Report(results, Measure(options, "component.get", numEntities, [&] {
+        float sum = 0.0f;
+        for (auto entity : entities) {
+            sum += entity.GetComponent<TransformComponent>().position.x;
+        }
+        g_sink = sum;
+        return static_cast<long long>(numEntities);
+    }));
+
+    for (int i = 0; i < numEntities; i += 2) {
+        entities[i].AddComponent<RigidBodyComponent>();
+    }
+    Report(results, Measure(options, "component.has", numEntities, [&] {
+        int numWith = 0;
+        for (auto entity : entities) {
+            numWith += entity.HasComponent<RigidBodyComponent>();
+        }
+        g_sink = numWith;
+        return static_cast<long long>(numEntities);
+    }));
+}
+
+void BenchTagsAndGroups(const BenchOptions& options, int numEntities,
+                        std::vector<BenchResult>& results) {
+    Registry                 registry;
+    auto                     entities = CreateEntities(registry, numEntities);
+    std::vector<std::string> tags;
+    tags.reserve(numEntities);
+    for (int i = 0; i < numEntities; i++) {
+        tags.push_back("entity" + std::to_string(i));
+        entities[i].Tag(tags[i]);
+        if (i % 2 == 0) {
+            entities[i].Group("enemies");
+        }
+    }
+    registry.Update();
+
+    Report(results, Measure(options, "tag.get_entity", numEntities, [&] {
+        int sum = 0;
+        for (const auto& tag : tags) {
+            sum += registry.GetEntityByTag(tag).GetId();
+        }
+        g_sink = sum;
+        return static_cast<long long>(numEntities);
+    }));
+
+    Report(results, Measure(options, "group.belongs", numEntities, [&] {
+        int numEnemies = 0;
+        for (auto entity : entities) {
+            numEnemies += entity.BelongsToGroup("enemies");
+        }
+        g_sink = numEnemies;
+        return static_cast<long long>(numEntities);
+    }));
+
+    // Per entity of the group
+    Report(results, Measure(options, "group.get_entities", numEntities, [&] {
+        auto enemies = registry.GetEntitiesByGroup("enemies");
+        return static_cast<long long>(enemies.size());
+    }));
+}
+
+class BenchSubscriber {
+public:
+    int numEvents = 0;
+    void OnCollision(CollisionEvent& event) { numEvents++; }
+};
+
+void BenchEventBus(const BenchOptions& options,
+                   std::vector<BenchResult>& results) {
+    Registry registry;
+    Entity   a = registry.CreateEntity();
+    Entity   b = registry.CreateEntity();
+
+    for (int numSubscribers : BENCH_SUBSCRIBER_COUNTS) {
+        auto                         eventBus = std::make_unique<EventBus>();
+        std::vector<BenchSubscriber> subscribers(numSubscribers);
+        for (auto& subscriber : subscribers) {
+            eventBus->SubscribeToEvent<CollisionEvent>(
+                &subscriber, &BenchSubscriber::OnCollision);
+        }
+
+        BenchResult result = Measure(options, "eventbus.emit", 0, [&] {
+            for (int i = 0; i < BENCH_NUM_EVENTS; i++) {
+                eventBus->EmitEvent<CollisionEvent>(a, b);
+            }
+            return static_cast<long long>(BENCH_NUM_EVENTS);
+        });
+        result.numSubscribers = numSubscribers;
+        Report(results, result);
+    }
+}
+
+void BenchSystems(const BenchOptions& options, int numEntities,
+                  std::vector<BenchResult>& results) {
+    Registry registry;
+    registry.AddSystem<MovementSystem>();
+    registry.AddSystem<CollisionSystem>();
+    registry.AddSystem<RenderSystem>();
+
+    auto assetStore = std::make_unique<AssetStore>();
+    assetStore->SetHeadless(true);
+    std::vector<TextureHandle> textures;
+    for (int i = 0; i < BENCH_NUM_TEXTURES; i++) {
+        textures.push_back(
+            assetStore->AddTexture("texture" + std::to_string(i), ""));
+    }
+    std::unique_ptr<RenderBackend> renderer =
+        std::make_unique<NullRenderBackend>();
+    renderer->Initialize(800, 600);
+    auto eventBus = std::make_unique<EventBus>();
+
+    // Movement and render run over every entity, collision only over as
+    // many as it can get through
+    const bool isCollision = numEntities <= options.maxCollisionEntities;
+    auto       entities = CreateEntities(registry, numEntities);
+    for (int i = 0; i < numEntities; i++) {
+        entities[i].AddComponent<TransformComponent>(GridPosition(i));
+        entities[i].AddComponent<RigidBodyComponent>(glm::vec2(10.0, 5.0));
+        entities[i].AddComponent<SpriteComponent>(
+            textures[i % BENCH_NUM_TEXTURES], 32, 32, i % 4);
+        if (isCollision) {
+            entities[i].AddComponent<BoxColliderComponent>(32, 32);
+        }
+    }
+    registry.Update();
+
+    auto& movementSystem = registry.GetSystem<MovementSystem>();
+    Report(results, Measure(options, "system.movement", numEntities, [&] {
+        movementSystem.Update(BENCH_DELTA_TIME);
+        return static_cast<long long>(numEntities);
+    }));
+
+    if (isCollision) {
+        auto& collisionSystem = registry.GetSystem<CollisionSystem>();
+        Report(results, Measure(options, "system.collision", numEntities, [&] {
+            collisionSystem.Update(eventBus);
+            return static_cast<long long>(numEntities);
+        }));
+    }
+
+    auto& renderSystem = registry.GetSystem<RenderSystem>();
+    std::vector<SpriteDrawCommand> commands;
+    const SDL_Rect                 camera = {0, 0, 800, 600};
+    Report(results, Measure(options, "system.render", numEntities, [&] {
+        renderSystem.BuildRenderCommands(assetStore, camera, camera, commands);
+        RenderSystem::SortRenderCommands(commands);
+        renderSystem.Submit(renderer, commands);
+        renderer->Present();
+        return static_cast<long long>(numEntities);
+    }));
+
+    assetStore->ClearAssets(*renderer);
+    renderer->Destroy();
+}
+
+bool WriteJson(const BenchOptions&             options,
+               const std::vector<BenchResult>& results) {
+    FILE* file = stdout;
+    if (!options.jsonPath.empty()) {
+        file = std::fopen(options.jsonPath.c_str(), "w");
+        if (!file) {
+            std::fprintf(stderr, "Error creating %s\n",
+                         options.jsonPath.c_str());
+            return false;
+        }
+    }
+
+    std::fprintf(file, "{\n  \"commit\": \"%s\",\n  \"min_time_s\": %g,\n",
+                 BENCH_COMMIT, options.minSeconds);
+    std::fprintf(file, "  \"results\": [");
+    for (std::size_t i = 0; i < results.size(); i++) {
+        const BenchResult& result = results[i];
+        std::fprintf(file,
+                     "%s\n    {\"name\": \"%s\", \"entities\": %d, "
+                     "\"subscribers\": %d, \"ops\": %lld, "
+                     "\"ns_per_op\": %.3f}",
+                     i == 0 ? "" : ",", result.name.c_str(),
+                     result.numEntities, result.numSubscribers, result.numOps,
+                     result.nsPerOp);
+    }
+    std::fprintf(file, "\n  ]\n}\n");
+
+    if (file != stdout) {
+        std::fclose(file);
+        std::fprintf(stderr, "Results written to %s\n",
+                     options.jsonPath.c_str());
+    }
+    return true;
+}
+
+std::vector<int> ParseCounts(const std::string& text) {
+    std::vector<int> counts;
+    std::size_t      start = 0;
+    while (start < text.size()) {
+        std::size_t end = text.find(',', start);
+        if (end == std::string::npos) {
+            end = text.size();
+        }
+        int count = std::atoi(text.substr(start, end - start).c_str());
+        if (count > 0) {
+            counts.push_back(count);
+        }
+        start = end + 1;
+    }
+    return counts;
+}
+
+int main(int argc, char* argv[]) {
+    BenchOptions options;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        if (arg == "--entities") {
+            options.entityCounts = ParseCounts(argv[i + 1]);
+        } else if (arg == "--min-time") {
+            options.minSeconds = std::atof(argv[i + 1]);
+        } else if (arg == "--max-collision") {
+            options.maxCollisionEntities = std::atoi(argv[i + 1]);
+        } else if (arg == "--json") {
+            options.jsonPath = argv[i + 1];
+        }
+    }
+    if (options.entityCounts.empty() || options.minSeconds <= 0.0) {
+        std::fprintf(stderr,
+                     "Usage: ecsbench [--entities <count,count,...>] "
+                     "[--min-time <seconds>] [--max-collision <count>] "
+                     "[--json <file>]\n");
+        return 1;
+    }
+
+    // The registry logs every entity and component at the debug level, keep
+    // it out of the timings and the JSON
+    Logger::SetLevel(LOG_WARNING);
+
+    std::vector<BenchResult> results;
+    for (int numEntities : options.entityCounts) {
+        BenchRegistry(options, numEntities, results);
+        BenchProjectiles(options, numEntities, results);
+        BenchComponents(options, numEntities, results);
+        BenchTagsAndGroups(options, numEntities, results);
+        BenchSystems(options, numEntities, results);
+    }
+    BenchEventBus(options, results);
+
+    return WriteJson(options, results) ? 0 : 1;
+}
@@ -0,0 +1,176 @@
+////////////////////////////////////////////////////////////////////////////////
+// LoggerBench
+////////////////////////////////////////////////////////////////////////////////
+// Nanoseconds per log call of the logger the registry used to have, which
+// formatted, timestamped and wrote every message under a lock, against the
+// ring buffer logger: a preformatted string, a LOG_FORMAT message with its
+// raw arguments, and a LOG_FORMAT message below the runtime level. Every case
+// runs on 1 thread and then on --threads threads at once. The calls are timed
+// in bursts the rings can hold; the writer thread empties them between
+// bursts, outside of the timing, and the "+ write" column adds that time back
+// in. Messages go to /dev/null, the results to stderr.
+//
+// Usage: logbench [--min-time <seconds>] [--threads <count>]
+////////////////////////////////////////////////////////////////////////////////
+#include "../src/Logger/Logger.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Calls timed in a row, well within a ring
+const int BURST_SIZE = LOG_RING_SIZE / 2;
+
+// The logger as it was, kept here to compare against
+namespace legacy {
+std::vector<LogEntry> messages;
+std::mutex            mutex;
+
+std::string CurrentDateTimeToString() {
+    std::time_t now =
+        std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+    std::string output(30, '\0');
+    std::strftime(&output[0], output.size(), "%d-%b-%Y %H:%M:%S",
+                  std::localtime(&now));
+    return output;
+}
+
+void Log(const std::string& message) {
+    LogEntry logEntry;
+    logEntry.type = LOG_INFO;
+    logEntry.message = "LOG: [" + CurrentDateTimeToString() + "]: " + message;
+    std::lock_guard<std::mutex> lock(mutex);
+    std::cout << "\x1B[32m" << logEntry.message << "\033[0m" << std::endl;
+    messages.push_back(logEntry);
+}
+} // namespace legacy
+
+enum BenchCase {
+    BENCH_CASE_LEGACY,
+    BENCH_CASE_STRING,
+    BENCH_CASE_FORMAT,
+    BENCH_CASE_FILTERED,
+    NUM_BENCH_CASES
+};
+
+static const char* BENCH_CASE_NAMES[NUM_BENCH_CASES] = {
+    "legacy",
+    "string",
+    "format",
+    "filtered",
+};
+
+struct BurstTimes {
+    double callSeconds = 0.0;
+    double writeSeconds = 0.0;
+    long   numCalls = 0;
+};
+
+static double Seconds(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                         start)
+        .count();
+}
+
+static void LogBurst(BenchCase benchCase, int first) {
+    for (int i = first; i < first + BURST_SIZE; i++) {
+        switch (benchCase) {
+        case BENCH_CASE_LEGACY:
+            legacy::Log("Entity created with id " + std::to_string(i));
+            break;
+        case BENCH_CASE_STRING:
+            Logger::Log("Entity created with id " + std::to_string(i));
+            break;
+        default:
+            LOG_FORMAT(LOG_DEBUG, "Entity created with id {}", i);
+            break;
+        }
+    }
+}
+
+// Bursts on the calling thread until the minimum time went by
+static BurstTimes RunBursts(BenchCase benchCase, double minSeconds) {
+    BurstTimes times;
+    while (times.callSeconds < minSeconds) {
+        auto start = std::chrono::steady_clock::now();
+        LogBurst(benchCase, static_cast<int>(times.numCalls));
+        times.callSeconds += Seconds(start);
+        times.numCalls += BURST_SIZE;
+
+        start = std::chrono::steady_clock::now();
+        if (benchCase == BENCH_CASE_LEGACY) {
+            std::lock_guard<std::mutex> lock(legacy::mutex);
+            legacy::messages.clear();
+        } else {
+            Logger::Flush();
+            times.writeSeconds += Seconds(start);
+        }
+    }
+    return times;
+}
+
+static void Bench(BenchCase benchCase, int numThreads, double minSeconds) {
+    Logger::SetLevel(benchCase == BENCH_CASE_FILTERED ? LOG_INFO : LOG_DEBUG);
+
+    std::vector<BurstTimes>  times(numThreads);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < numThreads; i++) {
+        threads.emplace_back([&times, i, benchCase, minSeconds]() {
+            times[i] = RunBursts(benchCase, minSeconds);
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    double callNs = 0.0;
+    double writeNs = 0.0;
+    for (const auto& threadTimes : times) {
+        callNs += threadTimes.callSeconds * 1e9 / threadTimes.numCalls;
+        writeNs += threadTimes.writeSeconds * 1e9 / threadTimes.numCalls;
+    }
+    callNs /= numThreads;
+    writeNs /= numThreads;
+    std::fprintf(stderr, "%-10s %2d thread%s %9.1f ns/call %9.1f + write\n",
+                 BENCH_CASE_NAMES[benchCase], numThreads,
+                 numThreads > 1 ? "s" : " ", callNs, callNs + writeNs);
+}
+
+int main(int argc, char* argv[]) {
+    double minSeconds = 0.5;
+    int    numThreads = 4;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        if (arg == "--min-time") {
+            minSeconds = std::atof(argv[i + 1]);
+        } else if (arg == "--threads") {
+            numThreads = std::atoi(argv[i + 1]);
+        }
+    }
+    if (minSeconds <= 0.0 || numThreads < 1) {
+        std::fprintf(stderr,
+                     "Usage: logbench [--min-time <seconds>] "
+                     "[--threads <count>]\n");
+        return 1;
+    }
+
+    // Both loggers write to stdout, what is measured is the logging and not
+    // the terminal
+    if (!std::freopen("/dev/null", "w", stdout)) {
+        std::fprintf(stderr, "Could not redirect stdout to /dev/null\n");
+        return 1;
+    }
+
+    for (int benchCase = 0; benchCase < NUM_BENCH_CASES; benchCase++) {
+        Bench(static_cast<BenchCase>(benchCase), 1, minSeconds);
+        if (numThreads > 1) {
+            Bench(static_cast<BenchCase>(benchCase), numThreads, minSeconds);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,135 @@
+////////////////////////////////////////////////////////////////////////////////
+// ScriptBench
+////////////////////////////////////////////////////////////////////////////////
+// Moves the same entities for a number of ticks three ways: a C++ loop over
+// their components, a Lua behaviour doing the same math through the script
+// system, and an empty behaviour that only fills and reads back the view.
+// Reports microseconds per tick for every 10k entities, and how much the Lua
+// heap grew while the behaviours ran.
+//
+// Usage: scriptbench [--entities <count>] [--ticks <count>]
+////////////////////////////////////////////////////////////////////////////////
+#include "../src/Components/RigidBodyComponent.h"
+#include "../src/Components/ScriptComponent.h"
+#include "../src/Components/TransformComponent.h"
+#include "../src/ECS/ECS.h"
+#include "../src/Logger/Logger.h"
+#include "../src/Scripting/ScriptEngine.h"
+#include "../src/Systems/ScriptSystem.h"
+#include <SDL2/SDL.h>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+const double BENCH_DELTA_TIME = 1.0 / 60.0;
+
+const char* const BENCH_BEHAVIOURS = R"(
+behaviour("bounce", function(view, dt)
+    local x, y, vx, vy = view.x, view.y, view.vx, view.vy
+    for i = 1, view.count do
+        local nx = x[i] + vx[i] * dt
+        if nx < 0 or nx > 1000 then
+            vx[i] = -vx[i]
+        end
+        x[i] = nx
+        y[i] = y[i] + vy[i] * dt
+    end
+end)
+
+behaviour("empty", function(view, dt) end)
+)";
+
+double ToMicroseconds(Uint64 ticks) {
+    return ticks * 1000000.0 / SDL_GetPerformanceFrequency();
+}
+
+void MoveEntities(const std::vector<Entity>& entities, double deltaTime) {
+    for (auto entity : entities) {
+        auto& tf = entity.GetComponent<TransformComponent>();
+        auto& rb = entity.GetComponent<RigidBodyComponent>();
+        float x = tf.position.x + rb.velocity.x * deltaTime;
+        if (x < 0 || x > 1000) {
+            rb.velocity.x = -rb.velocity.x;
+        }
+        tf.position.x = x;
+        tf.position.y += rb.velocity.y * deltaTime;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    int numEntities = 10000;
+    int numTicks = 1000;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        if (arg == "--entities") {
+            numEntities = std::atoi(argv[i + 1]);
+        } else if (arg == "--ticks") {
+            numTicks = std::atoi(argv[i + 1]);
+        }
+    }
+    if (numEntities <= 0 || numTicks <= 0) {
+        std::fprintf(stderr, "Usage: scriptbench [--entities <count>] "
+                             "[--ticks <count>]\n");
+        return 1;
+    }
+
+    ScriptEngine scriptEngine;
+    if (!scriptEngine.Initialize() ||
+        !scriptEngine.RunString(BENCH_BEHAVIOURS)) {
+        return 1;
+    }
+    const int behaviours[] = {scriptEngine.GetBehaviour("bounce"),
+                              scriptEngine.GetBehaviour("empty")};
+
+    // The registry logs every entity and component at the debug level, keep
+    // it out of the report
+    Logger::SetLevel(LOG_INFO);
+    Registry registry;
+    registry.AddSystem<ScriptSystem>();
+    for (int i = 0; i < numEntities; i++) {
+        Entity entity = registry.CreateEntity();
+        entity.AddComponent<TransformComponent>(glm::vec2(i % 1000, i / 1000));
+        entity.AddComponent<RigidBodyComponent>(glm::vec2(50.0, 10.0));
+        entity.AddComponent<ScriptComponent>(behaviours[0]);
+    }
+    registry.Update();
+
+    auto&                     scriptSystem = registry.GetSystem<ScriptSystem>();
+    const std::vector<Entity> entities = scriptSystem.GetSystemEntities();
+    const double              per10k = 10000.0 / numEntities;
+
+    Uint64 start = SDL_GetPerformanceCounter();
+    for (int tick = 0; tick < numTicks; tick++) {
+        MoveEntities(entities, BENCH_DELTA_TIME);
+    }
+    double nativeUs =
+        ToMicroseconds(SDL_GetPerformanceCounter() - start) / numTicks;
+    std::printf("%-8s %10.1f us/tick per 10k entities\n", "c++",
+                nativeUs * per10k);
+
+    for (int behaviour : behaviours) {
+        for (auto entity : entities) {
+            entity.GetComponent<ScriptComponent>().behaviour = behaviour;
+        }
+
+        // The first tick sizes the view arrays
+        scriptSystem.Update(scriptEngine, BENCH_DELTA_TIME);
+        std::size_t memoryStart = scriptEngine.GetMemoryUsage();
+
+        start = SDL_GetPerformanceCounter();
+        for (int tick = 0; tick < numTicks; tick++) {
+            scriptSystem.Update(scriptEngine, BENCH_DELTA_TIME);
+        }
+        double scriptUs =
+            ToMicroseconds(SDL_GetPerformanceCounter() - start) / numTicks;
+        long long memoryGrowth =
+            static_cast<long long>(scriptEngine.GetMemoryUsage()) -
+            static_cast<long long>(memoryStart);
+
+        std::printf("%-8s %10.1f us/tick per 10k entities, %+lld bytes of Lua "
+                    "heap over %d ticks\n",
+                    scriptEngine.GetBehaviourName(behaviour).c_str(),
+                    scriptUs * per10k, memoryGrowth, numTicks);
+    }
+    return 0;
+}
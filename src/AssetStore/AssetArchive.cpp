@@ -0,0 +1,189 @@
+#include "./AssetArchive.h"
+#include "../Logger/Logger.h"
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+#ifdef ASSET_ARCHIVE_LZ4
+#include <lz4.h>
+#endif
+
+// Counts the pages of a mapping that are in memory, mincore() wants the start
+// address aligned to a page
+static std::size_t CountResidentBytes(const void* data, std::size_t size) {
+    const long  pageSize = sysconf(_SC_PAGESIZE);
+    std::size_t numPages = (size + pageSize - 1) / pageSize;
+
+    std::vector<unsigned char> residency(numPages);
+    if (mincore(const_cast<void*>(data), size, residency.data()) != 0) {
+        return 0;
+    }
+
+    std::size_t numResident = 0;
+    for (auto page : residency) {
+        numResident += page & 1;
+    }
+    return numResident * pageSize;
+}
+
+AssetArchive::~AssetArchive() { Close(); }
+
+bool AssetArchive::Open(const std::string& filePath) {
+    Close();
+
+    int file = open(filePath.c_str(), O_RDONLY);
+    if (file < 0) {
+        Logger::Err("Error opening asset archive " + filePath);
+        return false;
+    }
+
+    struct stat fileStat;
+    if (fstat(file, &fileStat) != 0 ||
+        fileStat.st_size < static_cast<off_t>(sizeof(AssetArchiveHeader))) {
+        Logger::Err("Asset archive " + filePath + " is too small");
+        close(file);
+        return false;
+    }
+
+    void* data = mmap(nullptr, fileStat.st_size, PROT_READ, MAP_PRIVATE, file,
+                      0);
+    close(file);
+    if (data == MAP_FAILED) {
+        Logger::Err("Error mapping asset archive " + filePath);
+        return false;
+    }
+    m_data = static_cast<const std::uint8_t*>(data);
+    m_size = fileStat.st_size;
+
+    const auto* header = reinterpret_cast<const AssetArchiveHeader*>(m_data);
+    const std::size_t tocEnd = sizeof(AssetArchiveHeader) +
+                               static_cast<std::size_t>(header->numEntries) *
+                                   sizeof(AssetArchiveEntry);
+    if (std::memcmp(header->magic, ASSET_ARCHIVE_MAGIC, 4) != 0 ||
+        header->version != ASSET_ARCHIVE_VERSION || tocEnd > m_size) {
+        Logger::Err("Asset archive " + filePath + " has an invalid header");
+        Close();
+        return false;
+    }
+
+    const auto* entries = reinterpret_cast<const AssetArchiveEntry*>(
+        m_data + sizeof(AssetArchiveHeader));
+    for (std::uint32_t i = 0; i < header->numEntries; i++) {
+        const AssetArchiveEntry& entry = entries[i];
+        const std::uint64_t      rawSize =
+            static_cast<std::uint64_t>(entry.width) * entry.height * 4;
+        bool isValid = entry.offset <= m_size &&
+                       entry.size <= m_size - entry.offset &&
+                       entry.path[ASSET_ARCHIVE_PATH_SIZE - 1] == '\0';
+        // The surfaces are made with int sizes whatever the compression
+        isValid = isValid && entry.width > 0 && entry.height > 0 &&
+                  entry.width <= ASSET_ARCHIVE_MAX_IMAGE_SIZE &&
+                  entry.height <= ASSET_ARCHIVE_MAX_IMAGE_SIZE &&
+                  entry.size <= static_cast<std::uint64_t>(INT_MAX);
+        if (entry.compression == ASSET_COMPRESSION_NONE) {
+            isValid = isValid && entry.size == rawSize;
+        }
+        if (!isValid) {
+            Logger::Err("Asset archive " + filePath + " has an invalid entry");
+            Close();
+            return false;
+        }
+        m_entries.emplace(entry.path, &entry);
+    }
+
+    Logger::Log("Asset archive " + filePath + " mapped with " +
+                std::to_string(m_entries.size()) + " images");
+    return true;
+}
+
+void AssetArchive::Close() {
+    if (m_data) {
+        munmap(const_cast<std::uint8_t*>(m_data), m_size);
+    }
+    m_data = nullptr;
+    m_size = 0;
+    m_entries.clear();
+}
+
+const AssetArchiveEntry*
+AssetArchive::Find(const std::string& assetPath) const {
+    auto entry = m_entries.find(NormalizePath(assetPath));
+    if (entry == m_entries.end()) {
+        return nullptr;
+    }
+    return entry->second;
+}
+
+SDL_Surface* AssetArchive::CreateSurface(const AssetArchiveEntry& entry) const {
+    const int width = entry.width;
+    const int height = entry.height;
+    void*     pixels = const_cast<std::uint8_t*>(m_data + entry.offset);
+
+    if (entry.compression == ASSET_COMPRESSION_NONE) {
+        return SDL_CreateRGBSurfaceWithFormatFrom(
+            pixels, width, height, 32, width * 4, SDL_PIXELFORMAT_RGBA32);
+    }
+
+#ifdef ASSET_ARCHIVE_LZ4
+    if (entry.compression == ASSET_COMPRESSION_LZ4) {
+        SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(
+            0, width, height, 32, SDL_PIXELFORMAT_RGBA32);
+        if (!surface) {
+            Logger::Err("Error creating surface for " +
+                        std::string(entry.path) + ": " + SDL_GetError());
+            return nullptr;
+        }
+        const int rawSize = width * height * 4;
+        const int numDecoded = LZ4_decompress_safe(
+            static_cast<const char*>(pixels),
+            static_cast<char*>(surface->pixels), static_cast<int>(entry.size),
+            rawSize);
+        if (numDecoded != rawSize) {
+            Logger::Err("Error decompressing " + std::string(entry.path));
+            SDL_FreeSurface(surface);
+            return nullptr;
+        }
+        return surface;
+    }
+#endif
+
+    Logger::Err("Unsupported compression for " + std::string(entry.path));
+    return nullptr;
+}
+
+std::size_t AssetArchive::GetResidentBytes() const {
+    if (!m_data) {
+        return 0;
+    }
+    return CountResidentBytes(m_data, m_size);
+}
+
+std::size_t AssetArchive::GetResidentBytes(const std::string& filePath) {
+    int file = open(filePath.c_str(), O_RDONLY);
+    if (file < 0) {
+        return 0;
+    }
+
+    struct stat fileStat;
+    std::size_t numBytes = 0;
+    if (fstat(file, &fileStat) == 0 && fileStat.st_size > 0) {
+        void* data = mmap(nullptr, fileStat.st_size, PROT_READ, MAP_SHARED,
+                          file, 0);
+        if (data != MAP_FAILED) {
+            numBytes = CountResidentBytes(data, fileStat.st_size);
+            munmap(data, fileStat.st_size);
+        }
+    }
+    close(file);
+    return numBytes;
+}
+
+std::string AssetArchive::NormalizePath(const std::string& path) {
+    std::string normalized = path;
+    while (normalized.compare(0, 2, "./") == 0) {
+        normalized.erase(0, 2);
+    }
+    return normalized;
+}
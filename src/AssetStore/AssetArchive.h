@@ -0,0 +1,100 @@
+#ifndef ASSET_ARCHIVE_H
+#define ASSET_ARCHIVE_H
+
+#include <SDL2/SDL.h>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+////////////////////////////////////////////////////////////////////////////////
+// Asset archive file format
+////////////////////////////////////////////////////////////////////////////////
+// A header, a table of contents and the pixels of every image, already decoded
+// to RGBA32. Each blob starts on its own page so the mapped pixels are aligned
+// and the page cache footprint can be measured per image. Written offline by
+// tools/AssetPacker.cpp.
+////////////////////////////////////////////////////////////////////////////////
+const char          ASSET_ARCHIVE_MAGIC[4] = {'G', 'P', 'A', 'K'};
+const std::uint32_t ASSET_ARCHIVE_VERSION = 1;
+const std::uint64_t ASSET_ARCHIVE_ALIGNMENT = 4096;
+const int           ASSET_ARCHIVE_PATH_SIZE = 112;
+// Largest width or height of an image, the pixels of the largest image still
+// fit the int sizes of SDL and LZ4
+const std::uint32_t ASSET_ARCHIVE_MAX_IMAGE_SIZE = 16384;
+
+enum AssetCompression : std::uint32_t {
+    ASSET_COMPRESSION_NONE = 0,
+    ASSET_COMPRESSION_LZ4 = 1
+};
+
+struct AssetArchiveHeader {
+    char          magic[4];
+    std::uint32_t version;
+    std::uint32_t numEntries;
+    std::uint32_t reserved;
+};
+
+struct AssetArchiveEntry {
+    // Path of the source image, without a leading "./"
+    char          path[ASSET_ARCHIVE_PATH_SIZE];
+    std::uint32_t width;
+    std::uint32_t height;
+    std::uint32_t compression;
+    std::uint32_t reserved;
+    // Where the blob is in the file and how many bytes it takes there
+    std::uint64_t offset;
+    std::uint64_t size;
+};
+
+static_assert(sizeof(AssetArchiveHeader) == 16, "Archive header layout");
+static_assert(sizeof(AssetArchiveEntry) == 144, "Archive entry layout");
+static_assert(static_cast<std::uint64_t>(ASSET_ARCHIVE_MAX_IMAGE_SIZE) *
+                      ASSET_ARCHIVE_MAX_IMAGE_SIZE * 4 <=
+                  static_cast<std::uint64_t>(INT_MAX),
+              "The pixels of the largest archive image fit an int");
+
+////////////////////////////////////////////////////////////////////////////////
+// AssetArchive
+////////////////////////////////////////////////////////////////////////////////
+// Read-only view of an archive mapped in memory. Lookups and surface creation
+// are safe from any thread once the archive is open.
+////////////////////////////////////////////////////////////////////////////////
+class AssetArchive {
+private:
+    const std::uint8_t* m_data = nullptr;
+    std::size_t         m_size = 0;
+
+    std::unordered_map<std::string, const AssetArchiveEntry*> m_entries;
+
+public:
+    AssetArchive() = default;
+    ~AssetArchive();
+
+    AssetArchive(const AssetArchive&) = delete;
+    AssetArchive& operator=(const AssetArchive&) = delete;
+
+    bool Open(const std::string& filePath);
+    void Close();
+    bool IsOpen() const { return m_data != nullptr; }
+
+    // Returns nullptr if the image is not in the archive
+    const AssetArchiveEntry* Find(const std::string& assetPath) const;
+
+    // Uncompressed images are wrapped without copying, the surface is only
+    // valid while the archive stays open. Compressed ones are decoded into a
+    // surface of their own.
+    SDL_Surface* CreateSurface(const AssetArchiveEntry& entry) const;
+
+    std::size_t GetMappedBytes() const { return m_size; }
+    std::size_t GetResidentBytes() const;
+
+    // Bytes of any file currently held in the page cache
+    static std::size_t GetResidentBytes(const std::string& filePath);
+
+    // Archive keys do not depend on how the path was spelled
+    static std::string NormalizePath(const std::string& path);
+};
+
+#endif // !ASSET_ARCHIVE_H
@@ -0,0 +1,29 @@
+#ifndef ASSET_HANDLE_H
+#define ASSET_HANDLE_H
+
+#include <cstdint>
+
+// Dense index into the AssetStore texture table. Handles are resolved once
+// when an entity is spawned so the render loop only does an array lookup.
+// Handle 0 is reserved so a default constructed sprite never points at a
+// real texture.
+using TextureHandle = std::uint32_t;
+
+const TextureHandle INVALID_TEXTURE_HANDLE = 0;
+
+// Fonts and sounds are indexed the same way
+using FontHandle = std::uint32_t;
+using SoundHandle = std::uint32_t;
+
+const FontHandle  INVALID_FONT_HANDLE = 0;
+const SoundHandle INVALID_SOUND_HANDLE = 0;
+
+// Asset kinds with their own memory accounting in the AssetStore
+enum AssetType {
+    ASSET_TYPE_TEXTURE,
+    ASSET_TYPE_FONT,
+    ASSET_TYPE_SOUND,
+    NUM_ASSET_TYPES
+};
+
+#endif // !ASSET_HANDLE_H
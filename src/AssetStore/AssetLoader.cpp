@@ -0,0 +1,114 @@
+#include "./AssetLoader.h"
+#include "../Logger/Logger.h"
+#include "../Profiler/Profiler.h"
+#include <SDL2/SDL_image.h>
+#include <algorithm>
+
+AssetLoader::AssetLoader(const AssetArchive& archive, int numThreads)
+    : m_archive(archive) {
+    if (numThreads <= 0) {
+        numThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for (int i = 0; i < numThreads; i++) {
+        m_workers.emplace_back(&AssetLoader::WorkerLoop, this);
+    }
+}
+
+AssetLoader::~AssetLoader() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_isStopping = true;
+    }
+    m_jobAvailable.notify_all();
+    for (auto& worker : m_workers) {
+        worker.join();
+    }
+    for (auto& result : m_results) {
+        if (result.surface) {
+            SDL_FreeSurface(result.surface);
+        }
+    }
+}
+
+SDL_Surface* AssetLoader::Decode(const std::string& filePath) const {
+    PROFILE_ZONE("AssetLoader::Decode");
+    if (m_archive.IsOpen()) {
+        const AssetArchiveEntry* entry = m_archive.Find(filePath);
+        if (entry) {
+            return m_archive.CreateSurface(*entry);
+        }
+    }
+
+    SDL_Surface* surface = IMG_Load(filePath.c_str());
+    if (!surface) {
+        Logger::Err("Error loading image " + filePath + ": " +
+                    std::string(IMG_GetError()));
+        return nullptr;
+    }
+
+    // Every texture is uploaded as RGBA, convert once here
+    SDL_Surface* converted =
+        SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_RGBA32, 0);
+    SDL_FreeSurface(surface);
+    if (!converted) {
+        Logger::Err("Error converting image " + filePath + ": " +
+                    std::string(SDL_GetError()));
+    }
+    return converted;
+}
+
+void AssetLoader::WorkerLoop() {
+    PROFILE_THREAD("asset loader");
+    while (true) {
+        DecodeJob job;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_jobAvailable.wait(
+                lock, [this] { return m_isStopping || !m_jobs.empty(); });
+            if (m_isStopping) {
+                return;
+            }
+            job = std::move(m_jobs.front());
+            m_jobs.pop_front();
+        }
+
+        SDL_Surface* surface = Decode(job.filePath);
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_results.push_back({job.handle, surface});
+            m_numInFlight--;
+        }
+        m_jobDone.notify_all();
+    }
+}
+
+void AssetLoader::Enqueue(TextureHandle handle, const std::string& filePath) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_jobs.push_back({handle, filePath});
+        m_numInFlight++;
+    }
+    m_jobAvailable.notify_one();
+}
+
+void AssetLoader::AddResult(TextureHandle handle, SDL_Surface* surface) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_results.push_back({handle, surface});
+}
+
+void AssetLoader::TakeResults(std::vector<DecodedImage>& results) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    results.insert(results.end(), m_results.begin(), m_results.end());
+    m_results.clear();
+}
+
+void AssetLoader::WaitForAll() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_jobDone.wait(lock, [this] { return m_numInFlight == 0; });
+}
+
+int AssetLoader::GetNumInFlight() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_numInFlight;
+}
@@ -0,0 +1,70 @@
+#ifndef ASSET_LOADER_H
+#define ASSET_LOADER_H
+
+#include "./AssetArchive.h"
+#include "./AssetHandle.h"
+#include <SDL2/SDL.h>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// An image decoded by the loader, surface is nullptr if loading failed
+struct DecodedImage {
+    TextureHandle handle;
+    SDL_Surface*  surface;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// AssetLoader
+////////////////////////////////////////////////////////////////////////////////
+// Pool of worker threads decoding image files into RGBA surfaces. Decoding is
+// pure CPU work, creating the textures is left to the render thread. Images
+// found in the asset archive skip the PNG decode.
+////////////////////////////////////////////////////////////////////////////////
+class AssetLoader {
+private:
+    struct DecodeJob {
+        TextureHandle handle;
+        std::string   filePath;
+    };
+
+    const AssetArchive& m_archive;
+
+    std::vector<std::thread>  m_workers;
+    std::deque<DecodeJob>     m_jobs;
+    std::vector<DecodedImage> m_results;
+    int                       m_numInFlight = 0;
+    bool                      m_isStopping = false;
+
+    mutable std::mutex      m_mutex;
+    std::condition_variable m_jobAvailable;
+    std::condition_variable m_jobDone;
+
+    void WorkerLoop();
+
+public:
+    // 0 threads starts one worker per hardware core
+    AssetLoader(const AssetArchive& archive, int numThreads = 0);
+    ~AssetLoader();
+
+    // Loads the image on the calling thread, from the archive if it is there
+    SDL_Surface* Decode(const std::string& filePath) const;
+
+    void Enqueue(TextureHandle handle, const std::string& filePath);
+
+    // Hands over an image made on the calling thread as if it was decoded
+    void AddResult(TextureHandle handle, SDL_Surface* surface);
+
+    // Appends the images decoded so far to results
+    void TakeResults(std::vector<DecodedImage>& results);
+
+    // Blocks until every enqueued image is decoded
+    void WaitForAll();
+
+    int GetNumInFlight() const;
+};
+
+#endif // !ASSET_LOADER_H
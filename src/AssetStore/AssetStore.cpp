@@ -1,33 +1,749 @@
 #include "./AssetStore.h"
 #include "../Logger/Logger.h"
-#include <SDL2/SDL_image.h>
+#include "../Profiler/Profiler.h"
+#include "./AtlasPacker.h"
+#include <algorithm>
 
-AssetStore::AssetStore() { Logger::Log("AssetStore constructor called!"); }
+AssetStore::AssetStore() : m_loader(m_archive) {
+    // Reserve slot 0 of every table for the invalid handles
+    m_textures.push_back({nullptr, {0, 0, 0, 0}});
+    m_textureRecords.push_back(
+        {"", "", TEXTURE_FAILED, 0, 0, -1, INVALID_FONT_HANDLE});
+    m_pendingSurfaces.push_back(nullptr);
+    m_fonts.push_back({"", "", 0, nullptr, 0, 0, 0});
+    m_glyphAtlases.emplace_back();
+    m_sounds.push_back({"", "", nullptr, 0, 0, 0});
+    Logger::Log("AssetStore constructor called!");
+}
 
 AssetStore::~AssetStore() {
-    ClearAssets();
+    for (auto& image : m_decodedImages) {
+        if (image.surface) {
+            SDL_FreeSurface(image.surface);
+        }
+    }
+    for (auto surface : m_pendingSurfaces) {
+        if (surface) {
+            SDL_FreeSurface(surface);
+        }
+    }
+    for (auto& font : m_fonts) {
+        if (font.font) {
+            TTF_CloseFont(font.font);
+        }
+    }
+    for (auto& sound : m_sounds) {
+        if (sound.chunk) {
+            Mix_FreeChunk(sound.chunk);
+        }
+    }
     Logger::Log("AssetStore destructor called!");
 }
 
-void AssetStore::ClearAssets() {
-    for (auto texture : m_textures) {
-        SDL_DestroyTexture(texture.second);
+void AssetStore::ClearAssets(RenderBackend& renderer) {
+    // Nothing may still be decoding into the tables cleared below
+    m_loader.WaitForAll();
+    m_loader.TakeResults(m_decodedImages);
+    for (auto& image : m_decodedImages) {
+        if (image.surface) {
+            SDL_FreeSurface(image.surface);
+        }
+    }
+    m_decodedImages.clear();
+
+    for (auto& upload : m_uploads) {
+        if (upload.second.texture != m_placeholderTexture) {
+            renderer.DestroyTexture(upload.second.texture);
+        }
+    }
+    for (auto& evicted : m_evictedTextures) {
+        renderer.DestroyTexture(evicted.first);
+    }
+    for (auto& owned : m_ownedTextures) {
+        if (owned.texture) {
+            renderer.DestroyTexture(owned.texture);
+        }
+    }
+    if (m_placeholderTexture) {
+        renderer.DestroyTexture(m_placeholderTexture);
+    }
+    m_uploads.clear();
+    m_evictedTextures.clear();
+    m_ownedTextures.clear();
+    m_placeholderTexture = nullptr;
+    m_hasPlaceholder = false;
+
+    for (auto surface : m_pendingSurfaces) {
+        if (surface) {
+            SDL_FreeSurface(surface);
+        }
+    }
+    for (auto& font : m_fonts) {
+        if (font.font) {
+            TTF_CloseFont(font.font);
+        }
+    }
+    for (auto& sound : m_sounds) {
+        if (sound.chunk) {
+            Mix_FreeChunk(sound.chunk);
+        }
+    }
+
+    m_textures.resize(1);
+    m_textureRecords.resize(1);
+    m_pendingSurfaces.resize(1);
+    m_textureHandles.clear();
+    m_fonts.resize(1);
+    m_glyphAtlases.resize(1);
+    m_fontHandles.clear();
+    m_sounds.resize(1);
+    m_soundHandles.clear();
+    for (auto& usage : m_memoryUsage) {
+        usage = 0;
+    }
+    m_archive.Close();
+}
+
+bool AssetStore::OpenArchive(const std::string& filePath) {
+    // Surfaces may still point into the archive already open
+    if (m_archive.IsOpen()) {
+        Logger::Err("An asset archive is already open");
+        return false;
     }
-    m_textures.clear();
+    return m_archive.Open(filePath);
 }
 
-void AssetStore::AddTexture(SDL_Renderer* renderer, const std::string& assetId,
-                            const std::string& filePath) {
-    SDL_Surface* surface = IMG_Load(filePath.c_str());
-    SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
-    SDL_FreeSurface(surface);
+void AssetStore::SetMemoryBudget(std::size_t numBytes) {
+    m_memoryBudget = numBytes;
+}
+
+void AssetStore::Update() {
+    PROFILE_ZONE("AssetStore::Update");
+    m_frame++;
+    ApplyUploads();
 
-    // Add the texture to the map
-    m_textures.emplace(assetId, texture);
+    if (m_memoryBudget == 0) {
+        return;
+    }
+    std::size_t usage = 0;
+    for (auto typeUsage : m_memoryUsage) {
+        usage += typeUsage;
+    }
+    while (usage > m_memoryBudget && EvictLeastRecentlyUsed()) {
+        usage = 0;
+        for (auto typeUsage : m_memoryUsage) {
+            usage += typeUsage;
+        }
+    }
+}
+
+bool AssetStore::EvictLeastRecentlyUsed() {
+    // Assets used during the last tick may be in the snapshot being drawn or
+    // about to be used again, they are never candidates
+    const Uint64 maxLastUsed = m_frame > 1 ? m_frame - 2 : 0;
+
+    AssetType type = NUM_ASSET_TYPES;
+    size_t    index = 0;
+    Uint64    oldest = 0;
+
+    for (size_t owner = 0; owner < m_ownedTextures.size(); owner++) {
+        const OwnedTexture& owned = m_ownedTextures[owner];
+        if (!owned.texture || owned.handles.empty()) {
+            continue;
+        }
+        bool   isReferenced = false;
+        Uint64 lastUsed = 0;
+        for (auto handle : owned.handles) {
+            isReferenced |= m_textureRecords[handle].refCount > 0;
+            lastUsed = std::max(lastUsed, m_textureRecords[handle].lastUsed);
+        }
+        if (!isReferenced && lastUsed <= maxLastUsed &&
+            (type == NUM_ASSET_TYPES || lastUsed < oldest)) {
+            type = ASSET_TYPE_TEXTURE;
+            index = owner;
+            oldest = lastUsed;
+        }
+    }
+    for (size_t handle = 1; handle < m_fonts.size(); handle++) {
+        const FontRecord& font = m_fonts[handle];
+        if (font.font && font.refCount == 0 && font.lastUsed <= maxLastUsed &&
+            (type == NUM_ASSET_TYPES || font.lastUsed < oldest)) {
+            type = ASSET_TYPE_FONT;
+            index = handle;
+            oldest = font.lastUsed;
+        }
+    }
+    for (size_t handle = 1; handle < m_sounds.size(); handle++) {
+        const SoundRecord& sound = m_sounds[handle];
+        if (sound.chunk && sound.refCount == 0 &&
+            sound.lastUsed <= maxLastUsed &&
+            (type == NUM_ASSET_TYPES || sound.lastUsed < oldest)) {
+            type = ASSET_TYPE_SOUND;
+            index = handle;
+            oldest = sound.lastUsed;
+        }
+    }
+
+    switch (type) {
+    case ASSET_TYPE_TEXTURE:
+        EvictTexture(index);
+        return true;
+    case ASSET_TYPE_FONT:
+        EvictFont(index);
+        return true;
+    case ASSET_TYPE_SOUND:
+        EvictSound(index);
+        return true;
+    default:
+        return false;
+    }
+}
+
+void AssetStore::EvictTexture(int owner) {
+    OwnedTexture& owned = m_ownedTextures[owner];
+    for (auto handle : owned.handles) {
+        m_textures[handle].texture = nullptr;
+        m_textureRecords[handle].state = TEXTURE_EVICTED;
+        m_textureRecords[handle].owner = -1;
+    }
+
+    Logger::Log("Texture " + std::to_string(owner) + " evicted with " +
+                std::to_string(owned.handles.size()) + " images");
+
+    // The render thread may still be drawing an older snapshot with it
+    {
+        std::lock_guard<std::mutex> lock(m_uploadsMutex);
+        m_evictedTextures.push_back({owned.texture, m_frame});
+    }
+    m_memoryUsage[ASSET_TYPE_TEXTURE] -= owned.numBytes;
+    owned = {nullptr, 0, {}};
+}
+
+void AssetStore::EvictFont(FontHandle handle) {
+    FontRecord& record = m_fonts[handle];
+    TTF_CloseFont(record.font);
+    record.font = nullptr;
+    m_memoryUsage[ASSET_TYPE_FONT] -= record.numBytes;
+    Logger::Log("Font evicted with id " + record.id);
+}
+
+void AssetStore::EvictSound(SoundHandle handle) {
+    SoundRecord& record = m_sounds[handle];
+    Mix_FreeChunk(record.chunk);
+    record.chunk = nullptr;
+    m_memoryUsage[ASSET_TYPE_SOUND] -= record.numBytes;
+    Logger::Log("Sound evicted with id " + record.id);
+}
+
+TextureHandle AssetStore::RegisterTexture(const std::string& assetId,
+                                          const std::string& filePath,
+                                          SDL_Surface*       surface,
+                                          TextureState       state) {
+    // Failed loads keep the handle valid, it draws the placeholder
+    SDL_Rect rect = {0, 0, PLACEHOLDER_TEXTURE_SIZE, PLACEHOLDER_TEXTURE_SIZE};
+    if (surface) {
+        rect = {0, 0, surface->w, surface->h};
+    }
+
+    // Add the texture to the table, its index is the handle
+    TextureHandle handle = static_cast<TextureHandle>(m_textures.size());
+    m_textures.push_back({m_placeholderTexture, rect});
+    m_textureRecords.push_back(
+        {assetId, filePath, state, 1, m_frame, -1, INVALID_FONT_HANDLE});
+    m_pendingSurfaces.push_back(surface);
+    m_textureHandles.emplace(assetId, handle);
+    return handle;
+}
+
+int AssetStore::AddOwnedTexture(SDL_Texture* texture, int width, int height) {
+    const std::size_t numBytes = static_cast<std::size_t>(width) * height * 4;
+    m_memoryUsage[ASSET_TYPE_TEXTURE] += numBytes;
+
+    for (size_t owner = 0; owner < m_ownedTextures.size(); owner++) {
+        if (!m_ownedTextures[owner].texture) {
+            m_ownedTextures[owner] = {texture, numBytes, {}};
+            return owner;
+        }
+    }
+    m_ownedTextures.push_back({texture, numBytes, {}});
+    return m_ownedTextures.size() - 1;
+}
+
+TextureHandle AssetStore::AddTexture(const std::string& assetId,
+                                     const std::string& filePath) {
+    PROFILE_ZONE("AssetStore::AddTexture");
+    auto existing = m_textureHandles.find(assetId);
+    if (existing != m_textureHandles.end()) {
+        AcquireTexture(existing->second);
+        return existing->second;
+    }
+
+    if (m_isHeadless) {
+        return RegisterTexture(assetId, filePath, nullptr, TEXTURE_FAILED);
+    }
+
+    SDL_Surface*  surface = m_loader.Decode(filePath);
+    TextureHandle handle = RegisterTexture(
+        assetId, filePath, surface, surface ? TEXTURE_PENDING : TEXTURE_FAILED);
 
     Logger::Log("Texture added to the AssetStore with id " + assetId);
+    return handle;
 }
 
-SDL_Texture* AssetStore::GetTexture(const std::string& assetId) {
-    return m_textures[assetId];
+TextureHandle AssetStore::AddTextureAsync(const std::string& assetId,
+                                          const std::string& filePath) {
+    PROFILE_ZONE("AssetStore::AddTextureAsync");
+    auto existing = m_textureHandles.find(assetId);
+    if (existing != m_textureHandles.end()) {
+        AcquireTexture(existing->second);
+        return existing->second;
+    }
+
+    if (m_isHeadless) {
+        return RegisterTexture(assetId, filePath, nullptr, TEXTURE_FAILED);
+    }
+
+    TextureHandle handle =
+        RegisterTexture(assetId, filePath, nullptr, TEXTURE_LOADING);
+    m_loader.Enqueue(handle, filePath);
+
+    Logger::Log("Texture queued for loading with id " + assetId);
+    return handle;
+}
+
+void AssetStore::AcquireTexture(TextureHandle handle) {
+    TextureRecord& record = m_textureRecords[handle];
+    record.refCount++;
+    record.lastUsed = m_frame;
+    RequestTexture(handle);
+}
+
+void AssetStore::ReleaseTexture(TextureHandle handle) {
+    TextureRecord& record = m_textureRecords[handle];
+    if (record.refCount == 0) {
+        Logger::Err("Texture with id " + record.id + " released too often");
+        return;
+    }
+    record.refCount--;
+    record.lastUsed = m_frame;
+}
+
+void AssetStore::RequestTexture(TextureHandle handle) {
+    TextureRecord& record = m_textureRecords[handle];
+    if (record.state != TEXTURE_EVICTED) {
+        return;
+    }
+    record.state = TEXTURE_LOADING;
+    m_textures[handle] = {
+        m_placeholderTexture,
+        {0, 0, PLACEHOLDER_TEXTURE_SIZE, PLACEHOLDER_TEXTURE_SIZE}};
+
+    // A glyph sheet has no file, it is rasterized again from its font and
+    // uploaded like a decoded image. A sheet that fails draws the placeholder.
+    if (record.font != INVALID_FONT_HANDLE) {
+        TTF_Font*    font = GetFont(record.font);
+        SDL_Surface* sheet =
+            font ? RasterizeGlyphs(font, m_glyphAtlases[record.font]) : nullptr;
+        m_loader.AddResult(handle, sheet);
+        return;
+    }
+    m_loader.Enqueue(handle, record.filePath);
+}
+
+void AssetStore::CreatePlaceholderTexture(RenderBackend& renderer) {
+    SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(
+        0, PLACEHOLDER_TEXTURE_SIZE, PLACEHOLDER_TEXTURE_SIZE, 32,
+        SDL_PIXELFORMAT_RGBA32);
+    Uint32 magenta = SDL_MapRGBA(surface->format, 255, 0, 255, 255);
+    Uint32 black = SDL_MapRGBA(surface->format, 0, 0, 0, 255);
+    for (int y = 0; y < surface->h; y++) {
+        Uint32* row = reinterpret_cast<Uint32*>(
+            static_cast<Uint8*>(surface->pixels) + y * surface->pitch);
+        for (int x = 0; x < surface->w; x++) {
+            bool isOdd =
+                ((x / PLACEHOLDER_CELL_SIZE) + (y / PLACEHOLDER_CELL_SIZE)) % 2;
+            row[x] = isOdd ? black : magenta;
+        }
+    }
+
+    m_placeholderTexture = renderer.CreateTexture(surface);
+    SDL_FreeSurface(surface);
+}
+
+void AssetStore::BuildTextureAtlas(RenderBackend& renderer) {
+    PROFILE_ZONE("AssetStore::BuildTextureAtlas");
+    if (!m_placeholderTexture) {
+        CreatePlaceholderTexture(renderer);
+    }
+
+    // Every image is decoding in parallel on the loader, only the slowest one
+    // is waited for here
+    m_loader.WaitForAll();
+    m_loader.TakeResults(m_decodedImages);
+    ApplyUploads();
+    for (auto& image : m_decodedImages) {
+        m_pendingSurfaces[image.handle] = image.surface;
+        m_textureRecords[image.handle].state =
+            image.surface ? TEXTURE_PENDING : TEXTURE_FAILED;
+        if (image.surface) {
+            m_textures[image.handle].rect = {0, 0, image.surface->w,
+                                             image.surface->h};
+        }
+    }
+    m_decodedImages.clear();
+
+    std::vector<TextureHandle> pending;
+    for (TextureHandle handle = 0; handle < m_pendingSurfaces.size();
+         handle++) {
+        if (m_pendingSurfaces[handle]) {
+            pending.push_back(handle);
+        }
+    }
+    if (pending.empty()) {
+        return;
+    }
+
+    int atlasSize = TEXTURE_ATLAS_SIZE;
+    if (renderer.GetMaxTextureSize() > 0) {
+        atlasSize = std::min(atlasSize, renderer.GetMaxTextureSize());
+    }
+
+    // Skyline packing works best placing the tallest images first
+    std::sort(pending.begin(), pending.end(),
+              [this](TextureHandle a, TextureHandle b) {
+                  return m_pendingSurfaces[a]->h > m_pendingSurfaces[b]->h;
+              });
+
+    std::vector<AtlasPacker>                pages;
+    std::vector<std::vector<TextureHandle>> pageHandles;
+    std::vector<TextureHandle>              standalone;
+
+    for (auto handle : pending) {
+        const SDL_Surface* surface = m_pendingSurfaces[handle];
+        const int          width = surface->w + TEXTURE_ATLAS_PADDING;
+        const int          height = surface->h + TEXTURE_ATLAS_PADDING;
+        // A glyph sheet lives as long as its font, on a page of its own it
+        // does not keep the sprites packed with it from being evicted
+        if (width > atlasSize || height > atlasSize ||
+            m_textureRecords[handle].font != INVALID_FONT_HANDLE) {
+            standalone.push_back(handle);
+            continue;
+        }
+
+        SDL_Rect rect;
+        size_t   page = 0;
+        while (page < pages.size() &&
+               !pages[page].Insert(width, height, rect)) {
+            page++;
+        }
+        if (page == pages.size()) {
+            pages.emplace_back(atlasSize, atlasSize);
+            pageHandles.emplace_back();
+            pages.back().Insert(width, height, rect);
+        }
+
+        m_textures[handle].rect = {rect.x, rect.y, surface->w, surface->h};
+        pageHandles[page].push_back(handle);
+    }
+
+    // Copy the images into their page and upload it, pages are cropped to the
+    // area actually used
+    for (size_t page = 0; page < pages.size(); page++) {
+        SDL_Surface* atlas = SDL_CreateRGBSurfaceWithFormat(
+            0, pages[page].GetUsedWidth(), pages[page].GetUsedHeight(), 32,
+            SDL_PIXELFORMAT_RGBA32);
+
+        for (auto handle : pageHandles[page]) {
+            SDL_Surface* surface = m_pendingSurfaces[handle];
+            SDL_Rect     dstRect = m_textures[handle].rect;
+            SDL_SetSurfaceBlendMode(surface, SDL_BLENDMODE_NONE);
+            SDL_BlitSurface(surface, NULL, atlas, &dstRect);
+        }
+
+        SDL_Texture* texture = renderer.CreateTexture(atlas);
+        int owner = AddOwnedTexture(texture, atlas->w, atlas->h);
+        SDL_FreeSurface(atlas);
+
+        m_ownedTextures[owner].handles = pageHandles[page];
+        for (auto handle : pageHandles[page]) {
+            m_textures[handle].texture = texture;
+            m_textureRecords[handle].state = TEXTURE_RESIDENT;
+            m_textureRecords[handle].owner = owner;
+        }
+        Logger::Log("Texture atlas page " + std::to_string(page) + " packed " +
+                    std::to_string(pageHandles[page].size()) + " textures");
+    }
+
+    // Glyph sheets and images bigger than a page keep their own texture
+    for (auto handle : standalone) {
+        SDL_Surface* surface = m_pendingSurfaces[handle];
+        SDL_Texture* texture = renderer.CreateTexture(surface);
+        int          owner = AddOwnedTexture(texture, surface->w, surface->h);
+        m_ownedTextures[owner].handles = {handle};
+        m_textures[handle].texture = texture;
+        m_textureRecords[handle].state = TEXTURE_RESIDENT;
+        m_textureRecords[handle].owner = owner;
+    }
+
+    for (auto handle : pending) {
+        SDL_FreeSurface(m_pendingSurfaces[handle]);
+        m_pendingSurfaces[handle] = nullptr;
+    }
+}
+
+void AssetStore::UploadTextures(RenderBackend& renderer, double budgetMs) {
+    PROFILE_ZONE("AssetStore::UploadTextures");
+    if (!m_placeholderTexture) {
+        CreatePlaceholderTexture(renderer);
+    }
+
+    m_loader.TakeResults(m_decodedImages);
+    if (m_decodedImages.empty()) {
+        return;
+    }
+
+    const Uint64 start = SDL_GetPerformanceCounter();
+    const Uint64 budget = static_cast<Uint64>(
+        budgetMs * SDL_GetPerformanceFrequency() / 1000.0);
+
+    // At least one image goes up every frame so a big texture can not stall
+    // the queue forever
+    std::vector<std::pair<TextureHandle, TextureRegion>> uploads;
+    size_t numUploaded = 0;
+    while (numUploaded < m_decodedImages.size()) {
+        if (numUploaded > 0 && SDL_GetPerformanceCounter() - start >= budget) {
+            break;
+        }
+
+        DecodedImage& image = m_decodedImages[numUploaded++];
+        TextureRegion region = {
+            m_placeholderTexture,
+            {0, 0, PLACEHOLDER_TEXTURE_SIZE, PLACEHOLDER_TEXTURE_SIZE}};
+        if (image.surface) {
+            SDL_Texture* texture = renderer.CreateTexture(image.surface);
+            region = {texture, {0, 0, image.surface->w, image.surface->h}};
+            SDL_FreeSurface(image.surface);
+        }
+        uploads.push_back({image.handle, region});
+    }
+    m_decodedImages.erase(m_decodedImages.begin(),
+                          m_decodedImages.begin() + numUploaded);
+
+    std::lock_guard<std::mutex> lock(m_uploadsMutex);
+    m_uploads.insert(m_uploads.end(), uploads.begin(), uploads.end());
+}
+
+void AssetStore::DestroyEvictedTextures(RenderBackend& renderer,
+                                        Uint64         frame) {
+    std::lock_guard<std::mutex> lock(m_uploadsMutex);
+    auto                        destroyed = std::remove_if(
+        m_evictedTextures.begin(), m_evictedTextures.end(),
+        [&renderer, frame](const std::pair<SDL_Texture*, Uint64>& evicted) {
+            if (evicted.second > frame) {
+                return false;
+            }
+            renderer.DestroyTexture(evicted.first);
+            return true;
+        });
+    m_evictedTextures.erase(destroyed, m_evictedTextures.end());
+}
+
+void AssetStore::ApplyUploads() {
+    std::vector<std::pair<TextureHandle, TextureRegion>> uploads;
+    {
+        std::lock_guard<std::mutex> lock(m_uploadsMutex);
+        uploads.swap(m_uploads);
+    }
+
+    for (auto& upload : uploads) {
+        const TextureHandle  handle = upload.first;
+        const TextureRegion& region = upload.second;
+        TextureRecord&       record = m_textureRecords[handle];
+        m_textures[handle] = region;
+
+        if (region.texture == m_placeholderTexture) {
+            record.state = TEXTURE_FAILED;
+            continue;
+        }
+        int owner = AddOwnedTexture(region.texture, region.rect.w,
+                                    region.rect.h);
+        m_ownedTextures[owner].handles = {handle};
+        record.state = TEXTURE_RESIDENT;
+        record.owner = owner;
+    }
+
+    // Handles added before the render thread made the placeholder
+    if (!m_hasPlaceholder && m_placeholderTexture) {
+        m_hasPlaceholder = true;
+        for (size_t handle = 1; handle < m_textures.size(); handle++) {
+            if (!m_textures[handle].texture &&
+                m_textureRecords[handle].state != TEXTURE_EVICTED) {
+                m_textures[handle].texture = m_placeholderTexture;
+            }
+        }
+    }
+}
+
+TextureHandle AssetStore::GetTextureHandle(const std::string& assetId) const {
+    auto handle = m_textureHandles.find(assetId);
+    if (handle == m_textureHandles.end()) {
+        Logger::Err("Texture with id " + assetId + " was not found");
+        return INVALID_TEXTURE_HANDLE;
+    }
+    return handle->second;
+}
+
+const std::string& AssetStore::GetTextureId(TextureHandle handle) const {
+    return m_textureRecords[handle].id;
+}
+
+FontHandle AssetStore::AddFont(const std::string& assetId,
+                               const std::string& filePath, int fontSize) {
+    PROFILE_ZONE("AssetStore::AddFont");
+    auto existing = m_fontHandles.find(assetId);
+    if (existing != m_fontHandles.end()) {
+        AcquireFont(existing->second);
+        return existing->second;
+    }
+
+    FontHandle handle = static_cast<FontHandle>(m_fonts.size());
+    m_fonts.push_back({assetId, filePath, fontSize, nullptr, 0, 1, m_frame});
+    m_glyphAtlases.emplace_back();
+    m_fontHandles.emplace(assetId, handle);
+
+    // The glyph sheet is registered with the reference the font is added
+    // with, and follows the font's references from then on
+    GlyphAtlas& atlas = m_glyphAtlases.back();
+    if (!m_isHeadless && LoadFont(m_fonts.back())) {
+        SDL_Surface* sheet = RasterizeGlyphs(m_fonts.back().font, atlas);
+        atlas.texture = RegisterTexture(assetId + "-glyphs", "", nullptr,
+                                        TEXTURE_LOADING);
+        m_textureRecords[atlas.texture].font = handle;
+        m_loader.AddResult(atlas.texture, sheet);
+    }
+
+    Logger::Log("Font added to the AssetStore with id " + assetId);
+    return handle;
+}
+
+bool AssetStore::LoadFont(FontRecord& record) {
+    record.font = TTF_OpenFont(record.filePath.c_str(), record.fontSize);
+    if (!record.font) {
+        Logger::Err("Error loading font " + record.filePath + ": " +
+                    std::string(TTF_GetError()));
+        return false;
+    }
+
+    // The whole file is kept in memory by FreeType, count that
+    SDL_RWops* file = SDL_RWFromFile(record.filePath.c_str(), "rb");
+    record.numBytes = file ? SDL_RWsize(file) : 0;
+    if (file) {
+        SDL_RWclose(file);
+    }
+    m_memoryUsage[ASSET_TYPE_FONT] += record.numBytes;
+    return true;
+}
+
+void AssetStore::AcquireFont(FontHandle handle) {
+    m_fonts[handle].refCount++;
+    m_fonts[handle].lastUsed = m_frame;
+    if (m_glyphAtlases[handle].texture != INVALID_TEXTURE_HANDLE) {
+        AcquireTexture(m_glyphAtlases[handle].texture);
+    }
+}
+
+void AssetStore::ReleaseFont(FontHandle handle) {
+    FontRecord& record = m_fonts[handle];
+    if (record.refCount == 0) {
+        Logger::Err("Font with id " + record.id + " released too often");
+        return;
+    }
+    record.refCount--;
+    record.lastUsed = m_frame;
+    if (m_glyphAtlases[handle].texture != INVALID_TEXTURE_HANDLE) {
+        ReleaseTexture(m_glyphAtlases[handle].texture);
+    }
+}
+
+FontHandle AssetStore::GetFontHandle(const std::string& assetId) const {
+    auto handle = m_fontHandles.find(assetId);
+    if (handle == m_fontHandles.end()) {
+        Logger::Err("Font with id " + assetId + " was not found");
+        return INVALID_FONT_HANDLE;
+    }
+    return handle->second;
+}
+
+TTF_Font* AssetStore::GetFont(FontHandle handle) {
+    FontRecord& record = m_fonts[handle];
+    if (!record.font && handle != INVALID_FONT_HANDLE && !m_isHeadless) {
+        LoadFont(record);
+    }
+    record.lastUsed = m_frame;
+    return record.font;
+}
+
+SoundHandle AssetStore::AddSound(const std::string& assetId,
+                                 const std::string& filePath) {
+    PROFILE_ZONE("AssetStore::AddSound");
+    auto existing = m_soundHandles.find(assetId);
+    if (existing != m_soundHandles.end()) {
+        AcquireSound(existing->second);
+        return existing->second;
+    }
+
+    SoundHandle handle = static_cast<SoundHandle>(m_sounds.size());
+    m_sounds.push_back({assetId, filePath, nullptr, 0, 1, m_frame});
+    m_soundHandles.emplace(assetId, handle);
+    if (!m_isHeadless) {
+        LoadSound(m_sounds.back());
+    }
+
+    Logger::Log("Sound added to the AssetStore with id " + assetId);
+    return handle;
+}
+
+bool AssetStore::LoadSound(SoundRecord& record) {
+    record.chunk = Mix_LoadWAV(record.filePath.c_str());
+    if (!record.chunk) {
+        Logger::Err("Error loading sound " + record.filePath + ": " +
+                    std::string(Mix_GetError()));
+        return false;
+    }
+    record.numBytes = record.chunk->alen;
+    m_memoryUsage[ASSET_TYPE_SOUND] += record.numBytes;
+    return true;
+}
+
+void AssetStore::AcquireSound(SoundHandle handle) {
+    m_sounds[handle].refCount++;
+    m_sounds[handle].lastUsed = m_frame;
+}
+
+void AssetStore::ReleaseSound(SoundHandle handle) {
+    SoundRecord& record = m_sounds[handle];
+    if (record.refCount == 0) {
+        Logger::Err("Sound with id " + record.id + " released too often");
+        return;
+    }
+    record.refCount--;
+    record.lastUsed = m_frame;
+}
+
+SoundHandle AssetStore::GetSoundHandle(const std::string& assetId) const {
+    auto handle = m_soundHandles.find(assetId);
+    if (handle == m_soundHandles.end()) {
+        Logger::Err("Sound with id " + assetId + " was not found");
+        return INVALID_SOUND_HANDLE;
+    }
+    return handle->second;
+}
+
+Mix_Chunk* AssetStore::GetSound(SoundHandle handle) {
+    SoundRecord& record = m_sounds[handle];
+    if (!record.chunk && handle != INVALID_SOUND_HANDLE && !m_isHeadless) {
+        LoadSound(record);
+    }
+    record.lastUsed = m_frame;
+    return record.chunk;
 }
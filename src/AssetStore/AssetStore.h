@@ -1,24 +1,278 @@
 #ifndef ASSET_STORE_H
 #define ASSET_STORE_H
 
+#include "../Renderer/RenderBackend.h"
+#include "./AssetArchive.h"
+#include "./AssetHandle.h"
+#include "./AssetLoader.h"
+#include "./GlyphAtlas.h"
 #include <SDL2/SDL.h>
-#include <map>
+#include <SDL2/SDL_mixer.h>
+#include <SDL2/SDL_ttf.h>
+#include <atomic>
+#include <cstddef>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
+const int TEXTURE_ATLAS_SIZE = 2048;
+const int TEXTURE_ATLAS_PADDING = 1;
+
+// Checkerboard drawn in place of textures still loading or failed to load
+const int PLACEHOLDER_TEXTURE_SIZE = 64;
+const int PLACEHOLDER_CELL_SIZE = 8;
+
+// Where a texture ended up after packing: the atlas page it lives in and the
+// area it covers inside that page
+struct TextureRegion {
+    SDL_Texture* texture;
+    SDL_Rect     rect;
+};
+
+enum TextureState {
+    // Decoded, waiting for BuildTextureAtlas()
+    TEXTURE_PENDING,
+    // Decoding or uploading in the background, draws the placeholder
+    TEXTURE_LOADING,
+    TEXTURE_RESIDENT,
+    // Dropped to stay under the memory budget, reloaded on next use
+    TEXTURE_EVICTED,
+    // The image could not be loaded, draws the placeholder for good
+    TEXTURE_FAILED
+};
+
+struct TextureRecord {
+    std::string  id;
+    std::string  filePath;
+    TextureState state;
+    int          refCount;
+    Uint64       lastUsed;
+    // Index into m_ownedTextures of the texture holding the pixels
+    int owner;
+    // Set on glyph sheets, rasterized again from their font instead of
+    // loaded from a file
+    FontHandle font;
+};
+
+// An atlas page or standalone texture, evicted as a whole once none of the
+// handles packed in it is referenced
+struct OwnedTexture {
+    SDL_Texture*               texture;
+    std::size_t                numBytes;
+    std::vector<TextureHandle> handles;
+};
+
+struct FontRecord {
+    std::string id;
+    std::string filePath;
+    int         fontSize;
+    TTF_Font*   font;
+    std::size_t numBytes;
+    int         refCount;
+    Uint64      lastUsed;
+};
+
+struct SoundRecord {
+    std::string id;
+    std::string filePath;
+    Mix_Chunk*  chunk;
+    std::size_t numBytes;
+    int         refCount;
+    Uint64      lastUsed;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// AssetStore
+////////////////////////////////////////////////////////////////////////////////
+// Cache of every texture, font and sound. Adding an asset returns a handle
+// holding one reference, released with the matching Release call. While the
+// memory in use is over budget the least recently used unreferenced assets are
+// evicted, and reloaded the next time they are used.
+//
+// The tables belong to the simulation thread, the render thread only creates
+// and destroys textures through UploadTextures() and DestroyEvictedTextures().
+////////////////////////////////////////////////////////////////////////////////
 class AssetStore {
 private:
-    std::map<std::string, SDL_Texture*> m_textures;
-    // TODO: create a map for fonts
-    // TODO: create a map for audio
+    // Hot data, indexed by TextureHandle on every draw call
+    std::vector<TextureRegion> m_textures;
+
+    // Cold data, only touched when loading assets or spawning entities
+    std::vector<TextureRecord>                     m_textureRecords;
+    std::unordered_map<std::string, TextureHandle> m_textureHandles;
+
+    // Decoded images waiting to be packed [Vector index = texture handle]
+    std::vector<SDL_Surface*> m_pendingSurfaces;
+
+    // Atlas pages and standalone textures owned by the store, evicted entries
+    // are reused
+    std::vector<OwnedTexture> m_ownedTextures;
+
+    std::vector<FontRecord>                     m_fonts;
+    std::vector<GlyphAtlas>                     m_glyphAtlases;
+    std::unordered_map<std::string, FontHandle> m_fontHandles;
+
+    std::vector<SoundRecord>                     m_sounds;
+    std::unordered_map<std::string, SoundHandle> m_soundHandles;
+
+    // Memory accounting, a budget of 0 never evicts
+    std::size_t m_memoryUsage[NUM_ASSET_TYPES] = {};
+    std::size_t m_memoryBudget = 0;
+
+    // Advanced once per simulation tick, stamps when an asset was last used
+    Uint64 m_frame = 0;
+
+    // Only registers the assets, nothing is decoded or loaded
+    bool m_isHeadless = false;
+
+    // Pre-decoded images, must outlive the loader and every surface made
+    // from it
+    AssetArchive m_archive;
+
+    // Background decoding for AddTextureAsync() and evicted textures
+    AssetLoader               m_loader;
+    std::atomic<SDL_Texture*> m_placeholderTexture{nullptr};
+    bool                      m_hasPlaceholder = false;
+
+    // Images decoded but not uploaded yet, only touched by the render thread
+    std::vector<DecodedImage> m_decodedImages;
+
+    // Textures uploaded by the render thread, applied to m_textures by the
+    // simulation thread. Evicted textures go the other way, tagged with the
+    // frame they were evicted in.
+    std::mutex                                           m_uploadsMutex;
+    std::vector<std::pair<TextureHandle, TextureRegion>> m_uploads;
+    std::vector<std::pair<SDL_Texture*, Uint64>>         m_evictedTextures;
+
+    TextureHandle RegisterTexture(const std::string& assetId,
+                                  const std::string& filePath,
+                                  SDL_Surface*       surface,
+                                  TextureState       state);
+    int           AddOwnedTexture(SDL_Texture* texture, int width, int height);
+    void          CreatePlaceholderTexture(RenderBackend& renderer);
+    void          ApplyUploads();
+
+    // Evicts the least recently used unreferenced asset, false if there is
+    // nothing left that can be evicted
+    bool EvictLeastRecentlyUsed();
+    void EvictTexture(int owner);
+    void EvictFont(FontHandle handle);
+    void EvictSound(SoundHandle handle);
+    bool LoadFont(FontRecord& record);
+    bool LoadSound(SoundRecord& record);
 
 public:
     AssetStore();
     ~AssetStore();
 
-    void         ClearAssets();
-    void         AddTexture(SDL_Renderer* renderer, const std::string& assetId,
-                            const std::string& filePath);
-    SDL_Texture* GetTexture(const std::string& assetId);
+    // Textures are released through the backend that created them
+    void ClearAssets(RenderBackend& renderer);
+
+    // Images added after this come from the archive when it has them, the
+    // others are still decoded from their file
+    bool                OpenArchive(const std::string& filePath);
+    const AssetArchive& GetArchive() const { return m_archive; }
+
+    // Without a renderer or an audio device: assets added from then on get a
+    // valid handle but are never loaded, textures stay in the failed state
+    void SetHeadless(bool isHeadless) { m_isHeadless = isHeadless; }
+    bool IsHeadless() const { return m_isHeadless; }
+
+    void        SetMemoryBudget(std::size_t numBytes);
+    std::size_t GetMemoryBudget() const { return m_memoryBudget; }
+    std::size_t GetMemoryUsage(AssetType type) const {
+        return m_memoryUsage[type];
+    }
+
+    // Simulation thread, once per tick: makes the textures uploaded so far
+    // drawable and evicts assets while over budget
+    void   Update();
+    Uint64 GetFrame() const { return m_frame; }
+
+    ////////////////////////////////////////////////////////////////////////
+    // Textures
+    ////////////////////////////////////////////////////////////////////////
+
+    // Decodes the image and registers it, the texture becomes drawable after
+    // the next BuildTextureAtlas(). Adding an id already in the store takes
+    // another reference to it.
+    TextureHandle AddTexture(const std::string& assetId,
+                             const std::string& filePath);
+
+    // Returns right away and decodes the image on the loader threads. The
+    // handle draws a placeholder until the texture is uploaded, either by
+    // BuildTextureAtlas() or by UploadTextures()
+    TextureHandle AddTextureAsync(const std::string& assetId,
+                                  const std::string& filePath);
+
+    void AcquireTexture(TextureHandle handle);
+    void ReleaseTexture(TextureHandle handle);
+
+    // Starts reloading an evicted texture, it draws the placeholder meanwhile
+    void RequestTexture(TextureHandle handle);
+
+    // Waits for the images still decoding, then packs every pending image
+    // into as few atlas pages as possible and uploads them to the renderer.
+    // Meant for level loading, no frame may be in flight. A page is only
+    // evicted once none of its images is referenced, images that are not
+    // used for the same time belong in separate calls.
+    void BuildTextureAtlas(RenderBackend& renderer);
+
+    // Render thread: uploads images decoded in the background as standalone
+    // textures until budgetMs is spent, the rest wait for the next frame
+    void UploadTextures(RenderBackend& renderer, double budgetMs);
+
+    // Render thread: destroys the textures evicted up to the frame the
+    // snapshot being drawn was built in, nothing drawn from then on uses them
+    void DestroyEvictedTextures(RenderBackend& renderer, Uint64 frame);
+
+    bool IsTextureLoading(TextureHandle handle) const {
+        return m_textureRecords[handle].state == TEXTURE_LOADING;
+    }
+
+    TextureHandle      GetTextureHandle(const std::string& assetId) const;
+    const std::string& GetTextureId(TextureHandle handle) const;
+
+    const TextureRegion& GetTextureRegion(TextureHandle handle) const {
+        return m_textures[handle];
+    }
+    SDL_Texture* GetTexture(TextureHandle handle) const {
+        return m_textures[handle].texture;
+    }
+
+    // Marks the texture as drawn this frame so it is not evicted first
+    void TouchTexture(TextureHandle handle) {
+        m_textureRecords[handle].lastUsed = m_frame;
+    }
+
+    ////////////////////////////////////////////////////////////////////////
+    // Fonts and sounds, loaded on the calling thread
+    ////////////////////////////////////////////////////////////////////////
+
+    // Also rasterizes the glyphs into a sheet texture of its own, uploaded
+    // like an AddTextureAsync() image. The sheet is referenced along with
+    // the font, and rasterized again when it is used after being evicted.
+    FontHandle AddFont(const std::string& assetId, const std::string& filePath,
+                       int fontSize);
+    void       AcquireFont(FontHandle handle);
+    void       ReleaseFont(FontHandle handle);
+    FontHandle GetFontHandle(const std::string& assetId) const;
+    // Reloads the font if it was evicted, nullptr if it fails to load
+    TTF_Font* GetFont(FontHandle handle);
+
+    // Stays valid when the font itself is evicted
+    const GlyphAtlas& GetGlyphAtlas(FontHandle handle) const {
+        return m_glyphAtlases[handle];
+    }
+
+    SoundHandle AddSound(const std::string& assetId,
+                         const std::string& filePath);
+    void        AcquireSound(SoundHandle handle);
+    void        ReleaseSound(SoundHandle handle);
+    SoundHandle GetSoundHandle(const std::string& assetId) const;
+    // Reloads the sound if it was evicted, nullptr if it fails to load
+    Mix_Chunk* GetSound(SoundHandle handle);
 };
 
 #endif // !ASSET_STORE_H
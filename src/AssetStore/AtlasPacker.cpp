@@ -0,0 +1,94 @@
+#include "./AtlasPacker.h"
+#include <algorithm>
+#include <climits>
+
+AtlasPacker::AtlasPacker(int width, int height) {
+    m_width = width;
+    m_height = height;
+    m_usedWidth = 0;
+    m_usedHeight = 0;
+    m_skyline.push_back({0, 0, width});
+}
+
+bool AtlasPacker::Fits(int index, int width, int height, int& y) const {
+    int x = m_skyline[index].x;
+    if (x + width > m_width) {
+        return false;
+    }
+
+    // The rectangle rests on the highest segment it spans
+    int widthLeft = width;
+    y = m_skyline[index].y;
+    for (int i = index; widthLeft > 0; i++) {
+        if (i >= static_cast<int>(m_skyline.size())) {
+            return false;
+        }
+        y = std::max(y, m_skyline[i].y);
+        if (y + height > m_height) {
+            return false;
+        }
+        widthLeft -= m_skyline[i].width;
+    }
+    return true;
+}
+
+void AtlasPacker::AddLevel(int index, const SDL_Rect& rect) {
+    m_skyline.insert(m_skyline.begin() + index,
+                     {rect.x, rect.y + rect.h, rect.w});
+
+    // Shrink or remove the segments now covered by the new one
+    for (int i = index + 1; i < static_cast<int>(m_skyline.size()); i++) {
+        const auto& prev = m_skyline[i - 1];
+        auto&       node = m_skyline[i];
+        if (node.x >= prev.x + prev.width) {
+            break;
+        }
+        int shrink = prev.x + prev.width - node.x;
+        node.x += shrink;
+        node.width -= shrink;
+        if (node.width > 0) {
+            break;
+        }
+        m_skyline.erase(m_skyline.begin() + i);
+        i--;
+    }
+
+    // Merge neighbouring segments at the same height
+    for (int i = 0; i + 1 < static_cast<int>(m_skyline.size()); i++) {
+        if (m_skyline[i].y == m_skyline[i + 1].y) {
+            m_skyline[i].width += m_skyline[i + 1].width;
+            m_skyline.erase(m_skyline.begin() + i + 1);
+            i--;
+        }
+    }
+}
+
+bool AtlasPacker::Insert(int width, int height, SDL_Rect& rect) {
+    int bestIndex = -1;
+    int bestBottom = INT_MAX;
+    int bestWidth = INT_MAX;
+
+    for (int i = 0; i < static_cast<int>(m_skyline.size()); i++) {
+        int y;
+        if (!Fits(i, width, height, y)) {
+            continue;
+        }
+        // Prefer the lowest placement, then the tightest segment
+        if (y + height < bestBottom ||
+            (y + height == bestBottom && m_skyline[i].width < bestWidth)) {
+            bestIndex = i;
+            bestBottom = y + height;
+            bestWidth = m_skyline[i].width;
+            rect = {m_skyline[i].x, y, width, height};
+        }
+    }
+
+    if (bestIndex == -1) {
+        return false;
+    }
+
+    AddLevel(bestIndex, rect);
+    m_usedWidth = std::max(m_usedWidth, rect.x + rect.w);
+    m_usedHeight = std::max(m_usedHeight, bestBottom);
+    return true;
+}
@@ -0,0 +1,44 @@
+#ifndef ATLAS_PACKER_H
+#define ATLAS_PACKER_H
+
+#include <SDL2/SDL.h>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+// AtlasPacker
+////////////////////////////////////////////////////////////////////////////////
+// Skyline bottom-left rectangle packer. The skyline is the list of horizontal
+// segments forming the top edge of everything packed so far, new rectangles
+// are placed on the segment that keeps the skyline lowest.
+////////////////////////////////////////////////////////////////////////////////
+class AtlasPacker {
+private:
+    struct SkylineNode {
+        int x;
+        int y;
+        int width;
+    };
+
+    int                      m_width;
+    int                      m_height;
+    int                      m_usedWidth;
+    int                      m_usedHeight;
+    std::vector<SkylineNode> m_skyline;
+
+    bool Fits(int index, int width, int height, int& y) const;
+    void AddLevel(int index, const SDL_Rect& rect);
+
+public:
+    AtlasPacker(int width, int height);
+
+    // Finds a spot for a width x height rectangle, returns false if the atlas
+    // is full
+    bool Insert(int width, int height, SDL_Rect& rect);
+
+    int GetWidth() const { return m_width; }
+    int GetHeight() const { return m_height; }
+    int GetUsedWidth() const { return m_usedWidth; }
+    int GetUsedHeight() const { return m_usedHeight; }
+};
+
+#endif // !ATLAS_PACKER_H
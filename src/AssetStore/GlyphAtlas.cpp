@@ -0,0 +1,55 @@
+#include "./GlyphAtlas.h"
+#include "../Logger/Logger.h"
+#include "./AtlasPacker.h"
+#include <algorithm>
+
+SDL_Surface* RasterizeGlyphs(TTF_Font* font, GlyphAtlas& atlas) {
+    const SDL_Color white = {255, 255, 255, 255};
+    SDL_Surface*    surfaces[NUM_GLYPHS] = {};
+
+    atlas.lineHeight = TTF_FontHeight(font);
+    atlas.lineSkip = TTF_FontLineSkip(font);
+
+    // Every glyph surface is a full line high with the glyph already placed
+    // on the baseline, so laying text out is just adding advances
+    AtlasPacker packer(GLYPH_SHEET_WIDTH, GLYPH_SHEET_WIDTH * 4);
+    for (int i = 0; i < NUM_GLYPHS; i++) {
+        Glyph&       glyph = atlas.glyphs[i];
+        const Uint16 ch = FIRST_GLYPH + i;
+        int          minX, maxX, minY, maxY;
+        glyph.rect = {0, 0, 0, 0};
+        glyph.advance = 0;
+        if (TTF_GlyphMetrics(font, ch, &minX, &maxX, &minY, &maxY,
+                             &glyph.advance) != 0) {
+            continue;
+        }
+
+        surfaces[i] = TTF_RenderGlyph_Blended(font, ch, white);
+        if (!surfaces[i] || ch == ' ') {
+            continue;
+        }
+        if (!packer.Insert(surfaces[i]->w + GLYPH_SHEET_PADDING,
+                           surfaces[i]->h + GLYPH_SHEET_PADDING, glyph.rect)) {
+            Logger::Err("Glyph sheet is full, the font size is too big");
+            break;
+        }
+        glyph.rect.w = surfaces[i]->w;
+        glyph.rect.h = surfaces[i]->h;
+    }
+
+    SDL_Surface* sheet = SDL_CreateRGBSurfaceWithFormat(
+        0, packer.GetWidth(), std::max(1, packer.GetUsedHeight()), 32,
+        SDL_PIXELFORMAT_RGBA32);
+    for (int i = 0; i < NUM_GLYPHS; i++) {
+        if (!surfaces[i]) {
+            continue;
+        }
+        if (sheet && atlas.glyphs[i].rect.w > 0) {
+            SDL_Rect dstRect = atlas.glyphs[i].rect;
+            SDL_SetSurfaceBlendMode(surfaces[i], SDL_BLENDMODE_NONE);
+            SDL_BlitSurface(surfaces[i], NULL, sheet, &dstRect);
+        }
+        SDL_FreeSurface(surfaces[i]);
+    }
+    return sheet;
+}
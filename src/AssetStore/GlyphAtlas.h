@@ -0,0 +1,48 @@
+#ifndef GLYPH_ATLAS_H
+#define GLYPH_ATLAS_H
+
+#include "./AssetHandle.h"
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+
+// Printable ASCII, anything else is drawn as FALLBACK_GLYPH
+const int  FIRST_GLYPH = 32;
+const int  LAST_GLYPH = 126;
+const int  NUM_GLYPHS = LAST_GLYPH - FIRST_GLYPH + 1;
+const char FALLBACK_GLYPH = '?';
+
+const int GLYPH_SHEET_WIDTH = 512;
+const int GLYPH_SHEET_PADDING = 1;
+
+struct Glyph {
+    // Area of the glyph inside the glyph sheet, empty for blank glyphs
+    SDL_Rect rect;
+    int      advance;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// GlyphAtlas
+////////////////////////////////////////////////////////////////////////////////
+// Every glyph of a font at one size, rasterized into a single sheet. The sheet
+// is a texture of the AssetStore with a page of its own, referenced and
+// evicted along with its font and rasterized again when it comes back.
+////////////////////////////////////////////////////////////////////////////////
+struct GlyphAtlas {
+    TextureHandle texture = INVALID_TEXTURE_HANDLE;
+    int           lineHeight = 0;
+    int           lineSkip = 0;
+    Glyph         glyphs[NUM_GLYPHS] = {};
+
+    const Glyph& GetGlyph(char ch) const {
+        if (ch < FIRST_GLYPH || ch > LAST_GLYPH) {
+            ch = FALLBACK_GLYPH;
+        }
+        return glyphs[ch - FIRST_GLYPH];
+    }
+};
+
+// Renders every glyph in white and packs them into a new RGBA32 surface,
+// their tint comes from the draw color. Returns nullptr on failure.
+SDL_Surface* RasterizeGlyphs(TTF_Font* font, GlyphAtlas& atlas);
+
+#endif // !GLYPH_ATLAS_H
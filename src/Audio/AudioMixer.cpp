@@ -0,0 +1,188 @@
+#include "./AudioMixer.h"
+#include "../Logger/Logger.h"
+#include <SDL2/SDL_mixer.h>
+#include <algorithm>
+
+AudioMixer::~AudioMixer() { Destroy(); }
+
+bool AudioMixer::Initialize(int numVoices) {
+    if (Mix_OpenAudio(MIX_DEFAULT_FREQUENCY, MIX_DEFAULT_FORMAT, 2, 1024) !=
+        0) {
+        Logger::Err("Error opening the audio device: " +
+                    std::string(Mix_GetError()));
+        return false;
+    }
+    m_isOpen = true;
+
+    // Every voice is a mixer channel, nothing else allocates channels
+    Mix_AllocateChannels(numVoices);
+    m_voices.assign(numVoices, {INVALID_SOUND_HANDLE, 0});
+
+    Logger::Log("Audio mixer opened with " + std::to_string(numVoices) +
+                " voices");
+    return true;
+}
+
+void AudioMixer::Destroy() {
+    if (!m_isOpen) {
+        return;
+    }
+    Mix_HaltChannel(-1);
+    Mix_CloseAudio();
+    m_isOpen = false;
+    // The references the voices hold go away with the AssetStore, that is
+    // cleared on shutdown as well
+    m_voices.clear();
+    m_requests.clear();
+}
+
+void AudioMixer::SetSoundLimit(SoundHandle sound, int maxInstances) {
+    m_soundLimits[sound] = maxInstances;
+}
+
+int AudioMixer::GetSoundLimit(SoundHandle sound) const {
+    auto limit = m_soundLimits.find(sound);
+    if (limit == m_soundLimits.end()) {
+        return DEFAULT_SOUND_INSTANCES;
+    }
+    return limit->second;
+}
+
+void AudioMixer::Play(SoundHandle sound, const glm::vec2& position,
+                      int priority) {
+    m_requests.push_back({sound, position, priority, true, 0.0f});
+}
+
+void AudioMixer::PlayGlobal(SoundHandle sound, int priority) {
+    m_requests.push_back({sound, glm::vec2(0), priority, false, 0.0f});
+}
+
+int AudioMixer::CountInstances(SoundHandle sound) const {
+    int numInstances = 0;
+    for (const auto& voice : m_voices) {
+        numInstances += voice.sound == sound;
+    }
+    return numInstances;
+}
+
+void AudioMixer::FreeVoice(AssetStore& assetStore, int voice) {
+    assetStore.ReleaseSound(m_voices[voice].sound);
+    m_voices[voice].sound = INVALID_SOUND_HANDLE;
+}
+
+int AudioMixer::FindVoice(AssetStore& assetStore, int priority) {
+    int lowest = -1;
+    for (size_t i = 0; i < m_voices.size(); i++) {
+        if (m_voices[i].sound == INVALID_SOUND_HANDLE) {
+            return i;
+        }
+        if (lowest < 0 || m_voices[i].priority < m_voices[lowest].priority) {
+            lowest = i;
+        }
+    }
+
+    // Only a strictly lower priority sound gives its voice away
+    if (lowest < 0 || m_voices[lowest].priority >= priority) {
+        return -1;
+    }
+    Mix_HaltChannel(lowest);
+    FreeVoice(assetStore, lowest);
+    m_stats.numStolen++;
+    return lowest;
+}
+
+void AudioMixer::StartVoice(AssetStore& assetStore, int voice,
+                            const PlayRequest& request, Mix_Chunk* chunk) {
+    if (Mix_PlayChannel(voice, chunk, 0) < 0) {
+        m_stats.numDropped++;
+        return;
+    }
+
+    // Distance 0 also removes the attenuation left by the previous sound
+    Uint8 distance = 0;
+    if (request.isPositional) {
+        distance = static_cast<Uint8>(
+            std::min(255.0f, request.distance * 255.0f / AUDIBLE_DISTANCE));
+    }
+    Mix_SetDistance(voice, distance);
+
+    m_voices[voice] = {request.sound, request.priority};
+    assetStore.AcquireSound(request.sound);
+    m_stats.numPlayed++;
+}
+
+void AudioMixer::Update(AssetStore& assetStore, const SDL_Rect& camera) {
+    if (!m_isOpen) {
+        m_requests.clear();
+        return;
+    }
+
+    // Voices whose sound ended are free again
+    for (size_t i = 0; i < m_voices.size(); i++) {
+        if (m_voices[i].sound != INVALID_SOUND_HANDLE && !Mix_Playing(i)) {
+            FreeVoice(assetStore, i);
+        }
+    }
+    if (m_requests.empty()) {
+        return;
+    }
+    m_stats.numRequests += m_requests.size();
+
+    // Cull what can not be heard from the camera
+    const glm::vec2 listener(camera.x + camera.w / 2.0f,
+                             camera.y + camera.h / 2.0f);
+    auto isInaudible = [&listener](PlayRequest& request) {
+        if (!request.isPositional) {
+            return false;
+        }
+        request.distance = glm::length(request.position - listener);
+        return request.distance > AUDIBLE_DISTANCE;
+    };
+    auto audible =
+        std::remove_if(m_requests.begin(), m_requests.end(), isInaudible);
+    m_stats.numCulled += m_requests.end() - audible;
+    m_requests.erase(audible, m_requests.end());
+
+    // The same sample started twice in one frame only plays louder, keep the
+    // most important request of every sound
+    auto isMoreImportant = [](const PlayRequest& a, const PlayRequest& b) {
+        if (a.priority != b.priority) {
+            return a.priority > b.priority;
+        }
+        return a.distance < b.distance;
+    };
+    std::sort(m_requests.begin(), m_requests.end(),
+              [&isMoreImportant](const PlayRequest& a, const PlayRequest& b) {
+                  if (a.sound != b.sound) {
+                      return a.sound < b.sound;
+                  }
+                  return isMoreImportant(a, b);
+              });
+    auto merged = std::unique(m_requests.begin(), m_requests.end(),
+                              [](const PlayRequest& a, const PlayRequest& b) {
+                                  return a.sound == b.sound;
+                              });
+    m_stats.numMerged += m_requests.end() - merged;
+    m_requests.erase(merged, m_requests.end());
+
+    std::sort(m_requests.begin(), m_requests.end(), isMoreImportant);
+    for (const auto& request : m_requests) {
+        if (CountInstances(request.sound) >= GetSoundLimit(request.sound)) {
+            m_stats.numLimited++;
+            continue;
+        }
+
+        Mix_Chunk* chunk = assetStore.GetSound(request.sound);
+        int        voice = chunk ? FindVoice(assetStore, request.priority) : -1;
+        if (voice < 0) {
+            m_stats.numDropped++;
+            continue;
+        }
+        StartVoice(assetStore, voice, request, chunk);
+    }
+    m_requests.clear();
+}
+
+int AudioMixer::GetNumPlaying() const {
+    return m_voices.size() - CountInstances(INVALID_SOUND_HANDLE);
+}
@@ -0,0 +1,99 @@
+#ifndef AUDIO_MIXER_H
+#define AUDIO_MIXER_H
+
+#include "../AssetStore/AssetStore.h"
+#include <SDL2/SDL.h>
+#include <glm/glm.hpp>
+#include <unordered_map>
+#include <vector>
+
+const int DEFAULT_NUM_VOICES = 16;
+const int DEFAULT_SOUND_INSTANCES = 4;
+
+// Sounds further than this from the center of the camera are not played
+const float AUDIBLE_DISTANCE = 1000.0f;
+
+// Sounds with a higher priority steal voices from lower ones
+const int SOUND_PRIORITY_LOW = 0;
+const int SOUND_PRIORITY_NORMAL = 50;
+const int SOUND_PRIORITY_HIGH = 100;
+
+// Counters since the mixer was initialized
+struct AudioStats {
+    long long numRequests = 0;
+    long long numPlayed = 0;
+    long long numCulled = 0;
+    long long numMerged = 0;
+    long long numLimited = 0;
+    long long numStolen = 0;
+    long long numDropped = 0;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// AudioMixer
+////////////////////////////////////////////////////////////////////////////////
+// Owns a fixed pool of mixer channels (voices). Play() only queues a request,
+// Update() handles all the requests of the frame at once: far away sounds are
+// culled, requests for the same sound are merged, the per sound instance limit
+// is applied and the survivors take a free voice or steal one from a lower
+// priority sound. The mixer lock is taken once per sound actually started.
+// A voice holds a reference to its sound until it is free again, so the
+// AssetStore never evicts a sample the mixer is still playing.
+////////////////////////////////////////////////////////////////////////////////
+class AudioMixer {
+private:
+    struct PlayRequest {
+        SoundHandle sound;
+        glm::vec2   position;
+        int         priority;
+        bool        isPositional;
+        float       distance;
+    };
+
+    struct Voice {
+        SoundHandle sound;
+        int         priority;
+    };
+
+    bool m_isOpen = false;
+
+    std::vector<Voice>                   m_voices;
+    std::vector<PlayRequest>             m_requests;
+    std::unordered_map<SoundHandle, int> m_soundLimits;
+    AudioStats                           m_stats;
+
+    int  GetSoundLimit(SoundHandle sound) const;
+    int  CountInstances(SoundHandle sound) const;
+    int  FindVoice(AssetStore& assetStore, int priority);
+    void StartVoice(AssetStore& assetStore, int voice,
+                    const PlayRequest& request, Mix_Chunk* chunk);
+    void FreeVoice(AssetStore& assetStore, int voice);
+
+public:
+    AudioMixer() = default;
+    ~AudioMixer();
+
+    // Opens the audio device, the dummy SDL audio driver works as well
+    bool Initialize(int numVoices = DEFAULT_NUM_VOICES);
+    void Destroy();
+    bool IsOpen() const { return m_isOpen; }
+
+    // Most instances of the sound allowed to play at the same time
+    void SetSoundLimit(SoundHandle sound, int maxInstances);
+
+    // Queues a sound emitted at a world position
+    void Play(SoundHandle sound, const glm::vec2& position,
+              int priority = SOUND_PRIORITY_NORMAL);
+
+    // Queues a sound that is never culled nor attenuated, like music or UI
+    void PlayGlobal(SoundHandle sound, int priority = SOUND_PRIORITY_HIGH);
+
+    // Once per simulation tick, starts the sounds queued since the last one
+    void Update(AssetStore& assetStore, const SDL_Rect& camera);
+
+    int               GetNumVoices() const { return m_voices.size(); }
+    int               GetNumPlaying() const;
+    const AudioStats& GetStats() const { return m_stats; }
+};
+
+#endif // !AUDIO_MIXER_H
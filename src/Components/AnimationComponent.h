@@ -1,13 +1,13 @@
 #ifndef ANIMATION_COMPONENT_H
 #define ANIMATION_COMPONENT_H
 
-#include <SDL2/SDL.h>
-
 struct AnimationComponent {
     int  numFrames;
     int  currentFrame;
     int  frameRateSpeed;
     bool isLoop;
+    // Simulation time the animation started at, set by the AnimationSystem
+    // the first time it sees the entity
     int  startTime;
 
     AnimationComponent(int numFrames = 1, int frameRateSpeed = 1,
@@ -16,7 +16,7 @@ struct AnimationComponent {
         this->currentFrame = 1;
         this->frameRateSpeed = frameRateSpeed;
         this->isLoop = isLoop;
-        this->startTime = SDL_GetTicks();
+        this->startTime = -1;
     }
 };
 
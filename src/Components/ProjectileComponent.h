@@ -1,20 +1,24 @@
 #ifndef PROJECTILE_COMPONENT_H
 #define PROJECTILE_COMPONENT_H
 
-#include <SDL2/SDL.h>
+#include <cstdint>
 
 struct ProjectileComponent {
-    bool isFriendly;
-    int  hitPercentDamage;
-    int  duration;
-    int  startTime;
+    bool          isFriendly;
+    int           hitPercentDamage;
+    int           duration;
+    // Simulation time the projectile was fired at and its expiry timer, set
+    // by the ProjectileLifecycleSystem when the entity joins it
+    int           startTime;
+    std::uint32_t expiryTimer;
 
     ProjectileComponent(bool isFriendly = false, int hitPercentDamage = 0,
                         int duration = 0) {
         this->isFriendly = isFriendly;
         this->hitPercentDamage = hitPercentDamage;
         this->duration = duration;
-        this->startTime = SDL_GetTicks();
+        this->startTime = -1;
+        this->expiryTimer = 0;
     }
 };
 
@@ -1,28 +1,38 @@
 #ifndef PROJECTILE_EMITTER_COMPONENT_H
 #define PROJECTILE_EMITTER_COMPONENT_H
 
-#include <SDL2/SDL.h>
+#include "../AssetStore/AssetHandle.h"
+#include <cstdint>
 #include <glm/glm.hpp>
 
 struct ProjectileEmitterComponent {
-    glm::vec2 projectileVelocity;
-    int       repeatFrequency;
-    int       projectileDuration;
-    int       hitPercentDamage;
-    bool      isFriendly;
-    int       lastEmissionTime;
+    glm::vec2     projectileVelocity;
+    int           repeatFrequency;
+    int           projectileDuration;
+    int           hitPercentDamage;
+    bool          isFriendly;
+    // Simulation time of the last emission and the timer of the next one, set
+    // by the ProjectileEmitSystem when the entity joins it
+    int           lastEmissionTime;
+    std::uint32_t emissionTimer;
+    TextureHandle projectileTexture;
+    SoundHandle   projectileSound;
 
-    ProjectileEmitterComponent(glm::vec2 projectileVelocity = glm::vec2(0),
-                               int       repeatFrequency = 0,
-                               int       projectileDuration = 10000,
-                               int       hitPercentDamage = 10,
-                               bool      isFriendly = false) {
+    ProjectileEmitterComponent(
+        glm::vec2 projectileVelocity = glm::vec2(0), int repeatFrequency = 0,
+        int projectileDuration = 10000, int hitPercentDamage = 10,
+        bool          isFriendly = false,
+        TextureHandle projectileTexture = INVALID_TEXTURE_HANDLE,
+        SoundHandle   projectileSound = INVALID_SOUND_HANDLE) {
         this->projectileVelocity = projectileVelocity;
         this->repeatFrequency = repeatFrequency;
         this->projectileDuration = projectileDuration;
         this->hitPercentDamage = hitPercentDamage;
         this->isFriendly = isFriendly;
-        this->lastEmissionTime = SDL_GetTicks();
+        this->lastEmissionTime = -1;
+        this->emissionTimer = 0;
+        this->projectileTexture = projectileTexture;
+        this->projectileSound = projectileSound;
     }
 };
 
@@ -0,0 +1,13 @@
+#ifndef SCRIPT_COMPONENT_H
+#define SCRIPT_COMPONENT_H
+
+// Runs a Lua behaviour on the entity, together with every other entity using
+// the same behaviour
+struct ScriptComponent {
+    // Behaviour id returned by ScriptEngine::GetBehaviour(), -1 for none
+    int behaviour;
+
+    ScriptComponent(int behaviour = -1) { this->behaviour = behaviour; }
+};
+
+#endif // !SCRIPT_COMPONENT_H
@@ -1,21 +1,22 @@
 #ifndef SPRITE_COMPONENT_H
 #define SPRITE_COMPONENT_H
 
+#include "../AssetStore/AssetHandle.h"
 #include <SDL2/SDL.h>
-#include <string>
+#include <type_traits>
 
 struct SpriteComponent {
-    std::string assetId;
-    int         width;
-    int         height;
-    int         zIndex;
-    bool        isFixed;
-    SDL_Rect    srcRect;
+    TextureHandle texture;
+    int           width;
+    int           height;
+    int           zIndex;
+    bool          isFixed;
+    SDL_Rect      srcRect;
 
-    SpriteComponent(std::string assetId = "", int width = 0, int height = 0,
-                    int zIndex = 0, bool isFixed = false, int srcRectX = 0,
-                    int srcRectY = 0) {
-        this->assetId = assetId;
+    SpriteComponent(TextureHandle texture = INVALID_TEXTURE_HANDLE,
+                    int width = 0, int height = 0, int zIndex = 0,
+                    bool isFixed = false, int srcRectX = 0, int srcRectY = 0) {
+        this->texture = texture;
         this->width = width;
         this->height = height;
         this->zIndex = zIndex;
@@ -24,4 +25,8 @@ struct SpriteComponent {
     }
 };
 
+// The render loop copies sprites around by value, keep it a plain struct
+static_assert(std::is_trivially_copyable<SpriteComponent>::value,
+              "SpriteComponent must be trivially copyable");
+
 #endif // !SPRITE_COMPONENT_H
@@ -0,0 +1,13 @@
+#ifndef STREAMED_COMPONENT_H
+#define STREAMED_COMPONENT_H
+
+// The entity is saved and destroyed when the world cell it stands in is
+// unloaded, and spawned again when the cell is loaded back
+struct StreamedComponent {
+    // Index of the world cell the entity was in on the last streaming update
+    int cell;
+
+    StreamedComponent(int cell = -1) { this->cell = cell; }
+};
+
+#endif // !STREAMED_COMPONENT_H
@@ -0,0 +1,30 @@
+#ifndef TEXT_LABEL_COMPONENT_H
+#define TEXT_LABEL_COMPONENT_H
+
+#include "../AssetStore/AssetHandle.h"
+#include <SDL2/SDL.h>
+#include <glm/glm.hpp>
+#include <string>
+
+struct TextLabelComponent {
+    glm::vec2   position;
+    std::string text;
+    FontHandle  font;
+    SDL_Color   color;
+    int         zIndex;
+    bool        isFixed;
+
+    TextLabelComponent(glm::vec2 position = glm::vec2(0), std::string text = "",
+                       FontHandle font = INVALID_FONT_HANDLE,
+                       const SDL_Color& color = {255, 255, 255, 255},
+                       int zIndex = 0, bool isFixed = true) {
+        this->position = position;
+        this->text = text;
+        this->font = font;
+        this->color = color;
+        this->zIndex = zIndex;
+        this->isFixed = isFixed;
+    }
+};
+
+#endif // !TEXT_LABEL_COMPONENT_H
@@ -0,0 +1,27 @@
+#ifndef TILEMAP_COMPONENT_H
+#define TILEMAP_COMPONENT_H
+
+#include "../AssetStore/AssetHandle.h"
+#include "../Tilemap/Tilemap.h"
+#include <memory>
+
+struct TilemapComponent {
+    // Shared with the tile layer drawing it
+    std::shared_ptr<Tilemap> tilemap;
+    double                   tileScale;
+    TextureHandle            tileset;
+
+    TilemapComponent(std::shared_ptr<Tilemap> tilemap = nullptr,
+                     double tileScale = 1.0,
+                     TextureHandle tileset = INVALID_TEXTURE_HANDLE) {
+        this->tilemap = tilemap;
+        this->tileScale = tileScale;
+        this->tileset = tileset;
+    }
+
+    double GetTileWorldSize() const {
+        return tilemap->GetTileSize() * tileScale;
+    }
+};
+
+#endif // !TILEMAP_COMPONENT_H
@@ -7,6 +7,9 @@ struct TransformComponent {
     glm::vec2 position;
     glm::vec2 scale;
     double    rotation;
+    // Position at the start of the current tick, the renderer blends from it
+    // to position between two ticks
+    glm::vec2 previousPosition;
 
     TransformComponent(glm::vec2 position = glm::vec2(0, 0),
                        glm::vec2 scale = glm::vec2(1, 1),
@@ -14,6 +17,7 @@ struct TransformComponent {
         this->position = position;
         this->scale = scale;
         this->rotation = rotation;
+        this->previousPosition = position;
     }
 };
 
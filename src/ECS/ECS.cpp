@@ -1,11 +1,17 @@
 #include "ECS.h"
 #include "../Logger/Logger.h"
+#include "../Profiler/Profiler.h"
 #include <algorithm>
+#include <cstdlib>
+#include <cxxabi.h>
+#include <mutex>
 
 int IComponent::s_nextId = 0;
 
 int  Entity::GetId() const { return id; }
 void Entity::Kill() { registry->KillEntity(*this); }
+void Entity::Recycle() { registry->RecycleEntity(*this); }
+bool Entity::IsRecycled() const { return registry->IsEntityRecycled(*this); }
 
 void Entity::Tag(const std::string& tag) const {
     registry->TagEntity(*this, tag);
@@ -23,16 +29,79 @@ bool Entity::BelongsToGroup(const std::string& group) const {
     return registry->EntityBelongsToGroup(*this, group);
 }
 
-void System::AddEntityToSystem(Entity entity) { m_entities.push_back(entity); }
+int System::GetEntityIndex(Entity entity) const {
+    const auto entityId = entity.GetId();
+    if (entityId >= static_cast<int>(m_entityIndices.size())) {
+        return -1;
+    }
+    return m_entityIndices[entityId];
+}
+
+void System::SwapEntities(int first, int second) {
+    std::swap(m_entities[first], m_entities[second]);
+    m_entityIndices[m_entities[first].GetId()] = first;
+    m_entityIndices[m_entities[second].GetId()] = second;
+}
+
+void System::AddEntityToSystem(Entity entity) {
+    const auto entityId = entity.GetId();
+    if (entityId >= static_cast<int>(m_entityIndices.size())) {
+        m_entityIndices.resize(entityId + 1, -1);
+    }
+    m_entities.push_back(entity);
+    m_entityIndices[entityId] = static_cast<int>(m_entities.size()) - 1;
+    // New entities are active, ahead of the recycled ones
+    ActivateEntity(entity);
+}
+
+bool System::RemoveEntityFromSystem(Entity entity) {
+    const int index = GetEntityIndex(entity);
+    if (index < 0) {
+        return false;
+    }
+    // The entities after it move up one place, the first recycled one takes
+    // the last active place
+    const bool isActive = index < m_numActive;
+    if (isActive) {
+        m_numActive--;
+    }
+    m_entities.erase(m_entities.begin() + index);
+    m_entityIndices[entity.GetId()] = -1;
+    for (std::size_t i = index; i < m_entities.size(); i++) {
+        m_entityIndices[m_entities[i].GetId()] = static_cast<int>(i);
+    }
+    return isActive;
+}
+
+bool System::ActivateEntity(Entity entity) {
+    const int index = GetEntityIndex(entity);
+    if (index < m_numActive) {
+        return false;
+    }
+    SwapEntities(index, m_numActive);
+    m_numActive++;
+    return true;
+}
 
-void System::RemoveEntityFromSystem(Entity entity) {
-    m_entities.erase(
-        std::remove_if(m_entities.begin(), m_entities.end(),
-                       [&entity](Entity other) { return entity == other; }),
-        m_entities.end());
+bool System::DeactivateEntity(Entity entity) {
+    const int index = GetEntityIndex(entity);
+    if (index < 0 || index >= m_numActive) {
+        return false;
+    }
+    SwapEntities(index, m_numActive - 1);
+    m_numActive--;
+    return true;
 }
 
-std::vector<Entity> System::GetSystemEntities() const { return m_entities; }
+bool System::IsEntityActive(Entity entity) const {
+    const int index = GetEntityIndex(entity);
+    return index >= 0 && index < m_numActive;
+}
+
+std::vector<Entity> System::GetSystemEntities() const {
+    return std::vector<Entity>(m_entities.begin(),
+                               m_entities.begin() + m_numActive);
+}
 
 const Signature& System::GetComponentSignature() const {
     return m_componentSignature;
@@ -45,6 +114,7 @@ Entity Registry::CreateEntity() {
         entityId = m_numEntities++;
         if (entityId >= static_cast<int>(m_entityComponentSignatures.size())) {
             m_entityComponentSignatures.resize(entityId + 1);
+            m_isEntityRecycled.resize(entityId + 1, false);
         }
     } else {
         // Reuse an id from the list of previously removed entities
@@ -56,13 +126,68 @@ Entity Registry::CreateEntity() {
     entity.registry = this;
     m_entitiesToBeAdded.insert(entity);
 
-    Logger::Log("Entity created with id " + std::to_string(entityId));
+    LOG_FORMAT(LOG_DEBUG, "Entity created with id {}", entityId);
     return entity;
 }
 
 void Registry::KillEntity(Entity entity) {
-    Logger::Log("Entity killed with id " + std::to_string(entity.GetId()));
+    LOG_FORMAT(LOG_DEBUG, "Entity killed with id {}", entity.GetId());
     m_entitiesToBeKilled.insert(entity);
+
+    // A recycled entity leaves the pool of its group, it must not be reused
+    const int entityId = entity.GetId();
+    if (m_isEntityRecycled[entityId]) {
+        auto& recycled = m_recycledPerGroup[GetEntityGroup(entity)];
+        recycled.erase(std::find(recycled.begin(), recycled.end(), entity));
+        m_isEntityRecycled[entityId] = false;
+        m_numRecycled--;
+    }
+}
+
+Entity Registry::CreatePooledEntity(const std::string& group) {
+    auto& recycled = m_recycledPerGroup[group];
+    if (recycled.empty()) {
+        Entity entity = CreateEntity();
+        GroupEntity(entity, group);
+        return entity;
+    }
+
+    Entity entity = recycled.back();
+    recycled.pop_back();
+    m_isEntityRecycled[entity.GetId()] = false;
+    m_numRecycled--;
+    m_entitiesToBeReused.push_back(entity);
+
+    LOG_FORMAT(LOG_DEBUG, "Entity reused with id {}", entity.GetId());
+    return entity;
+}
+
+void Registry::RecycleEntity(Entity entity) {
+    const int entityId = entity.GetId();
+    if (m_isEntityRecycled[entityId] ||
+        m_entitiesToBeKilled.find(entity) != m_entitiesToBeKilled.end()) {
+        return;
+    }
+    auto groupedEntity = m_groupPerEntity.find(entityId);
+    if (groupedEntity == m_groupPerEntity.end()) {
+        KillEntity(entity);
+        return;
+    }
+
+    m_isEntityRecycled[entityId] = true;
+    m_numRecycled++;
+    m_recycledPerGroup[groupedEntity->second].push_back(entity);
+    for (auto& system : m_systems) {
+        if (system.second->DeactivateEntity(entity)) {
+            system.second->OnEntityDeactivated(entity);
+        }
+    }
+
+    LOG_FORMAT(LOG_DEBUG, "Entity recycled with id {}", entityId);
+}
+
+bool Registry::IsEntityRecycled(Entity entity) const {
+    return m_isEntityRecycled[entity.GetId()];
 }
 
 void Registry::TagEntity(Entity entity, const std::string& tag) {
@@ -101,7 +226,7 @@ bool Registry::EntityBelongsToGroup(Entity             entity,
     if (m_entitiesPerGroup.find(group) == m_entitiesPerGroup.end()) {
         return false;
     }
-    auto groupEntities = m_entitiesPerGroup.at(group);
+    const auto& groupEntities = m_entitiesPerGroup.at(group);
     return groupEntities.find(entity.GetId()) != groupEntities.end();
 }
 
@@ -111,6 +236,14 @@ Registry::GetEntitiesByGroup(const std::string& group) const {
     return std::vector<Entity>(setOfEntities.begin(), setOfEntities.end());
 }
 
+std::string Registry::GetEntityGroup(Entity entity) const {
+    auto groupedEntity = m_groupPerEntity.find(entity.GetId());
+    if (groupedEntity == m_groupPerEntity.end()) {
+        return "";
+    }
+    return groupedEntity->second;
+}
+
 void Registry::RemoveEntityGroup(Entity entity) {
     // if in group, remove entity from group management
     auto groupedEntity = m_groupPerEntity.find(entity.GetId());
@@ -142,17 +275,26 @@ void Registry::AddEntityToSystems(Entity entity) {
 
         if (isInterested) {
             system.second->AddEntityToSystem(entity);
+            // Recycled before it even joined its systems
+            if (m_isEntityRecycled[entityId]) {
+                system.second->DeactivateEntity(entity);
+            } else {
+                system.second->OnEntityActivated(entity);
+            }
         }
     }
 }
 
 void Registry::RemoveEntityFromSystems(Entity entity) {
     for (auto systemPair : m_systems) {
-        systemPair.second->RemoveEntityFromSystem(entity);
+        if (systemPair.second->RemoveEntityFromSystem(entity)) {
+            systemPair.second->OnEntityDeactivated(entity);
+        }
     }
 }
 
 void Registry::Update() {
+    PROFILE_ZONE("Registry::Update");
     // Processing the entities that are waiting to be created to the active
     // systems
     for (auto entity : m_entitiesToBeAdded) {
@@ -160,11 +302,28 @@ void Registry::Update() {
     }
     m_entitiesToBeAdded.clear();
 
+    // Reused entities join the entities of their systems again, unless they
+    // were recycled once more in the meantime
+    for (auto entity : m_entitiesToBeReused) {
+        if (m_isEntityRecycled[entity.GetId()]) {
+            continue;
+        }
+        for (auto& system : m_systems) {
+            if (system.second->ActivateEntity(entity)) {
+                system.second->OnEntityActivated(entity);
+            }
+        }
+    }
+    m_entitiesToBeReused.clear();
+
     // Processing the entities that are waiting to be killed from the
     // active systems
     for (auto entity : m_entitiesToBeKilled) {
         const int entityId = entity.GetId();
         RemoveEntityFromSystems(entity);
+        for (std::size_t id = 0; id < m_numComponents.size(); id++) {
+            m_numComponents[id] -= m_entityComponentSignatures[entityId][id];
+        }
         m_entityComponentSignatures[entityId].reset();
 
         // Make the entity id available to be reused
@@ -176,3 +335,59 @@ void Registry::Update() {
     }
     m_entitiesToBeKilled.clear();
 }
+
+void Registry::GetPoolStats(std::vector<PoolStats>& stats) const {
+    std::size_t numStats = 0;
+    for (std::size_t id = 0; id < m_componentPools.size(); id++) {
+        const auto& pool = m_componentPools[id];
+        if (!pool) {
+            continue;
+        }
+        if (numStats == stats.size()) {
+            stats.emplace_back();
+        }
+        PoolStats& stat = stats[numStats++];
+        if (stat.name != pool->name) {
+            stat.name = pool->name;
+        }
+        stat.numSlots = pool->GetSize();
+        stat.capacity = pool->GetCapacity();
+        stat.numLive = m_numComponents[id];
+        stat.numBytes = pool->GetCapacity() * pool->GetElementSize();
+    }
+    stats.resize(numStats);
+}
+
+void Registry::GetSystemStats(std::vector<SystemStats>& stats) const {
+    stats.resize(m_systemsByName.size());
+    auto stat = stats.begin();
+    for (const auto& system : m_systemsByName) {
+        if (stat->name != system.first) {
+            stat->name = system.first;
+        }
+        stat->numEntities = system.second->GetNumEntities();
+        ++stat;
+    }
+}
+
+const std::string& GetTypeName(const std::type_index& type) {
+    static std::mutex                                       s_mutex;
+    static std::unordered_map<std::type_index, std::string> s_names;
+
+    std::lock_guard<std::mutex> lock(s_mutex);
+    auto                        name = s_names.find(type);
+    if (name != s_names.end()) {
+        return name->second;
+    }
+
+    // Demangling allocates, it is only done the first time a type is named
+    int   status = 0;
+    char* demangled =
+        abi::__cxa_demangle(type.name(), nullptr, nullptr, &status);
+    if (status != 0 || !demangled) {
+        return s_names.emplace(type, type.name()).first->second;
+    }
+    name = s_names.emplace(type, demangled).first;
+    std::free(demangled);
+    return name->second;
+}
@@ -4,8 +4,10 @@
 #include "../Logger/Logger.h"
 #include <bitset>
 #include <deque>
+#include <map>
 #include <memory>
 #include <set>
+#include <string>
 #include <typeindex>
 #include <unordered_map>
 #include <vector>
@@ -45,6 +47,10 @@ public:
     Entity(const Entity& entity) = default;
     int  GetId() const;
     void Kill();
+    // Hands the entity back to the pool of its group, see
+    // Registry::RecycleEntity()
+    void Recycle();
+    bool IsRecycled() const;
 
     Entity& operator=(const Entity& other) = default;
     bool    operator==(const Entity& other) const { return id == other.id; }
@@ -73,20 +79,42 @@ public:
 ////////////////////////////////////////////////////////////////////////////////
 // System
 ////////////////////////////////////////////////////////////////////////////////
-// The system processes entities that contain a specific signature
+// The system processes entities that contain a specific signature. Recycled
+// entities stay in the system but are left out of its entities until they
+// are reused.
 ////////////////////////////////////////////////////////////////////////////////
 class System {
 private:
     Signature           m_componentSignature;
+    // The active entities first, then the recycled ones
     std::vector<Entity> m_entities;
+    int                 m_numActive = 0;
+    // Position of every entity in m_entities, -1 for the entities not in the
+    // system [Vector index = entity id]
+    std::vector<int>    m_entityIndices;
+
+    int  GetEntityIndex(Entity entity) const;
+    void SwapEntities(int first, int second);
 
 public:
     System() = default;
-    ~System() = default;
+    virtual ~System() = default;
 
     void                AddEntityToSystem(Entity entity);
-    void                RemoveEntityFromSystem(Entity entity);
+    // Returns whether the entity was one of the active entities
+    bool                RemoveEntityFromSystem(Entity entity);
+    // Moves an entity of the system between the active and the recycled
+    // entities, in constant time. Returns whether the entity was moved.
+    bool                ActivateEntity(Entity entity);
+    bool                DeactivateEntity(Entity entity);
+    bool                IsEntityActive(Entity entity) const;
+    // Called by the registry when an entity joins the active entities, added
+    // or reused from its pool, and when it leaves them, recycled or killed
+    virtual void        OnEntityActivated(Entity entity) {}
+    virtual void        OnEntityDeactivated(Entity entity) {}
+    // The active entities
     std::vector<Entity> GetSystemEntities() const;
+    int                 GetNumEntities() const { return m_numActive; }
     const Signature&    GetComponentSignature() const;
 
     // Defines the component type that entities must have to be considered by
@@ -102,7 +130,13 @@ public:
 ////////////////////////////////////////////////////////////////////////////////
 class IPool {
 public:
+    // Readable name of the component type
+    std::string name;
+
     virtual ~IPool() {}
+    virtual int         GetSize() const = 0;
+    virtual int         GetCapacity() const = 0;
+    virtual std::size_t GetElementSize() const = 0;
 };
 
 template <typename T>
@@ -115,15 +149,37 @@ public:
 
     virtual ~Pool() = default;
 
-    bool isEmpty() const { return m_data.empty(); }
-    int  GetSize() const { return m_data.size(); }
-    void Resize(int n) { m_data.resize(n); }
-    void Clear() { m_data.clear(); }
-    void Add(T object) { m_data.push_back(object); }
-    void Set(int index, T object) { m_data[index] = object; }
-    T&   Get(int index) { return static_cast<T&>(m_data[index]); }
-    T&   operator[](unsigned int index) { return m_data[index]; }
+    bool        isEmpty() const { return m_data.empty(); }
+    int         GetSize() const override { return m_data.size(); }
+    int         GetCapacity() const override { return m_data.capacity(); }
+    std::size_t GetElementSize() const override { return sizeof(T); }
+    void        Resize(int n) { m_data.resize(n); }
+    void        Clear() { m_data.clear(); }
+    void        Add(T object) { m_data.push_back(object); }
+    void        Set(int index, T object) { m_data[index] = object; }
+    T&          Get(int index) { return static_cast<T&>(m_data[index]); }
+    T&          operator[](unsigned int index) { return m_data[index]; }
+};
+
+// Demangled name of a type, for statistics and debug output. Each type is
+// demangled once, the name stays valid for the lifetime of the program.
+const std::string& GetTypeName(const std::type_index& type);
+
+// Memory held by a component pool. Slots of entities without the component
+// are dead weight, the pool is indexed by entity id.
+struct PoolStats {
+    std::string name;
+    int         numSlots;
+    int         capacity;
+    int         numLive;
+    std::size_t numBytes;
 };
+
+struct SystemStats {
+    std::string name;
+    int         numEntities;
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 // Registry
 ////////////////////////////////////////////////////////////////////////////////
@@ -143,9 +199,16 @@ private:
     // turned "on" for a given entity [Vector index = entity id]
     std::vector<Signature> m_entityComponentSignatures;
 
+    // Number of entities having each component [Vector index = component
+    // type id]
+    std::vector<int> m_numComponents;
+
     // Map of active systems
     // [Map key = system type id]
     std::unordered_map<std::type_index, std::shared_ptr<System>> m_systems;
+    // The same systems in the order of their names, for the statistics
+    // [Map key = system type name]
+    std::map<std::string, std::shared_ptr<System>> m_systemsByName;
 
     // Set of entities that are flagged to be added or removed in the next
     // registry Update()
@@ -163,6 +226,15 @@ private:
     // List of available free entity ids that were previously removed
     std::deque<int> m_freeIds;
 
+    // Entity pooling, recycled entities keep their components, group and
+    // systems and wait in the pool of their group to be reused
+    // [Vector index = entity id]
+    std::vector<bool>                                    m_isEntityRecycled;
+    std::unordered_map<std::string, std::vector<Entity>> m_recycledPerGroup;
+    int                                                  m_numRecycled = 0;
+    // Reused entities rejoin their systems in the next registry Update()
+    std::vector<Entity> m_entitiesToBeReused;
+
 public:
     Registry() { Logger::Log("Registry constructor called"); }
     ~Registry() { Logger::Log("Registry destructor called"); }
@@ -175,6 +247,15 @@ public:
     Entity CreateEntity();
     void   KillEntity(Entity entity);
 
+    // Entity pooling for short lived entities such as projectiles. Instead
+    // of being killed an entity in a group is recycled: its systems skip it
+    // at once, and CreatePooledEntity() later hands it out again with its
+    // components, group and system membership as they were, for the caller
+    // to overwrite the components. An entity in no group is killed.
+    Entity CreatePooledEntity(const std::string& group);
+    void   RecycleEntity(Entity entity);
+    bool   IsEntityRecycled(Entity entity) const;
+
     // Tag management
     void   TagEntity(Entity entity, const std::string& tag);
     bool   EntityHasTag(Entity entity, const std::string& tag) const;
@@ -186,6 +267,8 @@ public:
     bool EntityBelongsToGroup(Entity entity, const std::string& group) const;
     void RemoveEntityGroup(Entity entity);
     std::vector<Entity> GetEntitiesByGroup(const std::string& group) const;
+    // Empty if the entity is in no group
+    std::string GetEntityGroup(Entity entity) const;
 
     // Component management
     template <typename TComponent, typename... TArgs>
@@ -210,6 +293,18 @@ public:
     // Add and remove entities from their systems
     void AddEntityToSystems(Entity entity);
     void RemoveEntityFromSystems(Entity entity);
+
+    // Statistics
+    int GetNumLiveEntities() const {
+        return m_numEntities - static_cast<int>(m_freeIds.size());
+    }
+    int  GetNumPendingAdds() const { return m_entitiesToBeAdded.size(); }
+    int  GetNumPendingKills() const { return m_entitiesToBeKilled.size(); }
+    int  GetNumRecycledEntities() const { return m_numRecycled; }
+    // Fill the list in place, the names are only copied again when the set
+    // of pools or systems changed since the list was last filled
+    void GetPoolStats(std::vector<PoolStats>& stats) const;
+    void GetSystemStats(std::vector<SystemStats>& stats) const;
 };
 
 template <typename TComponent>
@@ -224,12 +319,14 @@ void Registry::AddSystem(TArgs&&... args) {
         std::make_shared<TSystem>(std::forward<TArgs>(args)...);
     m_systems.insert(
         std::make_pair(std::type_index(typeid(TSystem)), newSystem));
+    m_systemsByName[GetTypeName(typeid(TSystem))] = newSystem;
 }
 
 template <typename TSystem>
 void Registry::RemoveSystem() {
     auto system = m_systems.find(std::type_index(typeid(TSystem)));
     m_systems.erase(system);
+    m_systemsByName.erase(GetTypeName(typeid(TSystem)));
 }
 
 template <typename TSystem>
@@ -255,7 +352,9 @@ void Registry::AddComponent(Entity entity, TArgs&&... args) {
     if (!m_componentPools[componentId]) {
         std::shared_ptr<Pool<TComponent>> newComponentPool(
             new Pool<TComponent>());
+        newComponentPool->name = GetTypeName(typeid(TComponent));
         m_componentPools[componentId] = newComponentPool;
+        m_numComponents.resize(m_componentPools.size(), 0);
     }
 
     std::shared_ptr<Pool<TComponent>> componentPool =
@@ -270,20 +369,26 @@ void Registry::AddComponent(Entity entity, TArgs&&... args) {
 
     componentPool->Set(entityId, newComponent);
 
+    if (!m_entityComponentSignatures[entityId].test(componentId)) {
+        m_numComponents[componentId]++;
+    }
     m_entityComponentSignatures[entityId].set(componentId);
 
-    Logger::Log("Component id = " + std::to_string(componentId) +
-                " was added to entity id " + std::to_string(entityId));
+    LOG_FORMAT(LOG_DEBUG, "Component id = {} was added to entity id {}",
+               componentId, entityId);
 }
 
 template <typename TComponent>
 void Registry::RemoveComponent(Entity entity) {
     const auto componentId = Component<TComponent>::GetId();
     const auto entityId = entity.GetId();
+    if (m_entityComponentSignatures[entityId].test(componentId)) {
+        m_numComponents[componentId]--;
+    }
     m_entityComponentSignatures[entityId].set(componentId, false);
 
-    Logger::Log("Component id = " + std::to_string(componentId) +
-                " was removed from entity id " + std::to_string(entityId));
+    LOG_FORMAT(LOG_DEBUG, "Component id = {} was removed from entity id {}",
+               componentId, entityId);
 }
 
 template <typename TComponent>
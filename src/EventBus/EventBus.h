@@ -3,11 +3,14 @@
 
 #include "../Events/Event.h"
 #include "../Logger/Logger.h"
+#include "../Profiler/Profiler.h"
 #include <functional>
 #include <list>
 #include <map>
 #include <memory>
 #include <typeindex>
+#include <utility>
+#include <vector>
 
 class IEventCallback {
 private:
@@ -42,17 +45,36 @@ public:
 
 using HandlerList = std::list<std::unique_ptr<IEventCallback>>;
 
+// An event type and the times it was emitted
+using EmittedCount = std::pair<std::type_index, int>;
+
+struct EventSubscribers {
+    std::unique_ptr<HandlerList> handlers;
+    // Events emitted since the last Reset(), counted in the entry the emit
+    // looks up anyway
+    int                          numEmitted = 0;
+};
+
 class EventBus {
 private:
-    std::map<std::type_index, std::unique_ptr<HandlerList>> m_subscribers;
+    std::map<std::type_index, EventSubscribers> m_subscribers;
 
 public:
     EventBus() { Logger::Log("EventBus constructor called!"); }
     ~EventBus() { Logger::Log("EventBus destructor called!"); }
 
-    // Clears the subscriber list
-    void Reset() {
-        m_subscribers.clear();
+    // Clears the subscriber list and the emitted event counts
+    void Reset() { m_subscribers.clear(); }
+
+    // The event types emitted since the last Reset() and how many times
+    void GetNumEmitted(std::vector<EmittedCount>& numEmitted) const {
+        numEmitted.clear();
+        for (const auto& subscribers : m_subscribers) {
+            if (subscribers.second.numEmitted > 0) {
+                numEmitted.emplace_back(subscribers.first,
+                                        subscribers.second.numEmitted);
+            }
+        }
     }
 
     // Example: eventBus->SubscribeToEvent<CollisionEvent>(this,
@@ -60,18 +82,22 @@ public:
     template <typename TEvent, typename TOwner>
     void SubscribeToEvent(TOwner* ownerInstance,
                           void (TOwner::*callbackFunction)(TEvent&)) {
-        if (!m_subscribers[typeid(TEvent)].get()) {
-            m_subscribers[typeid(TEvent)] = std::make_unique<HandlerList>();
+        auto& handlers = m_subscribers[typeid(TEvent)].handlers;
+        if (!handlers.get()) {
+            handlers = std::make_unique<HandlerList>();
         }
         auto subscriber = std::make_unique<EventCallback<TOwner, TEvent>>(
             ownerInstance, callbackFunction);
-        m_subscribers[typeid(TEvent)]->push_back(std::move(subscriber));
+        handlers->push_back(std::move(subscriber));
     }
 
     // Example: eventBus->EmitEvent<CollisionEvent>(player, enemy);
     template <typename TEvent, typename... TArgs>
     void EmitEvent(TArgs&&... args) {
-        auto handlers = m_subscribers[typeid(TEvent)].get();
+        PROFILE_ZONE("EventBus::EmitEvent");
+        auto& subscribers = m_subscribers[typeid(TEvent)];
+        subscribers.numEmitted++;
+        auto handlers = subscribers.handlers.get();
         if (handlers) {
             for (auto it = handlers->begin(); it != handlers->end(); it++) {
                 auto   handler = it->get();
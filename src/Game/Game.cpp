@@ -7,11 +7,20 @@
 #include "../Components/ProjectileEmitterComponent.h"
 #include "../Components/RigidBodyComponent.h"
 #include "../Components/SpriteComponent.h"
+#include "../Components/TextLabelComponent.h"
+#include "../Components/TilemapComponent.h"
 #include "../Components/TransformComponent.h"
 #include "../ECS/ECS.h"
 #include "../Events/KeyPressedEvent.h"
 #include "../Logger/Logger.h"
+#include "../Profiler/Profiler.h"
+#include "../Renderer/CpuRenderBackend.h"
+#include "../Renderer/NullRenderBackend.h"
+#include "../Renderer/SdlRenderBackend.h"
+#include "../Renderer/SoftwareRenderBackend.h"
+#include "../Scripting/LevelLoader.h"
 #include "../Systems/AnimationSystem.h"
+#include "../Systems/AssetReferenceSystem.h"
 #include "../Systems/CameraMovementSystem.h"
 #include "../Systems/CollisionSystem.h"
 #include "../Systems/DamageSystem.h"
@@ -21,85 +30,232 @@
 #include "../Systems/ProjectileLifecycleSystem.h"
 #include "../Systems/RenderColliderSystem.h"
 #include "../Systems/RenderSystem.h"
+#include "../Systems/RenderTextSystem.h"
+#include "../Systems/ScriptSystem.h"
+#include "../Systems/TileCollisionSystem.h"
+#include "../Systems/WorldStreamingSystem.h"
 #include "SDL_video.h"
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_image.h>
+#include <SDL2/SDL_ttf.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
 #include <fstream>
 #include <glm/glm.hpp>
 #include <iostream>
+#include <thread>
 
 int Game::s_windowWidth;
 int Game::s_windowHeight;
 int Game::s_mapWidth;
 int Game::s_mapHeight;
 
+// The water tiles of the jungle tileset block movement. The Makefile bakes
+// the same list into the converted map, it is applied to the text map here.
+static const std::uint16_t JUNGLE_SOLID_TILES[] = {10, 11, 12};
+
+static const char* UPDATE_STEP_NAMES[NUM_UPDATE_STEPS] = {
+    "events",
+    "assets",
+    "timers",
+    "registry",
+    "previous positions",
+    "world streaming",
+    "scripts",
+    "movement",
+    "tile collision",
+    "animation",
+    "collision",
+    "camera",
+    "projectile emit",
+    "projectile lifecycle",
+    "audio",
+};
+
 Game::Game() {
     m_isRunning = false;
     m_isDebug = false;
+    m_isMetricsOverlay = false;
     m_registry = std::make_unique<Registry>();
+    m_timers = std::make_unique<TimerWheel>();
+    m_metrics = std::make_unique<Metrics>();
     m_assetStore = std::make_unique<AssetStore>();
+    m_audioMixer = std::make_unique<AudioMixer>();
+    m_scriptEngine = std::make_unique<ScriptEngine>();
     m_eventBus = std::make_unique<EventBus>();
     Logger::Log("Game constructor called!");
 }
 
 Game::~Game() { Logger::Log("Game destructor called!"); }
 
-void Game::Initialize() {
-    if (SDL_Init(SDL_INIT_EVERYTHING) != 0) {
+void Game::Initialize(const GameOptions& options) {
+    m_options = options;
+    Logger::SetLevel(options.logLevel);
+
+    // A replay only plays out the same at the tick rate and on the level it
+    // was recorded with
+    if (!m_options.replayPath.empty()) {
+        m_recording = std::make_unique<InputRecording>();
+        if (!m_recording->Load(m_options.replayPath)) {
+            return;
+        }
+        if (m_recording->GetNumTicks() == 0) {
+            Logger::Err("Input recording " + m_options.replayPath +
+                        " has no ticks to replay");
+            return;
+        }
+        m_isReplaying = true;
+        m_options.tickRate = m_recording->GetTickRate();
+        m_options.level = m_recording->GetLevel();
+        m_options.hashInterval = m_recording->GetHashInterval();
+        m_options.maxTicks = m_recording->GetNumTicks();
+        m_replayTickTimes.reserve(m_recording->GetNumTicks());
+    }
+
+    // Headless backends must not touch the video subsystem, there may be no
+    // display at all. Their sound goes to SDL's dummy driver, mixed as usual
+    // but never played.
+    Uint32 sdlFlags = SDL_INIT_EVERYTHING;
+    if (options.isHeadless) {
+        sdlFlags = SDL_INIT_TIMER | SDL_INIT_EVENTS;
+    } else if (options.renderBackend != RENDER_BACKEND_SDL) {
+        sdlFlags = SDL_INIT_TIMER | SDL_INIT_EVENTS | SDL_INIT_AUDIO;
+        SDL_setenv("SDL_AUDIODRIVER", "dummy", 1);
+    }
+    if (SDL_Init(sdlFlags) != 0) {
         Logger::Err("Error initializing SDL.");
         return;
     }
+    if (!options.isHeadless && TTF_Init() != 0) {
+        Logger::Err("Error initializing SDL TTF.");
+        return;
+    }
+    // The game still runs without sound when there is no audio device,
+    // headless never opens one
+    if (!options.isHeadless) {
+        m_audioMixer->Initialize();
+    }
+    if (!m_scriptEngine->Initialize()) {
+        return;
+    }
+    m_assetStore->SetHeadless(options.isHeadless);
+    m_assetStore->SetMemoryBudget(static_cast<std::size_t>(
+                                      options.assetBudgetMb) *
+                                  1024 * 1024);
 
-    SDL_DisplayMode displayMode;
-    SDL_GetCurrentDisplayMode(0, &displayMode);
     s_windowWidth = 800;
     s_windowHeight = 600;
 
-    m_window =
-        SDL_CreateWindow(NULL, SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED,
-                         s_windowWidth, s_windowHeight, SDL_WINDOW_BORDERLESS);
-    if (!m_window) {
-        Logger::Err("Error creating SDL window.");
-        return;
-    }
+    // Headless there is nothing to render to, the window size is only the
+    // size of the camera view
+    if (!options.isHeadless) {
+        switch (options.renderBackend) {
+        case RENDER_BACKEND_SDL:
+            m_renderer = std::make_unique<SdlRenderBackend>();
+            break;
+        case RENDER_BACKEND_SOFTWARE:
+            m_renderer = std::make_unique<SoftwareRenderBackend>(
+                options.captureDirectory);
+            break;
+        case RENDER_BACKEND_CPU:
+            m_renderer =
+                std::make_unique<CpuRenderBackend>(options.captureDirectory);
+            break;
+        case RENDER_BACKEND_NULL:
+            m_renderer = std::make_unique<NullRenderBackend>();
+            break;
+        }
 
-    m_renderer = SDL_CreateRenderer(m_window, -1, 0);
-    if (!m_renderer) {
-        Logger::Err("Error creating SDL renderer.");
-        return;
+        if (!m_renderer->Initialize(s_windowWidth, s_windowHeight)) {
+            return;
+        }
     }
-    SDL_SetWindowFullscreen(m_window, SDL_WINDOW_FULLSCREEN_DESKTOP);
-    SDL_RenderSetLogicalSize(m_renderer, s_windowWidth, s_windowHeight);
 
     // Initialize the camera view with the entire screen area
     m_camera = {0, 0, s_windowWidth, s_windowHeight};
+    m_previousCamera = m_camera;
+
+    if (m_options.tickRate < 1) {
+        m_options.tickRate = 1;
+    }
+    if (m_options.maxCatchUpSteps < 1) {
+        m_options.maxCatchUpSteps = 1;
+    }
+    if (m_options.hashInterval < 1) {
+        m_options.hashInterval = 1;
+    }
+    m_tickDuration = SDL_GetPerformanceFrequency() / m_options.tickRate;
+    m_deltaTime = 1.0 / m_options.tickRate;
+
+    if (!m_isReplaying && !m_options.recordPath.empty()) {
+        m_recording = std::make_unique<InputRecording>();
+        m_recording->Start(m_options.tickRate, m_options.level,
+                           m_options.hashInterval);
+    }
+
+    if (m_options.isPerfCounters) {
+        m_perfCounters = std::make_unique<PerfCounters>();
+    }
+
+    // The game runs on without the endpoint when the port is taken
+    if (m_options.metricsPort > 0 || !m_options.metricsSocket.empty()) {
+        m_exporter = std::make_unique<MetricsExporter>();
+        if (!m_exporter->Start(m_options.metricsPort,
+                               m_options.metricsSocket)) {
+            m_exporter.reset();
+        }
+    }
 
     m_isRunning = true;
 }
 
 void Game::ProcessInput() {
+    PROFILE_ZONE("Game::ProcessInput");
     SDL_Event sdlEvent;
     while (SDL_PollEvent(&sdlEvent)) {
         switch (sdlEvent.type) {
         case SDL_QUIT:
             m_isRunning = false;
             break;
-        case SDL_KEYDOWN:
-            m_eventBus->EmitEvent<KeyPressedEvent>(sdlEvent.key.keysym.sym);
+        case SDL_RENDER_TARGETS_RESET:
+        case SDL_RENDER_DEVICE_RESET:
+            // The baked tile chunks are gone, bake them again on next draw
+            if (m_tileLayer) {
+                m_tileLayer->Invalidate();
+            }
+            break;
+        case SDL_KEYDOWN: {
+            // The simulation turns the keys into events on its next tick
+            std::lock_guard<std::mutex> lock(m_keysMutex);
+            m_pressedKeys.push_back(sdlEvent.key.keysym.sym);
 
             if (sdlEvent.key.keysym.sym == SDLK_ESCAPE) {
                 m_isRunning = false;
             }
             if (sdlEvent.key.keysym.sym == SDLK_o) {
-                m_isDebug = !m_isDebug;
+                m_isDebug = !m_isDebug.load();
             }
+            if (sdlEvent.key.keysym.sym == SDLK_m) {
+                m_isMetricsOverlay = !m_isMetricsOverlay.load();
+            }
+#ifdef ENABLE_PROFILER
+            // Whatever is still in the profiler buffers, the last seconds
+            if (sdlEvent.key.keysym.sym == SDLK_p) {
+                Profiler::WriteChromeTrace(m_options.tracePath);
+                Profiler::LogSummary();
+            }
+#endif
             break;
         }
+        }
     }
 }
 
 void Game::LoadLevel(int level) {
+    PROFILE_ZONE("Game::LoadLevel");
     // Add the sytems that need to be processed in our game
+    m_registry->AddSystem<AssetReferenceSystem>(*m_assetStore);
     m_registry->AddSystem<MovementSystem>();
     m_registry->AddSystem<RenderSystem>();
     m_registry->AddSystem<AnimationSystem>();
@@ -108,56 +264,105 @@ void Game::LoadLevel(int level) {
     m_registry->AddSystem<DamageSystem>();
     m_registry->AddSystem<KeyboardControlSystem>();
     m_registry->AddSystem<CameraMovementSystem>();
-    m_registry->AddSystem<ProjectileEmitSystem>();
-    m_registry->AddSystem<ProjectileLifecycleSystem>();
-
-    // Adding assets to the asset store
-    m_assetStore->AddTexture(m_renderer, "tank-image",
-                             "./assets/images/tank-panther-right.png");
-    m_assetStore->AddTexture(m_renderer, "truck-image",
-                             "./assets/images/truck-ford-right.png");
-    m_assetStore->AddTexture(m_renderer, "chopper-image",
-                             "./assets/images/chopper-spritesheet.png");
-    m_assetStore->AddTexture(m_renderer, "radar-image",
-                             "./assets/images/radar.png");
-    m_assetStore->AddTexture(m_renderer, "bullet-image",
-                             "./assets/images/bullet.png");
-    m_assetStore->AddTexture(m_renderer, "tilemap-image",
-                             "./assets/tilemaps/jungle.png");
-
-    // Load the tilemap
-    int    tileSize = 32;
-    double tileScale = 2.0;
-    int    mapNumCols = 25;
-    int    mapNumRows = 20;
-
-    std::fstream mapFile;
-    mapFile.open("./assets/tilemaps/jungle.map");
-
-    for (int y = 0; y < mapNumRows; y++) {
-        for (int x = 0; x < mapNumCols; x++) {
-            char ch;
-            mapFile.get(ch);
-            int srcRectY = std::atoi(&ch) * tileSize;
-            mapFile.get(ch);
-            int srcRectX = std::atoi(&ch) * tileSize;
-            mapFile.ignore();
-
-            Entity tile = m_registry->CreateEntity();
-            tile.Group("tiles");
-            tile.AddComponent<TransformComponent>(
-                glm::vec2(x * (tileScale * tileSize),
-                          y * (tileScale * tileSize)),
-                glm::vec2(tileScale, tileScale), 0.0);
-            tile.AddComponent<SpriteComponent>("tilemap-image", tileSize,
-                                               tileSize, 0, false, srcRectX,
-                                               srcRectY);
+    m_registry->AddSystem<ProjectileEmitSystem>(*m_timers);
+    m_registry->AddSystem<ProjectileLifecycleSystem>(*m_timers);
+    m_registry->AddSystem<RenderTextSystem>();
+    m_registry->AddSystem<TileCollisionSystem>();
+    m_registry->AddSystem<WorldStreamingSystem>();
+    m_registry->AddSystem<ScriptSystem>();
+
+    Uint64 loadStart = SDL_GetPerformanceCounter();
+
+    // Images in the archive are used as they are mapped, without decoding
+    if (!m_options.assetArchive.empty()) {
+        m_assetStore->OpenArchive(m_options.assetArchive);
+    }
+
+    // Adding assets to the asset store, the returned handles are what the
+    // sprites store. The images are decoded in parallel in the background.
+    // The level script refers to its assets by id.
+    TextureHandle chopperTexture = m_assetStore->AddTextureAsync(
+        "chopper-image", "./assets/images/chopper-spritesheet.png");
+    TextureHandle radarTexture = m_assetStore->AddTextureAsync(
+        "radar-image", "./assets/images/radar.png");
+    TextureHandle bulletTexture = m_assetStore->AddTextureAsync(
+        "bullet-image", "./assets/images/bullet.png");
+    TextureHandle tilemapTexture = m_assetStore->AddTextureAsync(
+        "tilemap-image", "./assets/tilemaps/jungle.png");
+    // The metrics overlay keeps the reference the font is added with
+    FontHandle charriotFont = m_assetStore->AddFont(
+        "charriot-font", "./assets/fonts/charriot.ttf", 14);
+    m_overlayFont = charriotFont;
+    SoundHandle shotSound =
+        m_assetStore->AddSound("shot-sound", "./assets/sounds/shot.wav");
+    m_audioMixer->SetSoundLimit(shotSound, 3);
+
+    // Pack the level images into atlas pages so most sprites share a texture
+    // and the renderer can batch them. The player, the radar, the bullets and
+    // the map are always in use, the images only the streamed entities use
+    // get pages of their own that can be evicted while they are streamed out.
+    if (m_renderer) {
+        m_assetStore->BuildTextureAtlas(*m_renderer);
+    }
+    TextureHandle tankTexture = m_assetStore->AddTextureAsync(
+        "tank-image", "./assets/images/tank-panther-right.png");
+    TextureHandle truckTexture = m_assetStore->AddTextureAsync(
+        "truck-image", "./assets/images/truck-ford-right.png");
+    if (m_renderer) {
+        m_assetStore->BuildTextureAtlas(*m_renderer);
+    }
+
+    double loadMs = (SDL_GetPerformanceCounter() - loadStart) * 1000.0 /
+                    SDL_GetPerformanceFrequency();
+    Logger::Log("Level " + std::to_string(level) + " textures loaded in " +
+                std::to_string(loadMs) + " ms");
+    if (m_assetStore->GetArchive().IsOpen()) {
+        const AssetArchive& archive = m_assetStore->GetArchive();
+        Logger::Log("Asset archive " +
+                    std::to_string(archive.GetMappedBytes() / 1024) +
+                    " KB mapped, " +
+                    std::to_string(archive.GetResidentBytes() / 1024) +
+                    " KB resident");
+    }
+
+    // The level map is mapped as it is when it was converted with
+    // tilemapconv, the text map is parsed otherwise
+    const double tileScale = 2.0;
+    auto         tilemap = std::make_shared<Tilemap>();
+    if (!tilemap->Load("./assets/tilemaps/jungle.tmap")) {
+        const int tileSize = 32;
+        const int tilesetCols =
+            m_assetStore->GetTextureRegion(tilemapTexture).rect.w / tileSize;
+        if (!tilemap->LoadText("./assets/tilemaps/jungle.map", tileSize,
+                               tilesetCols)) {
+            tilemap->Create(1, 1, tileSize);
+        }
+        for (auto tile : JUNGLE_SOLID_TILES) {
+            tilemap->SetTileFlags(tile, TILE_FLAG_SOLID);
         }
     }
-    mapFile.close();
+    Logger::Log("Level " + std::to_string(level) + " map is " +
+                std::to_string(tilemap->GetNumCols()) + "x" +
+                std::to_string(tilemap->GetNumRows()) + " tiles, " +
+                std::to_string(tilemap->GetNumBytes() / 1024) + " KB");
 
-    s_mapWidth = mapNumCols * tileSize * tileScale;
-    s_mapHeight = mapNumRows * tileSize * tileScale;
+    Entity map = m_registry->CreateEntity();
+    map.Tag("tilemap");
+    map.AddComponent<TilemapComponent>(tilemap, tileScale, tilemapTexture);
+
+    // Chunks of the map are baked into textures the first time they are
+    // seen, the ones under the camera right away
+    if (m_renderer) {
+        m_tileLayer = std::make_unique<TileLayer>(*m_renderer, tilemap,
+                                                  tileScale, tilemapTexture);
+        m_tileLayer->Bake(m_assetStore->GetTextureRegion(tilemapTexture),
+                          m_camera);
+    }
+
+    const int tileWorldSize =
+        static_cast<int>(tilemap->GetTileSize() * tileScale);
+    s_mapWidth = tilemap->GetNumCols() * tileWorldSize;
+    s_mapHeight = tilemap->GetNumRows() * tileWorldSize;
 
     // Create an entity
     Entity chopper = m_registry->CreateEntity();
@@ -166,7 +371,7 @@ void Game::LoadLevel(int level) {
     chopper.AddComponent<TransformComponent>(glm::vec2(10.0, 100.0),
                                              glm::vec2(1.0, 1.0), 0.0);
     chopper.AddComponent<RigidBodyComponent>(glm::vec2(0.0, 0.0));
-    chopper.AddComponent<SpriteComponent>("chopper-image", 32, 32, 1);
+    chopper.AddComponent<SpriteComponent>(chopperTexture, 32, 32, 1);
     chopper.AddComponent<AnimationComponent>(2, 10, true);
     chopper.AddComponent<BoxColliderComponent>(32, 32);
     chopper.AddComponent<KeyboardControlledComponent>(
@@ -174,54 +379,238 @@ void Game::LoadLevel(int level) {
         glm::vec2(-120, 0));
     chopper.AddComponent<HealthComponent>(100);
     chopper.AddComponent<ProjectileEmitterComponent>(glm::vec2(150.0, 150.0), 0,
-                                                     10000, 10, true);
+                                                     10000, 10, true,
+                                                     bulletTexture, shotSound);
 
     Entity radar = m_registry->CreateEntity();
     radar.AddComponent<TransformComponent>(
         glm::vec2(s_windowWidth - 80.0, 10.0), glm::vec2(1.0, 1.0), 0.0);
     radar.AddComponent<RigidBodyComponent>(glm::vec2(0.0, 0.0));
-    radar.AddComponent<SpriteComponent>("radar-image", 64, 64, 2, true);
+    radar.AddComponent<SpriteComponent>(radarTexture, 64, 64, 2, true);
     radar.AddComponent<AnimationComponent>(8, 5, true);
 
-    Entity tank = m_registry->CreateEntity();
-    tank.Group("enemies");
-    tank.AddComponent<TransformComponent>(glm::vec2(500.0, 10.0),
-                                          glm::vec2(1.0, 1.0), 0.0);
-    tank.AddComponent<RigidBodyComponent>(glm::vec2(0));
-    tank.AddComponent<SpriteComponent>("tank-image", 32, 32, 1);
-    tank.AddComponent<BoxColliderComponent>(32, 32);
-    tank.AddComponent<ProjectileEmitterComponent>(glm::vec2(100.0, 0.0), 5000,
-                                                  3000, 10, false);
-    tank.AddComponent<HealthComponent>(100);
-
-    Entity truck = m_registry->CreateEntity();
-    truck.Group("enemies");
-    truck.AddComponent<TransformComponent>(glm::vec2(10.0, 10.0),
-                                           glm::vec2(1.0, 1.0), 0.0);
-    truck.AddComponent<RigidBodyComponent>(glm::vec2(0));
-    truck.AddComponent<SpriteComponent>("truck-image", 32, 32, 2);
-    truck.AddComponent<BoxColliderComponent>(32, 32);
-    truck.AddComponent<ProjectileEmitterComponent>(glm::vec2(0.0, 100.0), 2000,
-                                                   5000, 10, false);
-    truck.AddComponent<HealthComponent>(100);
+    // The entities of the level script are streamed, they only exist while
+    // the camera is close to the world cell they stand in
+    auto& worldStreaming = m_registry->GetSystem<WorldStreamingSystem>();
+    const int cellSize = static_cast<int>(
+        tilemap->GetChunkTiles() * tilemap->GetTileSize() * tileScale);
+    worldStreaming.SetWorldSize(s_mapWidth, s_mapHeight, cellSize);
+
+    std::vector<EntityRecord> records;
+    LevelLoader::Load(*m_scriptEngine, *m_assetStore,
+                      "./assets/scripts/Level" + std::to_string(level) +
+                          ".lua",
+                      records);
+    for (const auto& record : records) {
+        worldStreaming.AddEntity(record);
+    }
+
+    Entity    label = m_registry->CreateEntity();
+    SDL_Color green = {0, 255, 0, 255};
+    label.AddComponent<TextLabelComponent>(
+        glm::vec2(s_windowWidth / 2 - 40, 10), "CHOPPER 1.0", charriotFont,
+        green, 3, true);
+
+    // The level entities join their systems and take their own references
+    // to the assets, the level then lets go of the ones it added them with.
+    // The tank and truck page, and the sounds no live entity plays, can then
+    // be evicted while the entities using them are streamed out.
+    m_registry->Update();
+    for (auto texture : {tankTexture, truckTexture, chopperTexture,
+                         radarTexture, bulletTexture, tilemapTexture}) {
+        m_assetStore->ReleaseTexture(texture);
+    }
+    m_assetStore->ReleaseSound(shotSound);
 }
 
-void Game::Setup() { LoadLevel(1); }
+void Game::Setup() { LoadLevel(m_options.level); }
 
-void Game::Update() {
-    // If we are too fast, waste some time until we reach the
-    // MILLISECS_PER_FRAME
-    int timeToWait =
-        MILLISECS_PER_FRAME - (SDL_GetTicks() - m_millisecsPreviousFrame);
-    if (timeToWait > 0 && timeToWait <= MILLISECS_PER_FRAME) {
-        SDL_Delay(timeToWait);
+int Game::GetSimulationTime() const {
+    return static_cast<int>(static_cast<long long>(m_tickCount) * 1000 /
+                            m_options.tickRate);
+}
+
+Uint64 Game::EndUpdateStep(UpdateStep step, Uint64 stepStart) {
+    if (m_perfCounters && m_perfCounters->IsOpen()) {
+        PerfSample sample;
+        m_perfCounters->Read(sample);
+        for (int counter = 0; counter < NUM_PERF_COUNTERS; counter++) {
+            m_updateStepCounters[step].values[counter] +=
+                sample.values[counter] - m_lastPerfSample.values[counter];
+        }
+        m_lastPerfSample = sample;
+        m_updateStepEntities[step] += GetUpdateStepEntities(step);
+    }
+    // Taken after the counters so reading them is charged to the next step's
+    // time only, not to its counters
+    Uint64 now = SDL_GetPerformanceCounter();
+    m_updateStepTicks[step] += now - stepStart;
+    return now;
+}
+
+int Game::GetUpdateStepEntities(UpdateStep step) const {
+    switch (step) {
+    case UPDATE_STEP_TIMERS:
+        return m_timers->GetNumDueTimers();
+    case UPDATE_STEP_REGISTRY:
+        return m_registry->GetNumLiveEntities();
+    case UPDATE_STEP_PREVIOUS_POSITIONS:
+        return m_registry->GetSystem<RenderSystem>().GetNumEntities();
+    case UPDATE_STEP_WORLD_STREAMING:
+        return m_registry->GetSystem<WorldStreamingSystem>().GetNumEntities();
+    case UPDATE_STEP_SCRIPTS:
+        return m_registry->GetSystem<ScriptSystem>().GetNumEntities();
+    case UPDATE_STEP_MOVEMENT:
+        return m_registry->GetSystem<MovementSystem>().GetNumEntities();
+    case UPDATE_STEP_TILE_COLLISION:
+        return m_registry->GetSystem<TileCollisionSystem>().GetNumEntities();
+    case UPDATE_STEP_ANIMATION:
+        return m_registry->GetSystem<AnimationSystem>().GetNumEntities();
+    case UPDATE_STEP_COLLISION:
+        return m_registry->GetSystem<CollisionSystem>().GetNumEntities();
+    case UPDATE_STEP_CAMERA:
+        return m_registry->GetSystem<CameraMovementSystem>().GetNumEntities();
+    case UPDATE_STEP_PROJECTILE_EMIT:
+        return m_registry->GetSystem<ProjectileEmitSystem>().GetNumEntities();
+    case UPDATE_STEP_PROJECTILE_LIFECYCLE:
+        return m_registry->GetSystem<ProjectileLifecycleSystem>()
+            .GetNumEntities();
+    default:
+        return 0;
+    }
+}
+
+std::uint64_t Game::HashState() const {
+    StateHasher hasher;
+    hasher.Add(m_tickCount);
+    hasher.Add(m_registry->GetNumLiveEntities());
+    hasher.Add(m_camera.x);
+    hasher.Add(m_camera.y);
+
+    // Every entity that moves is drawn, their order is the order they were
+    // created in
+    for (auto entity :
+         m_registry->GetSystem<RenderSystem>().GetSystemEntities()) {
+        const auto& transform = entity.GetComponent<TransformComponent>();
+        hasher.Add(entity.GetId());
+        hasher.Add(transform.position.x);
+        hasher.Add(transform.position.y);
+        hasher.Add(transform.rotation);
+        if (entity.HasComponent<RigidBodyComponent>()) {
+            const auto& rigidBody = entity.GetComponent<RigidBodyComponent>();
+            hasher.Add(rigidBody.velocity.x);
+            hasher.Add(rigidBody.velocity.y);
+        }
+        if (entity.HasComponent<HealthComponent>()) {
+            hasher.Add(entity.GetComponent<HealthComponent>().healthPercentage);
+        }
     }
+    return hasher.GetHash();
+}
 
-    // The difference in ticks since the last frame, converted to seconds
-    double deltaTime = (SDL_GetTicks() - m_millisecsPreviousFrame) / 1000.0;
+void Game::RecordStateHash() {
+    PROFILE_ZONE("Game::RecordStateHash");
+    const std::uint64_t hash = HashState();
+    if (!m_isReplaying) {
+        m_recording->AddStateHash(hash);
+        return;
+    }
+
+    m_replayHashes.push_back(hash);
+    const int index = m_tickCount / m_options.hashInterval - 1;
+    if (index >= m_recording->GetNumStateHashes() ||
+        m_recording->GetStateHash(index) == hash) {
+        return;
+    }
+    if (m_numHashMismatches++ == 0) {
+        m_firstMismatchTick = m_tickCount;
+        Logger::Err("Replay diverged from the recording by tick " +
+                    std::to_string(m_tickCount));
+    }
+}
 
-    // Store the dprevious" frame time
-    m_millisecsPreviousFrame = SDL_GetTicks();
+void Game::LogReplay() const {
+    if (!m_options.replayReportPath.empty()) {
+        std::ofstream file(m_options.replayReportPath);
+        if (!file) {
+            Logger::Err("Error creating replay report " +
+                        m_options.replayReportPath);
+        } else {
+            file << "tick,update_us,state_hash,recorded_hash\n";
+            char text[64];
+            for (std::size_t i = 0; i < m_replayTickTimes.size(); i++) {
+                const int tick = i + 1;
+                file << tick << ',' << m_replayTickTimes[i] << ',';
+                const int index = tick / m_options.hashInterval - 1;
+                if (tick % m_options.hashInterval == 0 &&
+                    index < static_cast<int>(m_replayHashes.size())) {
+                    std::snprintf(text, sizeof(text), "%016llx",
+                                  static_cast<unsigned long long>(
+                                      m_replayHashes[index]));
+                    file << text;
+                }
+                file << ',';
+                if (tick % m_options.hashInterval == 0 &&
+                    index < m_recording->GetNumStateHashes()) {
+                    std::snprintf(text, sizeof(text), "%016llx",
+                                  static_cast<unsigned long long>(
+                                      m_recording->GetStateHash(index)));
+                    file << text;
+                }
+                file << '\n';
+            }
+            Logger::Log("Replay report written to " +
+                        m_options.replayReportPath);
+        }
+    }
+
+    if (m_replayTickTimes.empty()) {
+        return;
+    }
+    std::vector<float> tickTimes = m_replayTickTimes;
+    std::sort(tickTimes.begin(), tickTimes.end());
+    double totalUs = 0.0;
+    for (float us : tickTimes) {
+        totalUs += us;
+    }
+    const std::size_t p99 = (tickTimes.size() - 1) * 99 / 100;
+    Logger::Log("Replay: " + std::to_string(tickTimes.size()) + " of " +
+                std::to_string(m_recording->GetNumTicks()) + " ticks, " +
+                std::to_string(totalUs / tickTimes.size()) + " us/tick, " +
+                std::to_string(tickTimes[p99]) + " us p99, " +
+                std::to_string(tickTimes.back()) + " us max");
+
+    // Hashes past the end of the recording have nothing to compare with
+    const std::size_t numCompared =
+        std::min<std::size_t>(m_replayHashes.size(),
+                              m_recording->GetNumStateHashes());
+    if (m_numHashMismatches == 0) {
+        Logger::Log("Replay: all " + std::to_string(numCompared) +
+                    " state hashes match the recording");
+    } else {
+        Logger::Err("Replay: " + std::to_string(m_numHashMismatches) + " of " +
+                    std::to_string(numCompared) +
+                    " state hashes differ from the recording, first at tick " +
+                    std::to_string(m_firstMismatchTick));
+    }
+}
+
+void Game::Update() {
+    PROFILE_ZONE("Game::Update");
+    // Every tick simulates the same amount of time, however long it took to
+    // get here, so the same inputs always play out the same way
+    const double deltaTime = m_deltaTime;
+
+    // The counters count the thread that opens them, the one running the
+    // simulation
+    if (m_perfCounters && m_tickCount == 0) {
+        m_perfCounters->Open();
+    }
+    if (m_perfCounters && m_perfCounters->IsOpen()) {
+        m_perfCounters->Read(m_lastPerfSample);
+    }
+    m_tickStart = SDL_GetPerformanceCounter();
+    Uint64 stepStart = m_tickStart;
 
     // Reset all events handlers for the current frame
     m_eventBus->Reset();
@@ -232,46 +621,590 @@ void Game::Update() {
         m_eventBus);
     m_registry->GetSystem<ProjectileEmitSystem>().SubscribeToEvents(m_eventBus);
 
+    // Emit the keys pressed since the last tick
+    std::vector<SDL_Keycode> pressedKeys;
+    {
+        std::lock_guard<std::mutex> lock(m_keysMutex);
+        pressedKeys.swap(m_pressedKeys);
+    }
+    // Replaying, the keyboard is ignored and the recorded keys are handled on
+    // the tick they were recorded on
+    if (m_isReplaying) {
+        pressedKeys.clear();
+        m_recording->GetKeys(m_tickCount, pressedKeys);
+    } else if (m_recording) {
+        for (auto key : pressedKeys) {
+            m_recording->AddKey(m_tickCount, key);
+        }
+    }
+    for (auto key : pressedKeys) {
+        m_eventBus->EmitEvent<KeyPressedEvent>(key);
+    }
+    stepStart = EndUpdateStep(UPDATE_STEP_EVENTS, stepStart);
+
+    // Textures the render thread finished uploading become drawable, unused
+    // assets are evicted while over budget
+    m_assetStore->Update();
+    stepStart = EndUpdateStep(UPDATE_STEP_ASSETS, stepStart);
+
+    // The emissions and expiries due this tick, the systems handle them in
+    // their steps
+    m_timers->Advance(GetSimulationTime());
+    stepStart = EndUpdateStep(UPDATE_STEP_TIMERS, stepStart);
+
     // Update the registry to process the entities that are waiting to
     // be created/deleted
     m_registry->Update();
+    stepStart = EndUpdateStep(UPDATE_STEP_REGISTRY, stepStart);
+
+    // Where the sprites and the camera were before this tick, the renderer
+    // blends from there to where the tick leaves them
+    m_registry->GetSystem<RenderSystem>().SavePreviousPositions();
+    m_previousCamera = m_camera;
+    stepStart = EndUpdateStep(UPDATE_STEP_PREVIOUS_POSITIONS, stepStart);
+
+    // Load the world cells around the camera, unload the far ones
+    m_registry->GetSystem<WorldStreamingSystem>().Update(m_registry, m_camera);
+    stepStart = EndUpdateStep(UPDATE_STEP_WORLD_STREAMING, stepStart);
 
     // Invoke all the systems that needs to update
+    m_registry->GetSystem<ScriptSystem>().Update(*m_scriptEngine, deltaTime);
+    stepStart = EndUpdateStep(UPDATE_STEP_SCRIPTS, stepStart);
     m_registry->GetSystem<MovementSystem>().Update(deltaTime);
-    m_registry->GetSystem<AnimationSystem>().Update();
+    stepStart = EndUpdateStep(UPDATE_STEP_MOVEMENT, stepStart);
+    m_registry->GetSystem<TileCollisionSystem>().Update(
+        m_registry->GetEntityByTag("tilemap").GetComponent<TilemapComponent>(),
+        deltaTime);
+    stepStart = EndUpdateStep(UPDATE_STEP_TILE_COLLISION, stepStart);
+    m_registry->GetSystem<AnimationSystem>().Update(GetSimulationTime());
+    stepStart = EndUpdateStep(UPDATE_STEP_ANIMATION, stepStart);
     m_registry->GetSystem<CollisionSystem>().Update(m_eventBus);
+    stepStart = EndUpdateStep(UPDATE_STEP_COLLISION, stepStart);
     m_registry->GetSystem<CameraMovementSystem>().Update(m_camera);
-    m_registry->GetSystem<ProjectileEmitSystem>().Update(m_registry);
+    stepStart = EndUpdateStep(UPDATE_STEP_CAMERA, stepStart);
+    m_registry->GetSystem<ProjectileEmitSystem>().Update(
+        m_registry, m_audioMixer, GetSimulationTime());
+    stepStart = EndUpdateStep(UPDATE_STEP_PROJECTILE_EMIT, stepStart);
     m_registry->GetSystem<ProjectileLifecycleSystem>().Update();
+    stepStart = EndUpdateStep(UPDATE_STEP_PROJECTILE_LIFECYCLE, stepStart);
+
+    // Start the sounds requested during the tick, heard from the camera
+    m_audioMixer->Update(*m_assetStore, m_camera);
+    EndUpdateStep(UPDATE_STEP_AUDIO, stepStart);
+
+    if (m_isMetricsOverlay || !m_options.metricsPath.empty()) {
+        SampleMetrics();
+    }
+
+    m_tickCount++;
+    if (m_isReplaying) {
+        m_replayTickTimes.push_back(static_cast<float>(
+            (SDL_GetPerformanceCounter() - m_tickStart) * 1000000.0 /
+            SDL_GetPerformanceFrequency()));
+    }
+    if (m_recording && m_tickCount % m_options.hashInterval == 0) {
+        RecordStateHash();
+    }
+    if (m_exporter) {
+        PublishExporterSnapshot();
+    }
+    if (m_options.maxTicks > 0 && m_tickCount >= m_options.maxTicks) {
+        m_isRunning = false;
+    }
 }
 
-void Game::Render() {
-    SDL_SetRenderDrawColor(m_renderer, 21, 21, 21, 255);
-    SDL_RenderClear(m_renderer);
+void Game::SampleMetrics() {
+    Metrics& metrics = *m_metrics;
 
-    // Invoke all the systems that need to render
-    m_registry->GetSystem<RenderSystem>().Update(m_renderer, m_assetStore,
-                                                 m_camera);
+    metrics.Set("entities.live", m_registry->GetNumLiveEntities());
+    metrics.Set("entities.pending_add", m_registry->GetNumPendingAdds());
+    metrics.Set("entities.pending_kill", m_registry->GetNumPendingKills());
+    metrics.Set("entities.recycled", m_registry->GetNumRecycledEntities());
+    metrics.Set("timers.scheduled", m_timers->GetNumTimers());
+
+    // Pools are indexed by entity id, every slot past the live components is
+    // memory held for nothing
+    m_registry->GetPoolStats(m_poolStats);
+    for (const auto& pool : m_poolStats) {
+        const std::string prefix = "pool." + pool.name;
+        metrics.Set(prefix + ".slots", pool.numSlots);
+        metrics.Set(prefix + ".capacity", pool.capacity);
+        metrics.Set(prefix + ".live", pool.numLive);
+        metrics.Set(prefix + ".bytes", pool.numBytes);
+    }
+
+    m_registry->GetSystemStats(m_systemStats);
+    for (const auto& system : m_systemStats) {
+        metrics.Set("system." + system.name + ".entities",
+                    system.numEntities);
+    }
+
+    m_eventBus->GetNumEmitted(m_numEmitted);
+    for (const auto& emitted : m_numEmitted) {
+        metrics.Set("events." + GetTypeName(emitted.first), emitted.second);
+    }
+
+    const auto& collisionSystem = m_registry->GetSystem<CollisionSystem>();
+    metrics.Set("collision.pairs_tested", collisionSystem.GetNumPairsTested());
+    metrics.Set("collision.hits", collisionSystem.GetNumCollisions());
+
+    metrics.Set("render.draw_calls", m_lastDrawCalls);
+    metrics.Set("render.texture_switches", m_lastTextureSwitches);
+
+    metrics.Set("assets.texture_bytes",
+                m_assetStore->GetMemoryUsage(ASSET_TYPE_TEXTURE));
+    metrics.Set("assets.font_bytes",
+                m_assetStore->GetMemoryUsage(ASSET_TYPE_FONT));
+    metrics.Set("assets.sound_bytes",
+                m_assetStore->GetMemoryUsage(ASSET_TYPE_SOUND));
+
+    metrics.EndFrame();
+}
+
+void Game::PublishExporterSnapshot() {
+    m_eventBus->GetNumEmitted(m_numEmitted);
+    for (const auto& emitted : m_numEmitted) {
+        m_eventTotals[emitted.first] += emitted.second;
+    }
+
+    ExporterSnapshot& snapshot = m_exporter->GetWriteSnapshot();
+    snapshot.numTicks = m_tickCount;
+    snapshot.numDroppedTicks = m_droppedTicks;
+    snapshot.numLiveEntities = m_registry->GetNumLiveEntities();
+    snapshot.numPendingAdds = m_registry->GetNumPendingAdds();
+    snapshot.numPendingKills = m_registry->GetNumPendingKills();
+    snapshot.numRecycledEntities = m_registry->GetNumRecycledEntities();
+    m_registry->GetPoolStats(snapshot.pools);
+    m_registry->GetSystemStats(snapshot.systems);
+    // The names are only copied again when an event type was emitted for
+    // the first time
+    snapshot.eventTotals.resize(m_eventTotals.size());
+    auto eventTotal = snapshot.eventTotals.begin();
+    for (const auto& total : m_eventTotals) {
+        const std::string& name = GetTypeName(total.first);
+        if (eventTotal->first != name) {
+            eventTotal->first = name;
+        }
+        eventTotal->second = total.second;
+        ++eventTotal;
+    }
+    m_exporter->Publish();
+
+    m_exporter->GetTickHistogram().Observe(
+        static_cast<double>(SDL_GetPerformanceCounter() - m_tickStart) /
+        SDL_GetPerformanceFrequency());
+}
+
+void Game::BuildMetricsOverlay(std::vector<SpriteDrawCommand>& commands) {
+    const int lineSkip = m_assetStore->GetGlyphAtlas(m_overlayFont).lineSkip;
+    if (lineSkip <= 0) {
+        return;
+    }
+    const int linesPerColumn =
+        std::max(1, (s_windowHeight - 2 * METRICS_OVERLAY_MARGIN) / lineSkip);
+    const SDL_Color yellow = {255, 255, 0, 255};
+    auto&           renderText = m_registry->GetSystem<RenderTextSystem>();
+
+    // One string per column, laid out and cached like any other text
+    std::string column;
+    int         numLines = 0;
+    int         columnIndex = 0;
+    for (int id = 0; id <= m_metrics->GetNumMetrics(); id++) {
+        if (id < m_metrics->GetNumMetrics()) {
+            char   line[128];
+            double value = m_metrics->GetValue(id);
+            std::snprintf(line, sizeof(line),
+                          value == std::floor(value) ? "%s %.0f\n"
+                                                     : "%s %.3f\n",
+                          m_metrics->GetName(id).c_str(), value);
+            column += line;
+            numLines++;
+        }
+        if (numLines == linesPerColumn ||
+            (id == m_metrics->GetNumMetrics() && numLines > 0)) {
+            SDL_Point position = {
+                METRICS_OVERLAY_MARGIN +
+                    columnIndex * METRICS_OVERLAY_COLUMN_WIDTH,
+                METRICS_OVERLAY_MARGIN};
+            renderText.BuildTextCommands(m_assetStore, m_overlayFont, column,
+                                         position, position, 100, yellow,
+                                         commands);
+            column.clear();
+            numLines = 0;
+            columnIndex++;
+        }
+    }
+}
 
+void Game::PublishSnapshot() {
+    PROFILE_ZONE("Game::PublishSnapshot");
+    // Capture what the render systems would draw, the snapshot is not touched
+    // by the simulation once published
+    RenderSnapshot& snapshot = m_snapshots.GetWriteSnapshot();
+    snapshot.camera = m_camera;
+    snapshot.previousCamera = m_previousCamera;
+    snapshot.simulationStart = m_tickStart;
+    snapshot.simulationTime = m_simulationClock;
+    snapshot.assetFrame = m_assetStore->GetFrame();
+    if (m_tileLayer) {
+        snapshot.tileset =
+            m_assetStore->GetTextureRegion(m_tileLayer->GetTileset());
+    }
+
+    m_registry->GetSystem<RenderSystem>().BuildRenderCommands(
+        m_assetStore, m_camera, m_previousCamera, snapshot.sprites);
+    m_registry->GetSystem<RenderTextSystem>().BuildRenderCommands(
+        m_assetStore, m_camera, m_previousCamera, snapshot.sprites);
+    if (m_isMetricsOverlay) {
+        BuildMetricsOverlay(snapshot.sprites);
+    }
+    RenderSystem::SortRenderCommands(snapshot.sprites);
+
+    snapshot.colliders.clear();
     if (m_isDebug) {
-        m_registry->GetSystem<RenderColliderSystem>().Update(m_renderer,
-                                                             m_camera);
+        m_registry->GetSystem<RenderColliderSystem>().BuildRenderCommands(
+            m_camera, snapshot.colliders);
     }
 
-    SDL_RenderPresent(m_renderer);
+    m_snapshots.Publish();
 }
 
-void Game::Run() {
-    Setup();
+void Game::Render(const RenderSnapshot& snapshot) {
+    PROFILE_ZONE("Game::Render");
+    Uint64 renderStart = SDL_GetPerformanceCounter();
+
+    // Textures loaded in the background go up a few at a time so a burst of
+    // loads never drops a frame
+    m_assetStore->UploadTextures(*m_renderer, TEXTURE_UPLOAD_BUDGET_MS);
+    m_assetStore->DestroyEvictedTextures(*m_renderer, snapshot.assetFrame);
+
+    // The snapshot holds the state before and after its tick, draw it as far
+    // in between as the real time is past the simulation clock
+    double alpha =
+        static_cast<double>(renderStart - snapshot.simulationTime) /
+        m_tickDuration;
+    if (renderStart < snapshot.simulationTime) {
+        alpha = 0.0;
+    } else if (alpha > 1.0) {
+        alpha = 1.0;
+    }
+    SDL_Rect camera = snapshot.camera;
+    camera.x = snapshot.previousCamera.x +
+               static_cast<int>(std::lround(
+                   (snapshot.camera.x - snapshot.previousCamera.x) * alpha));
+    camera.y = snapshot.previousCamera.y +
+               static_cast<int>(std::lround(
+                   (snapshot.camera.y - snapshot.previousCamera.y) * alpha));
+
+    m_renderer->Clear({21, 21, 21, 255});
+
+    // The background tiles go below every sprite
+    m_tileLayer->Render(snapshot.tileset, camera);
+
+    // Invoke all the systems that need to render
+    m_registry->GetSystem<RenderSystem>().Submit(m_renderer, snapshot.sprites,
+                                                 alpha);
+    m_registry->GetSystem<RenderColliderSystem>().Submit(m_renderer,
+                                                         snapshot.colliders);
+
+    m_renderer->Present();
+
+    Uint64 renderEnd = SDL_GetPerformanceCounter();
+    m_renderTicks += renderEnd - renderStart;
+    m_latencyTicks += renderEnd - snapshot.simulationStart;
+    m_drawCalls += m_renderer->GetFrameStats().drawCalls;
+    m_textureSwitches += m_renderer->GetFrameStats().textureSwitches;
+    m_lastDrawCalls = m_renderer->GetFrameStats().drawCalls;
+    m_lastTextureSwitches = m_renderer->GetFrameStats().textureSwitches;
+    m_frameCount++;
+    if (m_exporter) {
+        m_exporter->GetFrameHistogram().Observe(
+            static_cast<double>(renderEnd - renderStart) /
+            SDL_GetPerformanceFrequency());
+    }
+
+    if (m_options.maxFrames > 0 && m_frameCount >= m_options.maxFrames) {
+        m_isRunning = false;
+    }
+}
+
+int Game::RunDueTicks() {
+    Uint64 now = SDL_GetPerformanceCounter();
+    int    numTicks = 0;
+    while (now - m_simulationClock >= m_tickDuration &&
+           numTicks < m_options.maxCatchUpSteps) {
+        Update();
+        m_simulationClock += m_tickDuration;
+        numTicks++;
+    }
+
+    // Too far behind to catch up, running more ticks would only make the
+    // next frame later still. The missing time is never simulated.
+    if (now - m_simulationClock >= m_tickDuration) {
+        Uint64 numDropped = (now - m_simulationClock) / m_tickDuration;
+        m_simulationClock += numDropped * m_tickDuration;
+        m_droppedTicks += numDropped;
+    }
+    return numTicks;
+}
+
+void Game::WaitForNextTick() {
+    Uint64 nextTick = m_simulationClock + m_tickDuration;
+    Uint64 now = SDL_GetPerformanceCounter();
+    if (nextTick > now) {
+        // Rounded up, waking early would only spin once more
+        Uint64 frequency = SDL_GetPerformanceFrequency();
+        SDL_Delay(static_cast<Uint32>(
+            ((nextTick - now) * 1000 + frequency - 1) / frequency));
+    }
+}
+
+void Game::RunSequential() {
+    // The first tick is due right away
+    m_simulationClock = SDL_GetPerformanceCounter() - m_tickDuration;
+
+    const RenderSnapshot* snapshot = nullptr;
+    while (m_isRunning) {
+        ProcessInput();
+        if (RunDueTicks() > 0) {
+            PublishSnapshot();
+            snapshot = m_snapshots.Acquire();
+        }
+        if (snapshot) {
+            Render(*snapshot);
+        }
+        if (!m_options.isUncapped) {
+            WaitForNextTick();
+        }
+    }
+}
+
+void Game::RunPipelined() {
+    // The simulation thread only touches the registry, the event bus and the
+    // snapshot it is writing. Input and rendering stay on the main thread,
+    // SDL wants them on the thread that created the window.
+    m_simulationClock = SDL_GetPerformanceCounter() - m_tickDuration;
+    std::thread simulation([this]() {
+        PROFILE_THREAD("simulation");
+        while (m_isRunning) {
+            if (RunDueTicks() > 0) {
+                PublishSnapshot();
+            }
+            WaitForNextTick();
+        }
+    });
+
+    // Capped, a frame is drawn for every snapshot published. Uncapped, the
+    // newest snapshot is drawn again and again, further into its tick.
+    const int             tickMs = 1000 / m_options.tickRate + 1;
+    const RenderSnapshot* snapshot = nullptr;
+    while (m_isRunning) {
+        ProcessInput();
+        const RenderSnapshot* newest = m_options.isUncapped
+                                           ? m_snapshots.Acquire()
+                                           : m_snapshots.WaitAndAcquire(tickMs);
+        if (newest) {
+            snapshot = newest;
+        } else if (!m_options.isUncapped) {
+            continue;
+        }
+        if (snapshot) {
+            Render(*snapshot);
+        }
+    }
+    simulation.join();
+}
+
+void Game::RunHeadless() {
+    // Nothing waits for the clock, the fixed steps run back to back. Quit
+    // events still come in from signals.
     while (m_isRunning) {
         ProcessInput();
         Update();
-        Render();
+    }
+}
+
+void Game::Run() {
+    // Initialize() failed, there is nothing to render to
+    if (!m_isRunning) {
+        return;
+    }
+    PROFILE_THREAD("main");
+    Setup();
+
+    Uint64 runStart = SDL_GetPerformanceCounter();
+    if (m_options.isHeadless) {
+        RunHeadless();
+    } else if (m_options.isPipelined) {
+        RunPipelined();
+    } else {
+        RunSequential();
+    }
+    m_runTicks = SDL_GetPerformanceCounter() - runStart;
+}
+
+void Game::LogPerfCounters() const {
+    for (int step = 0; step < NUM_UPDATE_STEPS; step++) {
+        const uint64_t* values = m_updateStepCounters[step].values;
+        const bool      hasIpc =
+            m_perfCounters->IsAvailable(PERF_COUNTER_CYCLES) &&
+            m_perfCounters->IsAvailable(PERF_COUNTER_INSTRUCTIONS);
+        std::string line =
+            "Counters " + std::string(UPDATE_STEP_NAMES[step]) + ":";
+        char text[64];
+        if (hasIpc) {
+            const uint64_t cycles = values[PERF_COUNTER_CYCLES];
+            std::snprintf(text, sizeof(text), " %.2f IPC",
+                          cycles > 0 ? static_cast<double>(
+                                           values[PERF_COUNTER_INSTRUCTIONS]) /
+                                           cycles
+                                     : 0.0);
+            line += text;
+        }
+
+        // Per entity for the steps that go through entities, per tick for
+        // the others
+        const uint64_t numEntities = m_updateStepEntities[step];
+        const double   divisor = numEntities > 0 ? numEntities : m_tickCount;
+        std::string    misses;
+        for (int counter = PERF_COUNTER_L1D_MISSES;
+             counter < NUM_PERF_COUNTERS; counter++) {
+            const auto perfCounter = static_cast<PerfCounter>(counter);
+            if (!m_perfCounters->IsAvailable(perfCounter)) {
+                continue;
+            }
+            std::snprintf(text, sizeof(text), "%s%.2f %s",
+                          misses.empty() ? "" : ", ", values[counter] / divisor,
+                          PerfCounters::GetName(perfCounter));
+            misses += text;
+        }
+        if (!misses.empty()) {
+            line += (hasIpc ? ", " : " ") + misses +
+                    (numEntities > 0 ? " per entity" : " per tick");
+        }
+        Logger::Log(line);
     }
 }
 
 void Game::Destroy() {
-    SDL_DestroyRenderer(m_renderer);
-    SDL_DestroyWindow(m_window);
+    if (m_exporter) {
+        m_exporter->Stop();
+    }
+    if (m_isReplaying) {
+        LogReplay();
+    } else if (m_recording && m_options.replayPath.empty()) {
+        m_recording->SetNumTicks(m_tickCount);
+        m_recording->Save(m_options.recordPath);
+    }
+    if (!m_options.metricsPath.empty()) {
+        m_metrics->WriteCsv(m_options.metricsPath);
+    }
+#ifdef ENABLE_PROFILER
+    Profiler::LogSummary();
+    Profiler::WriteChromeTrace(m_options.tracePath);
+#endif
+    if (m_frameCount > 0) {
+        double msPerTick = 1000.0 / SDL_GetPerformanceFrequency();
+        double renderMs = m_renderTicks * msPerTick / m_frameCount;
+        double latencyMs = m_latencyTicks * msPerTick / m_frameCount;
+        double fps = m_frameCount / (m_runTicks * msPerTick / 1000.0);
+        Logger::Log("Rendered " + std::to_string(m_frameCount) +
+                    " frames, " + std::to_string(renderMs) + " ms/frame, " +
+                    std::to_string(m_drawCalls / m_frameCount) +
+                    " draw calls/frame, " +
+                    std::to_string(m_textureSwitches / m_frameCount) +
+                    " texture switches/frame");
+        Logger::Log(std::string(m_options.isPipelined ? "Pipelined"
+                                                      : "Sequential") +
+                    " loop: " + std::to_string(m_tickCount) + " ticks at " +
+                    std::to_string(m_options.tickRate) + " Hz, " +
+                    std::to_string(m_droppedTicks) + " dropped, " +
+                    std::to_string(fps) + " frames/s, " +
+                    std::to_string(latencyMs) +
+                    " ms from simulation start to present");
+    }
+    if (m_tickCount > 0) {
+        double msPerTick = 1000.0 / SDL_GetPerformanceFrequency();
+        if (m_options.isHeadless) {
+            double runMs = m_runTicks * msPerTick;
+            Logger::Log("Headless: " + std::to_string(m_tickCount) +
+                        " ticks in " + std::to_string(runMs) + " ms, " +
+                        std::to_string(m_tickCount / (runMs / 1000.0)) +
+                        " ticks/s");
+        }
+        Uint64 updateTicks = 0;
+        for (Uint64 stepTicks : m_updateStepTicks) {
+            updateTicks += stepTicks;
+        }
+        for (int step = 0; step < NUM_UPDATE_STEPS; step++) {
+            double usPerTick =
+                m_updateStepTicks[step] * msPerTick * 1000.0 / m_tickCount;
+            double percent = updateTicks > 0 ? m_updateStepTicks[step] *
+                                                   100.0 / updateTicks
+                                             : 0.0;
+            Logger::Log("Update " + std::string(UPDATE_STEP_NAMES[step]) +
+                        ": " + std::to_string(usPerTick) + " us/tick, " +
+                        std::to_string(percent) + "%");
+        }
+        if (m_perfCounters && m_perfCounters->IsOpen()) {
+            LogPerfCounters();
+        }
+    }
+    Logger::Log(
+        "Asset memory: " +
+        std::to_string(m_assetStore->GetMemoryUsage(ASSET_TYPE_TEXTURE) /
+                       1024) +
+        " KB textures, " +
+        std::to_string(m_assetStore->GetMemoryUsage(ASSET_TYPE_FONT) / 1024) +
+        " KB fonts, " +
+        std::to_string(m_assetStore->GetMemoryUsage(ASSET_TYPE_SOUND) / 1024) +
+        " KB sounds");
+    const AudioStats& audioStats = m_audioMixer->GetStats();
+    Logger::Log("Audio: " + std::to_string(audioStats.numRequests) +
+                " requests, " + std::to_string(audioStats.numPlayed) +
+                " played, " + std::to_string(audioStats.numCulled) +
+                " culled, " + std::to_string(audioStats.numMerged) +
+                " merged, " + std::to_string(audioStats.numLimited) +
+                " over the instance limit, " +
+                std::to_string(audioStats.numStolen) + " voices stolen, " +
+                std::to_string(audioStats.numDropped) + " dropped");
+
+    if (m_registry->HasSystem<WorldStreamingSystem>()) {
+        const auto& worldStreaming =
+            m_registry->GetSystem<WorldStreamingSystem>();
+        Logger::Log("World: " +
+                    std::to_string(worldStreaming.GetNumResidentCells()) +
+                    " of " + std::to_string(worldStreaming.GetNumCells()) +
+                    " cells loaded, " +
+                    std::to_string(worldStreaming.GetNumLiveEntities()) +
+                    " streamed entities alive, " +
+                    std::to_string(worldStreaming.GetNumRecords()) + " saved");
+    }
+
+    for (int i = 0; i < m_scriptEngine->GetNumBehaviours(); i++) {
+        const BehaviourStats& stats = m_scriptEngine->GetBehaviourStats(i);
+        if (stats.numEntities == 0) {
+            continue;
+        }
+        double usPer10k = stats.ticks * 1000000.0 /
+                          SDL_GetPerformanceFrequency() / stats.numEntities *
+                          10000;
+        Logger::Log("Behaviour " + m_scriptEngine->GetBehaviourName(i) +
+                    ": " + std::to_string(stats.numEntities / stats.numCalls) +
+                    " entities per tick, " + std::to_string(usPer10k) +
+                    " us per 10k entities");
+    }
+    m_scriptEngine->Destroy();
+
+    // Sounds are still playing from chunks in the asset store
+    m_audioMixer->Destroy();
+
+    // Textures belong to the renderer, release them before it goes
+    if (m_renderer) {
+        m_tileLayer.reset();
+        m_assetStore->ClearAssets(*m_renderer);
+        m_renderer->Destroy();
+    }
+    TTF_Quit();
     SDL_Quit();
 }
@@ -2,36 +2,225 @@
 #define GAME_H
 
 #include "../AssetStore/AssetStore.h"
+#include "../Audio/AudioMixer.h"
 #include "../ECS/ECS.h"
 #include "../EventBus/EventBus.h"
+#include "../Logger/Logger.h"
+#include "../Metrics/Metrics.h"
+#include "../Metrics/MetricsExporter.h"
+#include "../Profiler/PerfCounters.h"
+#include "../Renderer/RenderBackend.h"
+#include "../Renderer/RenderSnapshot.h"
+#include "../Replay/InputRecording.h"
+#include "../Scripting/ScriptEngine.h"
+#include "../Tilemap/TileLayer.h"
+#include "../Timers/TimerWheel.h"
 #include <SDL2/SDL.h>
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <string>
+#include <typeindex>
+#include <vector>
 
-const int FPS = 60;
-const int MILLISECS_PER_FRAME = 1000 / FPS;
+// Time the render thread may spend uploading textures every frame
+const double TEXTURE_UPLOAD_BUDGET_MS = 2.0;
+
+// Where the metrics overlay starts and how wide its columns are
+const int METRICS_OVERLAY_MARGIN = 10;
+const int METRICS_OVERLAY_COLUMN_WIDTH = 260;
+
+// Steps of a simulation tick, timed separately and reported on exit
+enum UpdateStep {
+    UPDATE_STEP_EVENTS,
+    UPDATE_STEP_ASSETS,
+    UPDATE_STEP_TIMERS,
+    UPDATE_STEP_REGISTRY,
+    UPDATE_STEP_PREVIOUS_POSITIONS,
+    UPDATE_STEP_WORLD_STREAMING,
+    UPDATE_STEP_SCRIPTS,
+    UPDATE_STEP_MOVEMENT,
+    UPDATE_STEP_TILE_COLLISION,
+    UPDATE_STEP_ANIMATION,
+    UPDATE_STEP_COLLISION,
+    UPDATE_STEP_CAMERA,
+    UPDATE_STEP_PROJECTILE_EMIT,
+    UPDATE_STEP_PROJECTILE_LIFECYCLE,
+    UPDATE_STEP_AUDIO,
+    NUM_UPDATE_STEPS
+};
+
+struct GameOptions {
+    RenderBackendType renderBackend = RENDER_BACKEND_SDL;
+    // No window, renderer or audio device at all and no assets loaded. The
+    // simulation runs tick after tick as fast as it can.
+    bool isHeadless = false;
+    // Quit after this many simulation ticks, 0 runs until the player quits
+    int maxTicks = 0;
+    // Level script loaded by Setup()
+    int level = 1;
+    // Messages below this level are not logged, debug logs every entity,
+    // component and collision
+    LogType logLevel = LOG_DEBUG;
+    // Where the profiler trace is written, on exit and when P is pressed.
+    // Only in builds with the profiler compiled in (make PROFILE=1).
+    std::string tracePath = "./trace.json";
+    // CSV file the metrics of the last frames are written to on exit, empty
+    // to only sample them while the overlay is shown
+    std::string metricsPath;
+    // Serve the metrics to Prometheus on this localhost port or Unix socket,
+    // 0 and empty to not export them
+    int         metricsPort = 0;
+    std::string metricsSocket;
+    // Read the hardware performance counters around every update step and
+    // report them per step on exit, timings only when they are unavailable
+    bool isPerfCounters = false;
+    // Record the keys handled every tick to this file, empty to not record
+    std::string recordPath;
+    // Play back a recording instead of the keyboard. Its tick rate and level
+    // replace the options, and the game quits after its last tick.
+    std::string replayPath;
+    // CSV file the update time of every replayed tick is written to, with
+    // the state hashes next to the ticks that have one
+    std::string replayReportPath;
+    // Ticks between two state hashes in a recording
+    int hashInterval = 60;
+    // Directory where the software backend saves every frame, empty to
+    // disable the capture
+    std::string captureDirectory;
+    // Quit after this many frames, 0 runs until the player quits
+    int maxFrames = 0;
+    // Simulate the next frame on a second thread while the current one is
+    // rendered
+    bool isPipelined = false;
+    // Asset archive written by assetpack, empty to decode the loose images
+    std::string assetArchive;
+    // Memory the asset cache may use before evicting unused assets, in
+    // megabytes, 0 for no limit
+    int assetBudgetMb = 0;
+    // Simulation ticks per second, every tick advances the game by the same
+    // amount of time
+    int tickRate = 60;
+    // Ticks run in a row to catch up after a slow frame, the time still
+    // missing after that is dropped and the game slows down instead
+    int maxCatchUpSteps = 5;
+    // Render as often as possible instead of once per tick, the frames in
+    // between two ticks are interpolated
+    bool isUncapped = false;
+};
 
 class Game {
 private:
-    bool          m_isRunning;
-    bool          m_isDebug;
-    int           m_millisecsPreviousFrame = 0;
-    SDL_Window*   m_window;
-    SDL_Renderer* m_renderer;
-    SDL_Rect      m_camera;
+    // Read by both the simulation and the render thread
+    std::atomic<bool> m_isRunning;
+    std::atomic<bool> m_isDebug;
+    std::atomic<bool> m_isMetricsOverlay;
+
+    // Counters of the last frame rendered, sampled by the simulation
+    std::atomic<int> m_lastDrawCalls{0};
+    std::atomic<int> m_lastTextureSwitches{0};
+
+    SDL_Rect    m_camera;
+    SDL_Rect    m_previousCamera;
+    GameOptions m_options;
+
+    // Fixed timestep, the simulation clock advances by one tick duration per
+    // tick and is kept within maxCatchUpSteps ticks of the real time
+    Uint64 m_tickDuration = 0;
+    Uint64 m_simulationClock = 0;
+    double m_deltaTime = 0.0;
+
+    // Keys pressed since the last simulation tick, drained by Update()
+    std::mutex               m_keysMutex;
+    std::vector<SDL_Keycode> m_pressedKeys;
+
+    // Scratch lists refilled every time the metrics are sampled
+    std::vector<PoolStats>    m_poolStats;
+    std::vector<SystemStats>  m_systemStats;
+    std::vector<EmittedCount> m_numEmitted;
+    FontHandle                m_overlayFont = INVALID_FONT_HANDLE;
+
+    // Events emitted since the game started, the event bus only counts them
+    // for the current tick
+    std::map<std::type_index, Uint64> m_eventTotals;
+
+    // Frames handed from the simulation to the renderer
+    SnapshotBuffer m_snapshots;
+    Uint64         m_tickStart = 0;
+
+    // Statistics reported when the game is destroyed
+    int       m_tickCount = 0;
+    Uint64    m_droppedTicks = 0;
+    Uint64    m_updateStepTicks[NUM_UPDATE_STEPS] = {};
+    int       m_frameCount = 0;
+    Uint64    m_renderTicks = 0;
+    Uint64    m_latencyTicks = 0;
+    Uint64    m_runTicks = 0;
+    long long m_drawCalls = 0;
+    long long m_textureSwitches = 0;
+
+    // Hardware counter deltas and entities processed per update step, summed
+    // over every tick
+    PerfSample m_updateStepCounters[NUM_UPDATE_STEPS];
+    Uint64     m_updateStepEntities[NUM_UPDATE_STEPS] = {};
+    PerfSample m_lastPerfSample;
+
+    // Update time of every replayed tick in microseconds and the state hashes
+    // taken along the replay, compared against the recorded ones
+    std::vector<float>         m_replayTickTimes;
+    std::vector<std::uint64_t> m_replayHashes;
+    int                        m_numHashMismatches = 0;
+    int                        m_firstMismatchTick = -1;
+
+    // Runs the ticks that are due, returns how many ran
+    int    RunDueTicks();
+    void   WaitForNextTick();
+    // Adds the time since stepStart to the step, returns the current time
+    // for the next step to start from
+    Uint64 EndUpdateStep(UpdateStep step, Uint64 stepStart);
+    // Entities the step goes through, 0 for the steps that are not per entity
+    int    GetUpdateStepEntities(UpdateStep step) const;
+    void   LogPerfCounters() const;
+    void   PublishSnapshot();
+    void   SampleMetrics();
+    void   PublishExporterSnapshot();
+    void   BuildMetricsOverlay(std::vector<SpriteDrawCommand>& commands);
+    void   RunSequential();
+    void   RunPipelined();
+    void   RunHeadless();
+
+    // Hash of everything the simulation ticks, the same after the same ticks
+    // on the same inputs
+    std::uint64_t HashState() const;
+    void          RecordStateHash();
+    void          LogReplay() const;
 
-    std::unique_ptr<EventBus>   m_eventBus;
-    std::unique_ptr<Registry>   m_registry;
-    std::unique_ptr<AssetStore> m_assetStore;
+    std::unique_ptr<RenderBackend>   m_renderer;
+    std::unique_ptr<EventBus>        m_eventBus;
+    std::unique_ptr<Registry>        m_registry;
+    std::unique_ptr<AssetStore>      m_assetStore;
+    std::unique_ptr<TileLayer>       m_tileLayer;
+    std::unique_ptr<AudioMixer>      m_audioMixer;
+    std::unique_ptr<ScriptEngine>    m_scriptEngine;
+    std::unique_ptr<Metrics>         m_metrics;
+    std::unique_ptr<MetricsExporter> m_exporter;
+    std::unique_ptr<PerfCounters>    m_perfCounters;
+    std::unique_ptr<InputRecording>  m_recording;
+    std::unique_ptr<TimerWheel>      m_timers;
+    bool                             m_isReplaying = false;
 
 public:
     Game();
     ~Game();
-    void Initialize();
+    void Initialize(const GameOptions& options = GameOptions());
     void Run();
     void Setup();
     void LoadLevel(int level);
     void ProcessInput();
     void Update();
-    void Render();
+    // Milliseconds simulated so far, what the systems measure time with
+    int  GetSimulationTime() const;
+    void Render(const RenderSnapshot& snapshot);
     void Destroy();
 
     static int s_windowWidth;
@@ -1,32 +1,319 @@
 #include "Logger.h"
+#include <algorithm>
 #include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
 #include <ctime>
 #include <iostream>
-#include <string>
+#include <mutex>
+#include <thread>
 
-std::vector<LogEntry> Logger::messages;
+std::atomic<int> Logger::s_level{LOG_DEBUG};
 
-std::string CurrentDateTimeToString() {
-    std::time_t now =
-        std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
-    std::string output(30, '\0');
-    std::strftime(&output[0], output.size(), "%d-%b-%Y %H:%M:%S",
-                  std::localtime(&now));
-    return output;
+// How long the writer thread sleeps when nobody asks it to write
+static const auto WRITER_INTERVAL = std::chrono::milliseconds(10);
+
+// Every ring ever created, they outlive their thread so what a thread logged
+// right before it ended is still written
+static std::mutex                            s_ringsMutex;
+static std::vector<std::unique_ptr<LogRing>> s_rings;
+static thread_local LogRing*                 s_threadRing;
+
+static std::once_flag          s_writerStarted;
+static std::thread             s_writer;
+static std::mutex              s_writerMutex;
+static std::condition_variable s_writerWake;
+static std::condition_variable s_writerDone;
+static bool                    s_isWriterStopping = false;
+static uint64_t                s_numFlushRequests = 0;
+static uint64_t                s_numFlushesDone = 0;
+// Once the writer thread stopped at exit, every thread writes its messages
+// itself
+static std::atomic<bool> s_isSynchronous{false};
+
+// Taken by whoever formats and writes, the writer thread or the threads
+// logging once it stopped
+static std::mutex            s_outputMutex;
+static std::vector<LogEntry> s_history;
+static uint64_t              s_numHistory = 0;
+static std::int64_t          s_timeSecond = -1;
+static char                  s_timeText[32];
+
+static const char* LOG_PREFIXES[] = {"DBG", "LOG", "WRN", "ERR"};
+static const char* LOG_COLORS[] = {"\x1B[90m", "\x1B[32m", "\x1B[33m",
+                                   "\x1B[91m"};
+
+static std::int64_t Now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+
+// The date only changes once a second, strftime runs as rarely
+static const char* FormatTime(std::int64_t time) {
+    const std::int64_t second = time / 1000000000;
+    if (second != s_timeSecond) {
+        std::time_t now = static_cast<std::time_t>(second);
+        std::strftime(s_timeText, sizeof(s_timeText), "%d-%b-%Y %H:%M:%S",
+                      std::localtime(&now));
+        s_timeSecond = second;
+    }
+    return s_timeText;
+}
+
+static void AppendArg(std::string& text, LogArgType type,
+                      const LogArgValue& value) {
+    char number[32];
+    switch (type) {
+    case LOG_ARG_INT:
+        std::snprintf(number, sizeof(number), "%lld", value.i);
+        text += number;
+        break;
+    case LOG_ARG_UINT:
+        std::snprintf(number, sizeof(number), "%llu", value.u);
+        text += number;
+        break;
+    case LOG_ARG_DOUBLE:
+        std::snprintf(number, sizeof(number), "%f", value.d);
+        text += number;
+        break;
+    case LOG_ARG_TEXT:
+        text += value.text ? value.text : "(null)";
+        break;
+    case LOG_ARG_STRING:
+        text += *value.string;
+        break;
+    }
+}
+
+static void ReleaseArgs(const LogRecord& record) {
+    for (int i = 0; i < record.numArgs; i++) {
+        if (record.argTypes[i] == LOG_ARG_STRING) {
+            delete record.args[i].string;
+        }
+    }
+}
+
+// Formats the record into the output of its stream and the history, the
+// output mutex must be held
+static void FormatRecord(const LogRecord& record, std::string& out,
+                         std::string& err) {
+    LogEntry entry;
+    entry.type = record.type;
+    entry.message = std::string(LOG_PREFIXES[record.type]) + ": [" +
+                    FormatTime(record.time) + "]: ";
+    int argIndex = 0;
+    for (const char* c = record.format; *c; c++) {
+        if (c[0] == '{' && c[1] == '}' && argIndex < record.numArgs) {
+            AppendArg(entry.message, record.argTypes[argIndex],
+                      record.args[argIndex]);
+            argIndex++;
+            c++;
+        } else {
+            entry.message += *c;
+        }
+    }
+    ReleaseArgs(record);
+
+    std::string& stream = record.type >= LOG_WARNING ? err : out;
+    stream += LOG_COLORS[record.type];
+    stream += entry.message;
+    stream += "\033[0m\n";
+
+    if (s_history.size() < LOG_HISTORY_SIZE) {
+        s_history.push_back(std::move(entry));
+    } else {
+        s_history[s_numHistory % LOG_HISTORY_SIZE] = std::move(entry);
+    }
+    s_numHistory++;
+}
+
+static void WriteOutput(const std::string& out, const std::string& err) {
+    if (!out.empty()) {
+        std::cout.write(out.data(), out.size());
+        std::cout.flush();
+    }
+    if (!err.empty()) {
+        std::cerr.write(err.data(), err.size());
+        std::cerr.flush();
+    }
+}
+
+// Takes everything queued in the rings and writes it, oldest first
+static void Drain(std::vector<LogRecord>& batch) {
+    batch.clear();
+    uint64_t numDropped = 0;
+    {
+        std::lock_guard<std::mutex> lock(s_ringsMutex);
+        for (const auto& ring : s_rings) {
+            const uint64_t head = ring->head.load(std::memory_order_acquire);
+            const uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+            for (uint64_t i = tail; i < head; i++) {
+                batch.push_back(ring->records[i % LOG_RING_SIZE]);
+            }
+            ring->tail.store(head, std::memory_order_release);
+            numDropped += ring->numDropped.exchange(0);
+        }
+    }
+    if (batch.empty() && numDropped == 0) {
+        return;
+    }
+
+    // Every ring is in order already, the threads are interleaved
+    std::stable_sort(batch.begin(), batch.end(),
+                     [](const LogRecord& first, const LogRecord& second) {
+                         return first.time < second.time;
+                     });
+
+    std::string                 out;
+    std::string                 err;
+    std::lock_guard<std::mutex> lock(s_outputMutex);
+    for (const auto& record : batch) {
+        FormatRecord(record, out, err);
+    }
+    if (numDropped > 0) {
+        LogRecord record;
+        record.format = "{} messages dropped, logged faster than written";
+        record.time = Now();
+        record.type = LOG_WARNING;
+        record.numArgs = 1;
+        record.argTypes[0] = LOG_ARG_UINT;
+        record.args[0].u = numDropped;
+        FormatRecord(record, out, err);
+    }
+    WriteOutput(out, err);
+}
+
+static void RunWriter() {
+    std::vector<LogRecord>       batch;
+    std::unique_lock<std::mutex> lock(s_writerMutex);
+    while (true) {
+        s_writerWake.wait_for(lock, WRITER_INTERVAL, [] {
+            return s_isWriterStopping ||
+                   s_numFlushRequests != s_numFlushesDone;
+        });
+        const uint64_t numFlushRequests = s_numFlushRequests;
+        const bool     isStopping = s_isWriterStopping;
+        lock.unlock();
+        Drain(batch);
+        lock.lock();
+        s_numFlushesDone = numFlushRequests;
+        s_writerDone.notify_all();
+        if (isStopping) {
+            return;
+        }
+    }
+}
+
+// Runs at exit, writes what is still queued and leaves the threads logging
+// after that to write their messages themselves
+static void StopWriter() {
+    s_isSynchronous = true;
+    {
+        std::lock_guard<std::mutex> lock(s_writerMutex);
+        s_isWriterStopping = true;
+    }
+    s_writerWake.notify_one();
+    s_writer.join();
+}
+
+LogRing& Logger::GetThreadRing() {
+    if (!s_threadRing) {
+        std::call_once(s_writerStarted, [] {
+            s_writer = std::thread(RunWriter);
+            std::atexit(StopWriter);
+        });
+        std::lock_guard<std::mutex> lock(s_ringsMutex);
+        auto ring = std::make_unique<LogRing>();
+        ring->records = std::make_unique<LogRecord[]>(LOG_RING_SIZE);
+        s_threadRing = ring.get();
+        s_rings.push_back(std::move(ring));
+    }
+    return *s_threadRing;
+}
+
+bool Logger::Push(LogRecord& record) {
+    record.time = Now();
+    if (s_isSynchronous) {
+        std::string                 out;
+        std::string                 err;
+        std::lock_guard<std::mutex> lock(s_outputMutex);
+        FormatRecord(record, out, err);
+        WriteOutput(out, err);
+        return true;
+    }
+
+    LogRing&       ring = GetThreadRing();
+    const uint64_t head = ring.head.load(std::memory_order_relaxed);
+    if (head - ring.tail.load(std::memory_order_acquire) >= LOG_RING_SIZE) {
+        ring.numDropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    ring.records[head % LOG_RING_SIZE] = record;
+    ring.head.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+void Logger::PushString(LogType type, const std::string& message) {
+    LogRecord record;
+    record.format = "{}";
+    record.type = type;
+    record.numArgs = 1;
+    record.argTypes[0] = LOG_ARG_STRING;
+    record.args[0].string = new std::string(message);
+
+    // Errors are never dropped, they wait for room in the ring
+    while (!Push(record)) {
+        if (type < LOG_ERROR) {
+            ReleaseArgs(record);
+            return;
+        }
+        Flush();
+    }
 }
 
 void Logger::Log(const std::string& message) {
-    LogEntry logEntry;
-    logEntry.type = LOG_INFO;
-    logEntry.message = "LOG: [" + CurrentDateTimeToString() + "]: " + message;
-    std::cout << "\x1B[32m" << logEntry.message << "\033[0m" << std::endl;
-    messages.push_back(logEntry);
+    if (IsEnabled(LOG_INFO)) {
+        PushString(LOG_INFO, message);
+    }
 }
 
 void Logger::Err(const std::string& message) {
-    LogEntry logEntry;
-    logEntry.type = LOG_ERROR;
-    logEntry.message = "ERR: [" + CurrentDateTimeToString() + "]: " + message;
-    messages.push_back(logEntry);
-    std::cerr << "\x1B[91m" << logEntry.message << "\033[0m" << std::endl;
+    if (IsEnabled(LOG_ERROR)) {
+        PushString(LOG_ERROR, message);
+        Flush();
+    }
+}
+
+void Logger::Flush() {
+    if (s_isSynchronous) {
+        return;
+    }
+    // Starts the writer thread when nothing was logged yet
+    GetThreadRing();
+    std::unique_lock<std::mutex> lock(s_writerMutex);
+    const uint64_t               request = ++s_numFlushRequests;
+    s_writerWake.notify_one();
+    s_writerDone.wait(lock, [request] {
+        return s_numFlushesDone >= request || s_isWriterStopping;
+    });
+}
+
+std::vector<LogEntry> Logger::GetHistory() {
+    std::lock_guard<std::mutex> lock(s_outputMutex);
+    std::vector<LogEntry>       history;
+    history.reserve(s_history.size());
+    const uint64_t first =
+        s_numHistory > LOG_HISTORY_SIZE ? s_numHistory - LOG_HISTORY_SIZE : 0;
+    for (uint64_t i = first; i < s_numHistory; i++) {
+        history.push_back(s_history[i % LOG_HISTORY_SIZE]);
+    }
+    return history;
+}
+
+void Logger::ClearHistory() {
+    std::lock_guard<std::mutex> lock(s_outputMutex);
+    s_history.clear();
+    s_numHistory = 0;
 }
@@ -1,21 +1,167 @@
 #ifndef LOGGER_H
 #define LOGGER_H
 
+#include <atomic>
+#include <cstdint>
+#include <memory>
 #include <string>
+#include <type_traits>
 #include <vector>
 
-enum LogType { LOG_INFO, LOG_WARNING, LOG_ERROR };
+enum LogType { LOG_DEBUG, LOG_INFO, LOG_WARNING, LOG_ERROR };
+
+// Messages below this level are compiled out, make LOG_LEVEL=1 builds
+// without the debug messages
+#ifndef LOG_MIN_LEVEL
+#define LOG_MIN_LEVEL 0
+#endif
+
+// Messages a thread can queue before the writer thread catches up, the
+// messages logged while its ring is full are dropped and counted
+const int LOG_RING_SIZE = 1 << 13;
+// Messages kept in memory, the oldest are overwritten
+const int LOG_HISTORY_SIZE = 1024;
+const int LOG_MAX_ARGS = 4;
 
 struct LogEntry {
     LogType     type;
     std::string message;
 };
 
+enum LogArgType : std::uint8_t {
+    LOG_ARG_INT,
+    LOG_ARG_UINT,
+    LOG_ARG_DOUBLE,
+    // A string literal, only the pointer is queued
+    LOG_ARG_TEXT,
+    // A copy of a string, deleted once written
+    LOG_ARG_STRING
+};
+
+union LogArgValue {
+    long long          i;
+    unsigned long long u;
+    double             d;
+    const char*        text;
+    std::string*       string;
+};
+
+// A message as it is queued, the writer thread formats it
+struct LogRecord {
+    // String literal with a {} for every argument, its address is all that
+    // is queued
+    const char*  format;
+    // Nanoseconds since the epoch of the system clock
+    std::int64_t time;
+    LogType      type;
+    std::uint8_t numArgs;
+    LogArgType   argTypes[LOG_MAX_ARGS];
+    LogArgValue  args[LOG_MAX_ARGS];
+};
+
+static_assert(sizeof(LogRecord) == 64, "A log record fills a cache line");
+
+// Single writer ring buffer owned by one thread, emptied by the writer
+// thread. The indices are on their own cache lines so the two threads do not
+// bounce a line between them on every message.
+struct LogRing {
+    std::unique_ptr<LogRecord[]> records;
+    // Total number of records ever queued, written by the owning thread
+    alignas(64) std::atomic<uint64_t> head{0};
+    // Total number of records ever taken, written by the writer thread
+    alignas(64) std::atomic<uint64_t> tail{0};
+    std::atomic<uint64_t> numDropped{0};
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Logger
+////////////////////////////////////////////////////////////////////////////////
+// Logging only copies the message into a ring buffer of the calling thread,
+// without locking. A writer thread takes the messages of every thread,
+// formats them in the order they were logged and writes them in batches.
+// Hot paths log through LOG_FORMAT, which queues the format literal and the
+// raw arguments and leaves the formatting to the writer thread. Errors are
+// written before Err() returns. Messages still queued at exit are written.
+////////////////////////////////////////////////////////////////////////////////
 class Logger {
+private:
+    static std::atomic<int> s_level;
+
+    static LogRing& GetThreadRing();
+    // Returns false when the ring is full and the message was dropped
+    static bool     Push(LogRecord& record);
+    static void     PushString(LogType type, const std::string& message);
+
+    template <typename T>
+    static void SetArg(LogRecord& record, int index, T value);
+
 public:
-    static std::vector<LogEntry> messages;
-    static void                  Log(const std::string& message);
-    static void                  Err(const std::string& message);
+    static void Log(const std::string& message);
+    static void Err(const std::string& message);
+
+    // Messages below the level are dropped where they are logged
+    static void    SetLevel(LogType level) { s_level = level; }
+    static LogType GetLevel() { return static_cast<LogType>(s_level.load()); }
+    static bool    IsEnabled(LogType type) {
+        return type >= LOG_MIN_LEVEL &&
+               type >= s_level.load(std::memory_order_relaxed);
+    }
+
+    // Use LOG_FORMAT, which makes sure the format is a literal
+    template <typename... TArgs>
+    static void Write(LogType type, const char* format, TArgs... args);
+
+    // Blocks until every message queued before the call is written
+    static void Flush();
+
+    // The last LOG_HISTORY_SIZE messages written, oldest first
+    static std::vector<LogEntry> GetHistory();
+    static void                  ClearHistory();
 };
 
+template <typename T>
+void Logger::SetArg(LogRecord& record, int index, T value) {
+    if constexpr (std::is_floating_point_v<T>) {
+        record.argTypes[index] = LOG_ARG_DOUBLE;
+        record.args[index].d = value;
+    } else if constexpr (std::is_enum_v<T> ||
+                         (std::is_integral_v<T> && std::is_signed_v<T>)) {
+        record.argTypes[index] = LOG_ARG_INT;
+        record.args[index].i = static_cast<long long>(value);
+    } else if constexpr (std::is_integral_v<T>) {
+        record.argTypes[index] = LOG_ARG_UINT;
+        record.args[index].u = static_cast<unsigned long long>(value);
+    } else {
+        static_assert(std::is_convertible_v<T, const char*>,
+                      "Log arguments are numbers or string literals");
+        record.argTypes[index] = LOG_ARG_TEXT;
+        record.args[index].text = value;
+    }
+}
+
+template <typename... TArgs>
+void Logger::Write(LogType type, const char* format, TArgs... args) {
+    static_assert(sizeof...(TArgs) <= LOG_MAX_ARGS, "Too many log arguments");
+    if (!IsEnabled(type)) {
+        return;
+    }
+    LogRecord record;
+    record.format = format;
+    record.type = type;
+    record.numArgs = sizeof...(TArgs);
+    [[maybe_unused]] int index = 0;
+    (SetArg(record, index++, args), ...);
+    Push(record);
+}
+
+// Queues a message, every {} in the format is replaced by the next argument.
+// The format must be a string literal and the arguments numbers or string
+// literals. Messages below LOG_MIN_LEVEL are compiled out.
+#define LOG_FORMAT(type, format, ...)                                          \
+    do {                                                                       \
+        if ((type) >= LOG_MIN_LEVEL) {                                         \
+            Logger::Write((type), "" format, ##__VA_ARGS__);                   \
+        }                                                                      \
+    } while (0)
+
 #endif // !LOGGER_H
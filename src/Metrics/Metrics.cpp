@@ -0,0 +1,65 @@
+#include "Metrics.h"
+#include "../Logger/Logger.h"
+#include <fstream>
+
+int Metrics::GetId(const std::string& name) {
+    auto id = m_ids.find(name);
+    if (id != m_ids.end()) {
+        return id->second;
+    }
+    m_names.push_back(name);
+    m_values.push_back(0.0);
+    m_ids.emplace(name, m_names.size() - 1);
+    return m_names.size() - 1;
+}
+
+void Metrics::EndFrame() {
+    if (m_history.size() >= METRICS_HISTORY_SIZE) {
+        m_history.pop_front();
+    }
+    m_history.emplace_back(m_frame++, m_values);
+
+    m_lastValues.swap(m_values);
+    m_values.assign(m_names.size(), 0.0);
+}
+
+double Metrics::GetValue(int id) const {
+    if (id >= static_cast<int>(m_lastValues.size())) {
+        return 0.0;
+    }
+    return m_lastValues[id];
+}
+
+bool Metrics::WriteCsv(const std::string& filePath) const {
+    std::ofstream file(filePath, std::ios::trunc);
+    if (!file) {
+        Logger::Err("Error creating metrics file " + filePath);
+        return false;
+    }
+
+    file << "frame";
+    for (const auto& name : m_names) {
+        file << ',' << name;
+    }
+    file << '\n';
+
+    // Metrics that did not exist yet are left empty
+    for (const auto& row : m_history) {
+        file << row.first;
+        for (size_t id = 0; id < m_names.size(); id++) {
+            file << ',';
+            if (id < row.second.size()) {
+                file << row.second[id];
+            }
+        }
+        file << '\n';
+    }
+
+    if (!file) {
+        Logger::Err("Error writing metrics file " + filePath);
+        return false;
+    }
+    Logger::Log("Metrics of " + std::to_string(m_history.size()) +
+                " frames written to " + filePath);
+    return true;
+}
@@ -0,0 +1,53 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <SDL2/SDL.h>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Frames kept for the CSV dump, a minute at 60 ticks per second
+const int METRICS_HISTORY_SIZE = 3600;
+
+////////////////////////////////////////////////////////////////////////////////
+// Metrics
+////////////////////////////////////////////////////////////////////////////////
+// Named values sampled once per frame. Metrics are registered the first time
+// they are set, every frame starts with all of them at 0 and EndFrame() keeps
+// the frame in a history that can be dumped as CSV, one column per metric.
+////////////////////////////////////////////////////////////////////////////////
+class Metrics {
+private:
+    std::vector<std::string>             m_names;
+    std::unordered_map<std::string, int> m_ids;
+
+    // The frame being sampled and the last one finished [Vector index =
+    // metric id]
+    std::vector<double> m_values;
+    std::vector<double> m_lastValues;
+
+    // Oldest first, rows are shorter than m_names when metrics were added
+    // after them
+    std::deque<std::pair<Uint64, std::vector<double>>> m_history;
+    Uint64                                             m_frame = 0;
+
+public:
+    // Registers the metric the first time it is asked for
+    int  GetId(const std::string& name);
+    void Set(int id, double value) { m_values[id] = value; }
+    void Set(const std::string& name, double value) {
+        Set(GetId(name), value);
+    }
+
+    void EndFrame();
+
+    // Values of the last finished frame
+    int                GetNumMetrics() const { return m_names.size(); }
+    const std::string& GetName(int id) const { return m_names[id]; }
+    double             GetValue(int id) const;
+
+    bool WriteCsv(const std::string& filePath) const;
+};
+
+#endif // !METRICS_H
@@ -0,0 +1,334 @@
+#include "MetricsExporter.h"
+#include "../Logger/Logger.h"
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// How often the exporter thread wakes up to check it was stopped
+static const int POLL_TIMEOUT_MS = 100;
+// Time a client gets to send its request before the metrics are sent anyway
+static const int REQUEST_TIMEOUT_MS = 500;
+
+void DurationHistogram::Observe(double seconds) {
+    int bucket = 0;
+    while (bucket < NUM_HISTOGRAM_BUCKETS - 1 &&
+           seconds > HISTOGRAM_BUCKET_BOUNDS[bucket]) {
+        bucket++;
+    }
+    m_bucketCounts[bucket].fetch_add(1, std::memory_order_relaxed);
+    m_sumNs.fetch_add(static_cast<uint64_t>(seconds * 1e9),
+                      std::memory_order_relaxed);
+}
+
+MetricsExporter::~MetricsExporter() { Stop(); }
+
+int MetricsExporter::Listen(int family, const void* address,
+                            int addressLength) {
+    int listenSocket = socket(family, SOCK_STREAM, 0);
+    if (listenSocket < 0) {
+        Logger::Err("Error creating the metrics socket: " +
+                    std::string(std::strerror(errno)));
+        return -1;
+    }
+    if (family == AF_INET) {
+        // Restarting the game must not wait for the old port to time out
+        int reuse = 1;
+        setsockopt(listenSocket, SOL_SOCKET, SO_REUSEADDR, &reuse,
+                   sizeof(reuse));
+    }
+    if (bind(listenSocket, static_cast<const sockaddr*>(address),
+             addressLength) != 0 ||
+        listen(listenSocket, 8) != 0) {
+        Logger::Err("Error binding the metrics socket: " +
+                    std::string(std::strerror(errno)));
+        close(listenSocket);
+        return -1;
+    }
+    return listenSocket;
+}
+
+int MetricsExporter::ListenTcp(int port) {
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(static_cast<uint16_t>(port));
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    int listenSocket = Listen(AF_INET, &address, sizeof(address));
+    if (listenSocket >= 0) {
+        Logger::Log("Metrics exported on http://127.0.0.1:" +
+                    std::to_string(port) + "/metrics");
+    }
+    return listenSocket;
+}
+
+int MetricsExporter::ListenUnix(const std::string& socketPath) {
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(address.sun_path)) {
+        Logger::Err("Metrics socket path too long: " + socketPath);
+        return -1;
+    }
+    std::strcpy(address.sun_path, socketPath.c_str());
+    // A socket left behind by a game that crashed would fail the bind. Only
+    // a socket is removed, a mistyped path must not cost a file.
+    struct stat status;
+    if (lstat(socketPath.c_str(), &status) == 0) {
+        if (!S_ISSOCK(status.st_mode)) {
+            Logger::Err("Metrics socket path is not a socket: " + socketPath);
+            return -1;
+        }
+        unlink(socketPath.c_str());
+    }
+    int listenSocket = Listen(AF_UNIX, &address, sizeof(address));
+    if (listenSocket >= 0) {
+        m_socketPath = socketPath;
+        Logger::Log("Metrics exported on unix socket " + socketPath);
+    }
+    return listenSocket;
+}
+
+bool MetricsExporter::Start(int port, const std::string& socketPath) {
+    if (port > 0) {
+        int listenSocket = ListenTcp(port);
+        if (listenSocket >= 0) {
+            m_listenSockets.push_back(listenSocket);
+        }
+    }
+    if (!socketPath.empty()) {
+        int listenSocket = ListenUnix(socketPath);
+        if (listenSocket >= 0) {
+            m_listenSockets.push_back(listenSocket);
+        }
+    }
+    if (m_listenSockets.empty()) {
+        return false;
+    }
+
+    m_isRunning = true;
+    m_thread = std::thread(&MetricsExporter::Serve, this);
+    return true;
+}
+
+void MetricsExporter::Stop() {
+    if (!m_isRunning) {
+        return;
+    }
+    m_isRunning = false;
+    m_thread.join();
+    for (int listenSocket : m_listenSockets) {
+        close(listenSocket);
+    }
+    m_listenSockets.clear();
+    if (!m_socketPath.empty()) {
+        unlink(m_socketPath.c_str());
+        m_socketPath.clear();
+    }
+    Logger::Log("Metrics exporter stopped after " +
+                std::to_string(m_numScrapes) + " scrapes");
+}
+
+void MetricsExporter::Serve() {
+    std::vector<pollfd> listenPolls;
+    for (int listenSocket : m_listenSockets) {
+        listenPolls.push_back({listenSocket, POLLIN, 0});
+    }
+    while (m_isRunning) {
+        if (poll(listenPolls.data(), listenPolls.size(), POLL_TIMEOUT_MS) <=
+            0) {
+            continue;
+        }
+        for (const auto& listenPoll : listenPolls) {
+            if (!(listenPoll.revents & POLLIN)) {
+                continue;
+            }
+            int clientSocket = accept(listenPoll.fd, nullptr, nullptr);
+            if (clientSocket < 0) {
+                continue;
+            }
+            Respond(clientSocket);
+            close(clientSocket);
+        }
+    }
+}
+
+void MetricsExporter::Respond(int clientSocket) {
+    // The request itself does not matter, read until its headers end so the
+    // client does not see the connection reset under its feet
+    std::string request;
+    char        buffer[1024];
+    while (request.find("\r\n\r\n") == std::string::npos &&
+           request.size() < 8192) {
+        pollfd clientPoll = {clientSocket, POLLIN, 0};
+        if (poll(&clientPoll, 1, REQUEST_TIMEOUT_MS) <= 0) {
+            break;
+        }
+        ssize_t numRead = recv(clientSocket, buffer, sizeof(buffer), 0);
+        if (numRead <= 0) {
+            break;
+        }
+        request.append(buffer, numRead);
+    }
+
+    const ExporterSnapshot* snapshot = m_snapshots.Acquire();
+    if (snapshot) {
+        m_snapshot = snapshot;
+    }
+    static const ExporterSnapshot s_emptySnapshot;
+    const std::string body =
+        Format(m_snapshot ? *m_snapshot : s_emptySnapshot);
+    const std::string response =
+        "HTTP/1.1 200 OK\r\n"
+        "Content-Type: text/plain; version=0.0.4\r\n"
+        "Content-Length: " +
+        std::to_string(body.size()) +
+        "\r\n"
+        "Connection: close\r\n\r\n" +
+        body;
+
+    std::size_t numSent = 0;
+    while (numSent < response.size()) {
+        ssize_t sent = send(clientSocket, response.data() + numSent,
+                            response.size() - numSent, MSG_NOSIGNAL);
+        if (sent <= 0) {
+            return;
+        }
+        numSent += sent;
+    }
+    m_numScrapes++;
+}
+
+// Label values are quoted, quotes, backslashes and new lines escaped
+static std::string Label(const std::string& name, const std::string& value) {
+    std::string label = name + "=\"";
+    for (char ch : value) {
+        if (ch == '\\' || ch == '"') {
+            label += '\\';
+            label += ch;
+        } else if (ch == '\n') {
+            label += "\\n";
+        } else {
+            label += ch;
+        }
+    }
+    return label + "\"";
+}
+
+static void AppendHeader(std::string& text, const char* name,
+                         const char* type, const char* help) {
+    text += std::string("# HELP ") + name + " " + help + "\n";
+    text += std::string("# TYPE ") + name + " " + type + "\n";
+}
+
+static void AppendSample(std::string& text, const char* name,
+                         const std::string& labels, double value) {
+    char number[32];
+    std::snprintf(number, sizeof(number), "%.15g", value);
+    text += name;
+    if (!labels.empty()) {
+        text += "{" + labels + "}";
+    }
+    text += std::string(" ") + number + "\n";
+}
+
+static void AppendHistogram(std::string& text, const char* name,
+                            const char* help,
+                            const DurationHistogram& histogram) {
+    AppendHeader(text, name, "histogram", help);
+    const std::string bucketName = std::string(name) + "_bucket";
+    uint64_t          cumulative = 0;
+    for (int bucket = 0; bucket < NUM_HISTOGRAM_BUCKETS; bucket++) {
+        cumulative += histogram.GetBucketCount(bucket);
+        char bound[32] = "+Inf";
+        if (bucket < NUM_HISTOGRAM_BUCKETS - 1) {
+            std::snprintf(bound, sizeof(bound), "%g",
+                          HISTOGRAM_BUCKET_BOUNDS[bucket]);
+        }
+        AppendSample(text, bucketName.c_str(), Label("le", bound),
+                     cumulative);
+    }
+    AppendSample(text, (std::string(name) + "_sum").c_str(), "",
+                 histogram.GetSum());
+    // Counted from the buckets, read one by one while the game keeps adding
+    // to them, so the count always matches the +Inf bucket
+    AppendSample(text, (std::string(name) + "_count").c_str(), "",
+                 cumulative);
+}
+
+std::string
+MetricsExporter::Format(const ExporterSnapshot& snapshot) const {
+    std::string text;
+
+    AppendHistogram(text, "engine_tick_seconds",
+                    "Time spent simulating one tick.", m_tickHistogram);
+    AppendHistogram(text, "engine_frame_seconds",
+                    "Time spent rendering one frame.", m_frameHistogram);
+
+    AppendHeader(text, "engine_ticks_total", "counter",
+                 "Simulation ticks run.");
+    AppendSample(text, "engine_ticks_total", "", snapshot.numTicks);
+    AppendHeader(text, "engine_dropped_ticks_total", "counter",
+                 "Ticks skipped because the game could not catch up.");
+    AppendSample(text, "engine_dropped_ticks_total", "",
+                 snapshot.numDroppedTicks);
+
+    AppendHeader(text, "engine_entities", "gauge",
+                 "Entities by lifecycle state.");
+    AppendSample(text, "engine_entities", Label("state", "live"),
+                 snapshot.numLiveEntities);
+    AppendSample(text, "engine_entities", Label("state", "pending_add"),
+                 snapshot.numPendingAdds);
+    AppendSample(text, "engine_entities", Label("state", "pending_kill"),
+                 snapshot.numPendingKills);
+    AppendSample(text, "engine_entities", Label("state", "recycled"),
+                 snapshot.numRecycledEntities);
+
+    AppendHeader(text, "engine_pool_slots", "gauge",
+                 "Component slots in use, indexed by entity id.");
+    for (const auto& pool : snapshot.pools) {
+        AppendSample(text, "engine_pool_slots", Label("component", pool.name),
+                     pool.numSlots);
+    }
+    AppendHeader(text, "engine_pool_capacity", "gauge",
+                 "Component slots allocated.");
+    for (const auto& pool : snapshot.pools) {
+        AppendSample(text, "engine_pool_capacity",
+                     Label("component", pool.name), pool.capacity);
+    }
+    AppendHeader(text, "engine_pool_components", "gauge",
+                 "Components attached to an entity.");
+    for (const auto& pool : snapshot.pools) {
+        AppendSample(text, "engine_pool_components",
+                     Label("component", pool.name), pool.numLive);
+    }
+    AppendHeader(text, "engine_pool_bytes", "gauge",
+                 "Memory allocated by the component pool.");
+    for (const auto& pool : snapshot.pools) {
+        AppendSample(text, "engine_pool_bytes", Label("component", pool.name),
+                     pool.numBytes);
+    }
+
+    AppendHeader(text, "engine_system_entities", "gauge",
+                 "Entities matched by each system.");
+    for (const auto& system : snapshot.systems) {
+        AppendSample(text, "engine_system_entities",
+                     Label("system", system.name), system.numEntities);
+    }
+
+    AppendHeader(text, "engine_events_total", "counter",
+                 "Events emitted on the event bus, by type.");
+    for (const auto& event : snapshot.eventTotals) {
+        AppendSample(text, "engine_events_total", Label("type", event.first),
+                     event.second);
+    }
+
+    AppendHeader(text, "engine_exporter_scrapes_total", "counter",
+                 "Requests served by the exporter before this one.");
+    AppendSample(text, "engine_exporter_scrapes_total", "", m_numScrapes);
+    return text;
+}
@@ -0,0 +1,109 @@
+#ifndef METRICS_EXPORTER_H
+#define METRICS_EXPORTER_H
+
+#include "../ECS/ECS.h"
+#include "../Threading/TripleBuffer.h"
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Upper bounds of the duration histogram buckets in seconds, the +Inf bucket
+// is implied. 60 Hz ticks land around 0.016.
+const double HISTOGRAM_BUCKET_BOUNDS[] = {0.0005, 0.001, 0.002, 0.004,
+                                          0.008,  0.016, 0.033, 0.066,
+                                          0.1,    0.25};
+const int    NUM_HISTOGRAM_BUCKETS =
+    sizeof(HISTOGRAM_BUCKET_BOUNDS) / sizeof(HISTOGRAM_BUCKET_BOUNDS[0]) + 1;
+
+// Durations counted per bucket, written by one thread and read by any other
+// without locking. A scrape may see a duration in the sum but not yet in its
+// bucket, the next one catches up.
+class DurationHistogram {
+private:
+    // Not cumulative, the exporter sums them up when it formats them
+    std::atomic<uint64_t> m_bucketCounts[NUM_HISTOGRAM_BUCKETS] = {};
+    std::atomic<uint64_t> m_sumNs{0};
+
+public:
+    void Observe(double seconds);
+
+    uint64_t GetBucketCount(int bucket) const {
+        return m_bucketCounts[bucket].load(std::memory_order_relaxed);
+    }
+    double GetSum() const {
+        return m_sumNs.load(std::memory_order_relaxed) / 1e9;
+    }
+};
+
+// Everything the exporter serves besides the histograms, filled by the
+// simulation once per tick
+struct ExporterSnapshot {
+    uint64_t                 numTicks = 0;
+    uint64_t                 numDroppedTicks = 0;
+    int                      numLiveEntities = 0;
+    int                      numPendingAdds = 0;
+    int                      numPendingKills = 0;
+    int                      numRecycledEntities = 0;
+    std::vector<PoolStats>   pools;
+    std::vector<SystemStats> systems;
+    // Events emitted since the game started, by event type
+    std::vector<std::pair<std::string, uint64_t>> eventTotals;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// MetricsExporter
+////////////////////////////////////////////////////////////////////////////////
+// Serves the engine metrics in the Prometheus text format over HTTP, on a
+// localhost TCP port or a Unix socket. The simulation publishes a snapshot
+// every tick and the histograms are atomic counters, the exporter thread
+// reads both without ever blocking the game. Every request gets the metrics
+// whatever its path, e.g. curl http://127.0.0.1:9464/metrics.
+////////////////////////////////////////////////////////////////////////////////
+class MetricsExporter {
+private:
+    std::vector<int>  m_listenSockets;
+    std::string       m_socketPath;
+    std::thread       m_thread;
+    std::atomic<bool> m_isRunning{false};
+
+    TripleBuffer<ExporterSnapshot> m_snapshots;
+    // Newest snapshot the exporter thread got, served until a newer one is
+    // published
+    const ExporterSnapshot*        m_snapshot = nullptr;
+    DurationHistogram              m_tickHistogram;
+    DurationHistogram              m_frameHistogram;
+    uint64_t                       m_numScrapes = 0;
+
+    // Returns the listening socket, -1 on failure
+    int         Listen(int family, const void* address, int addressLength);
+    int         ListenTcp(int port);
+    int         ListenUnix(const std::string& socketPath);
+    void        Serve();
+    void        Respond(int clientSocket);
+    std::string Format(const ExporterSnapshot& snapshot) const;
+
+public:
+    ~MetricsExporter();
+
+    // Listens on the TCP port, bound to 127.0.0.1 only so the endpoint is
+    // never reachable from outside, and on the Unix socket. 0 and an empty
+    // path leave either out. Fails when neither could be opened.
+    bool Start(int port, const std::string& socketPath);
+    void Stop();
+
+    // Only ever called by the simulation thread
+    ExporterSnapshot& GetWriteSnapshot() {
+        return m_snapshots.GetWriteSnapshot();
+    }
+    void Publish() { m_snapshots.Publish(); }
+
+    // Time spent simulating one tick, observed by the simulation thread
+    DurationHistogram& GetTickHistogram() { return m_tickHistogram; }
+    // Time spent rendering one frame, observed by the render thread
+    DurationHistogram& GetFrameHistogram() { return m_frameHistogram; }
+};
+
+#endif // !METRICS_EXPORTER_H
@@ -0,0 +1,162 @@
+#include "PerfCounters.h"
+#include "../Logger/Logger.h"
+#include <string>
+
+#ifdef __linux__
+#include <cerrno>
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+static const char* PERF_COUNTER_NAMES[NUM_PERF_COUNTERS] = {
+    "cycles",
+    "instructions",
+    "L1D misses",
+    "LLC misses",
+    "branch misses",
+};
+
+PerfCounters::PerfCounters() {
+    for (int counter = 0; counter < NUM_PERF_COUNTERS; counter++) {
+        m_fds[counter] = -1;
+        m_readIndices[counter] = -1;
+    }
+}
+
+PerfCounters::~PerfCounters() { Close(); }
+
+const char* PerfCounters::GetName(PerfCounter counter) {
+    return PERF_COUNTER_NAMES[counter];
+}
+
+#ifdef __linux__
+
+static void SetEvent(PerfCounter counter, perf_event_attr& attributes) {
+    attributes.type = PERF_TYPE_HARDWARE;
+    switch (counter) {
+    case PERF_COUNTER_CYCLES:
+        attributes.config = PERF_COUNT_HW_CPU_CYCLES;
+        break;
+    case PERF_COUNTER_INSTRUCTIONS:
+        attributes.config = PERF_COUNT_HW_INSTRUCTIONS;
+        break;
+    case PERF_COUNTER_L1D_MISSES:
+        attributes.type = PERF_TYPE_HW_CACHE;
+        attributes.config = PERF_COUNT_HW_CACHE_L1D |
+                            (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                            (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        break;
+    case PERF_COUNTER_LLC_MISSES:
+        attributes.config = PERF_COUNT_HW_CACHE_MISSES;
+        break;
+    case PERF_COUNTER_BRANCH_MISSES:
+        attributes.config = PERF_COUNT_HW_BRANCH_MISSES;
+        break;
+    default:
+        attributes.config = 0;
+        break;
+    }
+}
+
+bool PerfCounters::Open() {
+    Close();
+
+    int groupFd = -1;
+    for (int counter = 0; counter < NUM_PERF_COUNTERS; counter++) {
+        perf_event_attr attributes;
+        std::memset(&attributes, 0, sizeof(attributes));
+        attributes.size = sizeof(attributes);
+        SetEvent(static_cast<PerfCounter>(counter), attributes);
+        attributes.exclude_kernel = 1;
+        attributes.exclude_hv = 1;
+        attributes.read_format = PERF_FORMAT_GROUP |
+                                 PERF_FORMAT_TOTAL_TIME_ENABLED |
+                                 PERF_FORMAT_TOTAL_TIME_RUNNING;
+        // The group starts disabled and is enabled once complete
+        attributes.disabled = groupFd < 0 ? 1 : 0;
+
+        int fd = static_cast<int>(
+            syscall(SYS_perf_event_open, &attributes, 0, -1, groupFd, 0));
+        if (fd < 0) {
+            Logger::Err("Performance counter " +
+                        std::string(PERF_COUNTER_NAMES[counter]) +
+                        " unavailable: " + std::strerror(errno));
+            continue;
+        }
+        if (groupFd < 0) {
+            groupFd = fd;
+        }
+        m_fds[counter] = fd;
+        m_readIndices[counter] = m_numOpen++;
+    }
+
+    if (groupFd < 0) {
+        Logger::Err("No performance counters, reporting timings only");
+        return false;
+    }
+    ioctl(groupFd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(groupFd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    Logger::Log("Performance counters opened, " + std::to_string(m_numOpen) +
+                " of " + std::to_string(NUM_PERF_COUNTERS) + " available");
+    return true;
+}
+
+void PerfCounters::Close() {
+    for (int counter = 0; counter < NUM_PERF_COUNTERS; counter++) {
+        if (m_fds[counter] >= 0) {
+            close(m_fds[counter]);
+        }
+        m_fds[counter] = -1;
+        m_readIndices[counter] = -1;
+    }
+    m_numOpen = 0;
+}
+
+void PerfCounters::Read(PerfSample& sample) const {
+    // Group read layout: count, time enabled, time running, then the values
+    // in the order the counters were opened
+    uint64_t buffer[3 + NUM_PERF_COUNTERS];
+    int      groupFd = -1;
+    for (int fd : m_fds) {
+        if (fd >= 0) {
+            groupFd = fd;
+            break;
+        }
+    }
+    if (groupFd < 0 || read(groupFd, buffer, sizeof(buffer)) <= 0) {
+        return;
+    }
+
+    // The kernel time-slices the counters when the PMU runs short of them,
+    // scale them up to the whole time they were enabled
+    const uint64_t timeEnabled = buffer[1];
+    const uint64_t timeRunning = buffer[2];
+    for (int counter = 0; counter < NUM_PERF_COUNTERS; counter++) {
+        const int index = m_readIndices[counter];
+        if (index < 0 || static_cast<uint64_t>(index) >= buffer[0]) {
+            continue;
+        }
+        uint64_t value = buffer[3 + index];
+        if (timeRunning > 0 && timeRunning < timeEnabled) {
+            value = static_cast<uint64_t>(static_cast<double>(value) *
+                                          timeEnabled / timeRunning);
+        }
+        sample.values[counter] = value;
+    }
+}
+
+#else
+
+bool PerfCounters::Open() {
+    Logger::Err("No performance counters, reporting timings only");
+    return false;
+}
+
+void PerfCounters::Close() {}
+
+void PerfCounters::Read(PerfSample& sample) const {}
+
+#endif
@@ -0,0 +1,55 @@
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <cstdint>
+
+enum PerfCounter {
+    PERF_COUNTER_CYCLES,
+    PERF_COUNTER_INSTRUCTIONS,
+    PERF_COUNTER_L1D_MISSES,
+    PERF_COUNTER_LLC_MISSES,
+    PERF_COUNTER_BRANCH_MISSES,
+    NUM_PERF_COUNTERS
+};
+
+// Counter values since the counters were opened, 0 for the counters the CPU
+// or the kernel does not provide
+struct PerfSample {
+    uint64_t values[NUM_PERF_COUNTERS] = {};
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// PerfCounters
+////////////////////////////////////////////////////////////////////////////////
+// Hardware performance counters of the thread that opens them, read through
+// perf_event_open on Linux. They are opened as one group so every read sees
+// all of them over the same span. Counters the machine lacks are left out,
+// and without perf events at all (other systems, containers, a restrictive
+// perf_event_paranoid) Open() fails and callers are left with their timings.
+////////////////////////////////////////////////////////////////////////////////
+class PerfCounters {
+private:
+    int m_fds[NUM_PERF_COUNTERS];
+    // Position of every counter in a group read, -1 when it is missing
+    int m_readIndices[NUM_PERF_COUNTERS];
+    int m_numOpen = 0;
+
+public:
+    PerfCounters();
+    ~PerfCounters();
+
+    // Starts counting on the calling thread, kernel time excluded
+    bool Open();
+    void Close();
+    bool IsOpen() const { return m_numOpen > 0; }
+    bool IsAvailable(PerfCounter counter) const {
+        return m_readIndices[counter] >= 0;
+    }
+
+    // One system call, a few hundred nanoseconds
+    void Read(PerfSample& sample) const;
+
+    static const char* GetName(PerfCounter counter);
+};
+
+#endif // !PERF_COUNTERS_H
@@ -0,0 +1,202 @@
+#include "Profiler.h"
+#include "../Logger/Logger.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <unordered_map>
+
+static const auto s_epoch = std::chrono::steady_clock::now();
+
+// Every buffer ever created, they outlive their thread so a trace taken at
+// exit still has the loader threads
+static std::mutex                                        s_buffersMutex;
+static std::vector<std::unique_ptr<ProfileThreadBuffer>> s_buffers;
+static thread_local ProfileThreadBuffer*                 s_threadBuffer;
+
+uint64_t Profiler::Now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now() - s_epoch)
+        .count();
+}
+
+ProfileThreadBuffer& Profiler::GetThreadBuffer() {
+    if (!s_threadBuffer) {
+        std::lock_guard<std::mutex> lock(s_buffersMutex);
+        auto buffer = std::make_unique<ProfileThreadBuffer>();
+        buffer->threadId = static_cast<int>(s_buffers.size());
+        buffer->threadName = "thread " + std::to_string(buffer->threadId);
+        buffer->records =
+            std::make_unique<ProfileRecord[]>(PROFILER_BUFFER_SIZE);
+        s_threadBuffer = buffer.get();
+        s_buffers.push_back(std::move(buffer));
+    }
+    return *s_threadBuffer;
+}
+
+void Profiler::SetThreadName(const std::string& name) {
+    ProfileThreadBuffer& buffer = GetThreadBuffer();
+    std::lock_guard<std::mutex> lock(s_buffersMutex);
+    buffer.threadName = name;
+}
+
+int Profiler::BeginZone() { return GetThreadBuffer().depth++; }
+
+void Profiler::EndZone(const char* name, uint64_t start, int depth) {
+    ProfileThreadBuffer& buffer = GetThreadBuffer();
+    uint64_t             head = buffer.head.load(std::memory_order_relaxed);
+    buffer.records[head % PROFILER_BUFFER_SIZE] = {name, start, Now(), depth};
+    buffer.head.store(head + 1, std::memory_order_release);
+    buffer.depth = depth;
+}
+
+void Profiler::CopyRecords(const ProfileThreadBuffer&  buffer,
+                           std::vector<ProfileRecord>& records) {
+    const uint64_t head = buffer.head.load(std::memory_order_acquire);
+    const uint64_t first =
+        head > PROFILER_BUFFER_SIZE ? head - PROFILER_BUFFER_SIZE : 0;
+    const std::size_t base = records.size();
+    for (uint64_t i = first; i < head; i++) {
+        records.push_back(buffer.records[i % PROFILER_BUFFER_SIZE]);
+    }
+
+    // The writer kept going while we copied, drop the records it may have
+    // overwritten, including the one it may be writing right now
+    const uint64_t newHead = buffer.head.load(std::memory_order_acquire);
+    if (newHead + 1 > PROFILER_BUFFER_SIZE) {
+        const uint64_t firstValid = newHead + 1 - PROFILER_BUFFER_SIZE;
+        if (firstValid > first) {
+            const uint64_t numStale = std::min(firstValid, head) - first;
+            records.erase(records.begin() + base,
+                          records.begin() + base + numStale);
+        }
+    }
+}
+
+std::vector<ZoneSummary> Profiler::Summarize() {
+    std::vector<ZoneSummary> summaries;
+    std::lock_guard<std::mutex> lock(s_buffersMutex);
+
+    std::vector<ProfileRecord> records;
+    for (const auto& buffer : s_buffers) {
+        records.clear();
+        CopyRecords(*buffer, records);
+
+        // Zones ordered by when they were first opened, parents come before
+        // the zones nested in them
+        std::sort(records.begin(), records.end(),
+                  [](const ProfileRecord& first, const ProfileRecord& second) {
+                      return first.start < second.start;
+                  });
+
+        // The same literal may have a different address in another file
+        std::unordered_map<std::string, std::vector<uint64_t>> durations;
+        std::vector<std::pair<std::string, ProfileRecord>>      zones;
+        for (const auto& record : records) {
+            auto& zoneDurations = durations[record.name];
+            if (zoneDurations.empty()) {
+                zones.push_back({record.name, record});
+            }
+            zoneDurations.push_back(record.end - record.start);
+        }
+
+        for (const auto& zone : zones) {
+            auto&    zoneDurations = durations[zone.first];
+            uint64_t total = 0;
+            for (uint64_t duration : zoneDurations) {
+                total += duration;
+            }
+            const std::size_t count = zoneDurations.size();
+            auto p99 = zoneDurations.begin() + (count - 1) * 99 / 100;
+            std::nth_element(zoneDurations.begin(), p99, zoneDurations.end());
+
+            ZoneSummary summary;
+            summary.threadName = buffer->threadName;
+            summary.name = zone.second.name;
+            summary.depth = zone.second.depth;
+            summary.count = static_cast<int>(count);
+            summary.minMs =
+                *std::min_element(zoneDurations.begin(), zoneDurations.end()) /
+                1e6;
+            summary.avgMs = total / 1e6 / count;
+            summary.p99Ms = *p99 / 1e6;
+            summaries.push_back(summary);
+        }
+    }
+    return summaries;
+}
+
+void Profiler::LogSummary() {
+    std::string threadName;
+    for (const auto& summary : Summarize()) {
+        if (summary.threadName != threadName) {
+            threadName = summary.threadName;
+            Logger::Log("Profile of " + threadName + ":");
+        }
+        char line[256];
+        std::snprintf(line, sizeof(line),
+                      "%*s%-*s %7d calls  min %8.3f  avg %8.3f  p99 %8.3f ms",
+                      summary.depth * 2, "", 40 - summary.depth * 2,
+                      summary.name, summary.count, summary.minMs,
+                      summary.avgMs, summary.p99Ms);
+        Logger::Log(line);
+    }
+}
+
+static void WriteJsonString(std::ofstream& file, const std::string& text) {
+    file << '"';
+    for (char ch : text) {
+        if (ch == '"' || ch == '\\') {
+            file << '\\';
+        }
+        file << ch;
+    }
+    file << '"';
+}
+
+bool Profiler::WriteChromeTrace(const std::string& filePath) {
+    std::ofstream file(filePath, std::ios::trunc);
+    if (!file) {
+        Logger::Err("Error creating trace file " + filePath);
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(s_buffersMutex);
+    file << std::fixed << std::setprecision(3);
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool                       isFirst = true;
+    int                        numEvents = 0;
+    std::vector<ProfileRecord> records;
+    for (const auto& buffer : s_buffers) {
+        file << (isFirst ? "" : ",") << "\n{\"name\":\"thread_name\","
+             << "\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->threadId
+             << ",\"args\":{\"name\":";
+        WriteJsonString(file, buffer->threadName);
+        file << "}}";
+        isFirst = false;
+
+        records.clear();
+        CopyRecords(*buffer, records);
+        for (const auto& record : records) {
+            // Complete events, timestamps in microseconds
+            file << ",\n{\"name\":";
+            WriteJsonString(file, record.name);
+            file << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->threadId
+                 << ",\"ts\":" << record.start / 1000.0
+                 << ",\"dur\":" << (record.end - record.start) / 1000.0
+                 << "}";
+        }
+        numEvents += records.size();
+    }
+    file << "\n]}\n";
+
+    if (!file) {
+        Logger::Err("Error writing trace file " + filePath);
+        return false;
+    }
+    Logger::Log("Profile trace with " + std::to_string(numEvents) +
+                " zones written to " + filePath);
+    return true;
+}
@@ -0,0 +1,105 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Zones kept per thread, the oldest are overwritten once it is full
+const int PROFILER_BUFFER_SIZE = 1 << 16;
+
+// A finished zone, times in nanoseconds since the profiler started
+struct ProfileRecord {
+    const char* name;
+    uint64_t    start;
+    uint64_t    end;
+    // Number of zones open around this one on the same thread
+    int depth;
+};
+
+// Single writer ring buffer owned by one thread, readers copy it without
+// stopping the writer
+struct ProfileThreadBuffer {
+    std::string                      threadName;
+    int                              threadId;
+    std::unique_ptr<ProfileRecord[]> records;
+    // Total number of records ever written, the newest is at head - 1
+    std::atomic<uint64_t> head{0};
+    int                   depth = 0;
+};
+
+// Durations of one zone over what is left in its thread buffer
+struct ZoneSummary {
+    std::string threadName;
+    const char* name;
+    int         depth;
+    int         count;
+    double      minMs;
+    double      avgMs;
+    double      p99Ms;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Profiler
+////////////////////////////////////////////////////////////////////////////////
+// Records nested timed zones into a ring buffer per thread. Recording never
+// locks, the lock is only taken the first time a thread records a zone and
+// when the buffers are read. Zones are opened with the PROFILE_ZONE macro,
+// which compiles to nothing unless ENABLE_PROFILER is defined (make
+// PROFILE=1).
+////////////////////////////////////////////////////////////////////////////////
+class Profiler {
+private:
+    static ProfileThreadBuffer& GetThreadBuffer();
+    static void CopyRecords(const ProfileThreadBuffer&  buffer,
+                            std::vector<ProfileRecord>& records);
+
+public:
+    static uint64_t Now();
+
+    // Shows up as the thread name in traces and summaries
+    static void SetThreadName(const std::string& name);
+
+    // Returns the depth of the new zone
+    static int  BeginZone();
+    static void EndZone(const char* name, uint64_t start, int depth);
+
+    // Min, average and 99th percentile of every zone still in the buffers,
+    // the zones of each thread in the order they were first opened
+    static std::vector<ZoneSummary> Summarize();
+    static void                     LogSummary();
+
+    // Chrome trace event JSON, opens in chrome://tracing and Perfetto
+    static bool WriteChromeTrace(const std::string& filePath);
+};
+
+// Times the enclosing scope
+class ProfileZone {
+private:
+    const char* m_name;
+    uint64_t    m_start;
+    int         m_depth;
+
+public:
+    ProfileZone(const char* name) : m_name(name) {
+        m_depth = Profiler::BeginZone();
+        m_start = Profiler::Now();
+    }
+    ~ProfileZone() { Profiler::EndZone(m_name, m_start, m_depth); }
+};
+
+#ifdef ENABLE_PROFILER
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+// The name must be a string literal, only the pointer is recorded
+#define PROFILE_ZONE(name)                                                     \
+    ProfileZone PROFILE_CONCAT(profileZone, __LINE__)(name)
+#define PROFILE_THREAD(name) Profiler::SetThreadName(name)
+#else
+#define PROFILE_ZONE(name)
+#define PROFILE_THREAD(name)
+#endif
+
+#endif // !PROFILER_H
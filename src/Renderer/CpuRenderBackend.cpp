@@ -0,0 +1,156 @@
+#include "./CpuRenderBackend.h"
+#include "../Logger/Logger.h"
+#include <cstring>
+
+CpuRenderBackend::CpuRenderBackend(const std::string& captureDirectory,
+                                   int                numThreads)
+    : SoftwareRenderBackend(captureDirectory), m_blitter(numThreads) {
+    Logger::Log("CPU render backend blending rows with " +
+                std::string(SpriteBlitter::GetSimdPath()));
+}
+
+void CpuRenderBackend::Destroy() {
+    m_pendingCommands.clear();
+    m_cpuTextures.clear();
+    SoftwareRenderBackend::Destroy();
+}
+
+CpuRenderBackend::CpuTexture*
+CpuRenderBackend::AddCpuTexture(SDL_Texture* texture, int width, int height) {
+    auto cpuTexture = std::make_unique<CpuTexture>();
+    cpuTexture->pixels.resize(width * height);
+    cpuTexture->surface = {cpuTexture->pixels.data(), width, height, width};
+
+    CpuTexture* result = cpuTexture.get();
+    m_cpuTextures[texture] = std::move(cpuTexture);
+    return result;
+}
+
+SDL_Texture* CpuRenderBackend::CreateTexture(SDL_Surface* surface) {
+    SDL_Texture* texture = SoftwareRenderBackend::CreateTexture(surface);
+    if (!texture) {
+        return nullptr;
+    }
+
+    SDL_Surface* converted =
+        SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_ARGB8888, 0);
+    if (!converted) {
+        return texture;
+    }
+
+    CpuTexture* cpuTexture = AddCpuTexture(texture, surface->w, surface->h);
+    for (int y = 0; y < converted->h; y++) {
+        std::memcpy(&cpuTexture->pixels[y * converted->w],
+                    static_cast<Uint8*>(converted->pixels) +
+                        y * converted->pitch,
+                    converted->w * sizeof(Uint32));
+    }
+    SDL_FreeSurface(converted);
+    return texture;
+}
+
+SDL_Texture* CpuRenderBackend::CreateRenderTarget(int width, int height) {
+    SDL_Texture* texture =
+        SoftwareRenderBackend::CreateRenderTarget(width, height);
+    if (texture) {
+        AddCpuTexture(texture, width, height);
+    }
+    return texture;
+}
+
+void CpuRenderBackend::DestroyTexture(SDL_Texture* texture) {
+    Flush();
+    m_cpuTextures.erase(texture);
+    SoftwareRenderBackend::DestroyTexture(texture);
+}
+
+void CpuRenderBackend::SetRenderTarget(SDL_Texture* target) {
+    Flush();
+
+    // Whatever SDL drew into the target we are leaving has to be copied
+    // back, the blitter reads the CPU side pixels
+    if (m_target) {
+        auto cpuTexture = m_cpuTextures.find(m_target);
+        if (cpuTexture != m_cpuTextures.end()) {
+            const BlitSurface& surface = cpuTexture->second->surface;
+            SDL_RenderReadPixels(m_renderer, NULL, SDL_PIXELFORMAT_ARGB8888,
+                                 surface.pixels,
+                                 surface.pitch * sizeof(Uint32));
+        }
+    }
+
+    SoftwareRenderBackend::SetRenderTarget(target);
+    m_target = target;
+}
+
+void CpuRenderBackend::Clear(SDL_Color color) {
+    // Anything still pending would be cleared anyway
+    m_pendingCommands.clear();
+    SoftwareRenderBackend::Clear(color);
+}
+
+void CpuRenderBackend::Flush() {
+    if (m_pendingCommands.empty()) {
+        return;
+    }
+
+    // SDL may still hold queued draws for the surface we are about to touch
+    SDL_RenderFlush(m_renderer);
+
+    SDL_Surface* screen = GetSurface();
+    BlitSurface  target = {static_cast<Uint32*>(screen->pixels), screen->w,
+                           screen->h,
+                           screen->pitch / static_cast<int>(sizeof(Uint32))};
+    m_blitter.Blit(target, m_pendingCommands);
+    m_pendingCommands.clear();
+}
+
+void CpuRenderBackend::Copy(SDL_Texture* texture, const SDL_Rect* srcRect,
+                            const SDL_Rect* dstRect, double angle,
+                            SDL_Color color) {
+    // The blitter neither rotates nor tints, SDL draws those
+    const bool isTinted = color.r != 255 || color.g != 255 || color.b != 255 ||
+                          color.a != 255;
+    auto       cpuTexture = m_cpuTextures.find(texture);
+    if (angle != 0.0 || isTinted || m_target ||
+        cpuTexture == m_cpuTextures.end()) {
+        Flush();
+        SoftwareRenderBackend::Copy(texture, srcRect, dstRect, angle,
+                                    color);
+        return;
+    }
+
+    const BlitSurface& source = cpuTexture->second->surface;
+    const SDL_Surface* screen = GetSurface();
+
+    BlitCommand command;
+    command.source = &source;
+    command.srcRect = srcRect ? *srcRect
+                              : SDL_Rect{0, 0, source.width, source.height};
+    command.dstRect = dstRect ? *dstRect
+                              : SDL_Rect{0, 0, screen->w, screen->h};
+    if (command.dstRect.w <= 0 || command.dstRect.h <= 0) {
+        return;
+    }
+
+    // Source rects reaching outside the texture are clipped by SDL
+    const SDL_Rect& src = command.srcRect;
+    if (src.x < 0 || src.y < 0 || src.x + src.w > source.width ||
+        src.y + src.h > source.height) {
+        Flush();
+        SoftwareRenderBackend::Copy(texture, srcRect, dstRect, angle,
+                                    color);
+        return;
+    }
+    m_pendingCommands.push_back(command);
+}
+
+void CpuRenderBackend::Rect(const SDL_Rect& rect, SDL_Color color) {
+    Flush();
+    SoftwareRenderBackend::Rect(rect, color);
+}
+
+void CpuRenderBackend::PresentFrame() {
+    Flush();
+    SoftwareRenderBackend::PresentFrame();
+}
@@ -0,0 +1,59 @@
+#ifndef CPU_RENDER_BACKEND_H
+#define CPU_RENDER_BACKEND_H
+
+#include "./SoftwareRenderBackend.h"
+#include "./SpriteBlitter.h"
+#include <SDL2/SDL.h>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+// CpuRenderBackend
+////////////////////////////////////////////////////////////////////////////////
+// Software backend where sprite copies are composited by the SpriteBlitter
+// instead of SDL's generic blitters. Every texture keeps an ARGB copy of its
+// pixels on the CPU side. Copies that the blitter can't do (rotated sprites,
+// drawing into render targets) flush the pending sprites and go through the
+// SDL software renderer, so the draw order is kept.
+////////////////////////////////////////////////////////////////////////////////
+class CpuRenderBackend : public SoftwareRenderBackend {
+private:
+    struct CpuTexture {
+        std::vector<Uint32> pixels;
+        BlitSurface         surface;
+    };
+
+    std::unordered_map<SDL_Texture*, std::unique_ptr<CpuTexture>> m_cpuTextures;
+
+    SpriteBlitter            m_blitter;
+    std::vector<BlitCommand> m_pendingCommands;
+    SDL_Texture*             m_target = nullptr;
+
+    CpuTexture* AddCpuTexture(SDL_Texture* texture, int width, int height);
+    void        Flush();
+
+    void Copy(SDL_Texture* texture, const SDL_Rect* srcRect,
+              const SDL_Rect* dstRect, double angle,
+              SDL_Color color) override;
+    void Rect(const SDL_Rect& rect, SDL_Color color) override;
+    void PresentFrame() override;
+
+public:
+    // 0 threads composites with one thread per hardware core
+    CpuRenderBackend(const std::string& captureDirectory = "",
+                     int                numThreads = 0);
+    virtual ~CpuRenderBackend() override = default;
+
+    void Destroy() override;
+
+    SDL_Texture* CreateTexture(SDL_Surface* surface) override;
+    SDL_Texture* CreateRenderTarget(int width, int height) override;
+    void         DestroyTexture(SDL_Texture* texture) override;
+
+    void SetRenderTarget(SDL_Texture* target) override;
+    void Clear(SDL_Color color) override;
+};
+
+#endif // !CPU_RENDER_BACKEND_H
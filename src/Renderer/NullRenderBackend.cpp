@@ -0,0 +1,68 @@
+#include "./NullRenderBackend.h"
+#include "../Logger/Logger.h"
+
+bool NullRenderBackend::Initialize(int width, int height) {
+    Logger::Log("Null render backend initialized with " +
+                std::to_string(width) + "x" + std::to_string(height));
+    return true;
+}
+
+void NullRenderBackend::Destroy() {
+    m_textures.clear();
+    m_commands.clear();
+    m_lastFrameCommands.clear();
+}
+
+SDL_Texture* NullRenderBackend::MakeTexture(int width, int height) {
+    auto         nullTexture = std::make_unique<NullTexture>();
+    SDL_Texture* texture = reinterpret_cast<SDL_Texture*>(nullTexture.get());
+    nullTexture->width = width;
+    nullTexture->height = height;
+    m_textures.emplace(texture, std::move(nullTexture));
+    return texture;
+}
+
+SDL_Texture* NullRenderBackend::CreateTexture(SDL_Surface* surface) {
+    return MakeTexture(surface->w, surface->h);
+}
+
+SDL_Texture* NullRenderBackend::CreateRenderTarget(int width, int height) {
+    return MakeTexture(width, height);
+}
+
+void NullRenderBackend::DestroyTexture(SDL_Texture* texture) {
+    m_textures.erase(texture);
+}
+
+void NullRenderBackend::Copy(SDL_Texture* texture, const SDL_Rect* srcRect,
+                             const SDL_Rect* dstRect, double angle,
+                             SDL_Color color) {
+    DrawCommand command;
+    command.type = DRAW_COMMAND_TEXTURE;
+    command.texture = texture;
+    command.target = m_target;
+    command.srcRect = srcRect ? *srcRect : SDL_Rect{0, 0, 0, 0};
+    command.dstRect = dstRect ? *dstRect : SDL_Rect{0, 0, 0, 0};
+    command.angle = angle;
+    command.color = color;
+    m_commands.push_back(command);
+}
+
+void NullRenderBackend::Rect(const SDL_Rect& rect, SDL_Color color) {
+    DrawCommand command;
+    command.type = DRAW_COMMAND_RECT;
+    command.texture = nullptr;
+    command.target = m_target;
+    command.srcRect = {0, 0, 0, 0};
+    command.dstRect = rect;
+    command.angle = 0.0;
+    command.color = color;
+    m_commands.push_back(command);
+}
+
+void NullRenderBackend::PresentFrame() {
+    m_totalDrawCalls += m_commands.size();
+    m_frameCount++;
+    m_lastFrameCommands.swap(m_commands);
+    m_commands.clear();
+}
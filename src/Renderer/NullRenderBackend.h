@@ -0,0 +1,77 @@
+#ifndef NULL_RENDER_BACKEND_H
+#define NULL_RENDER_BACKEND_H
+
+#include "./RenderBackend.h"
+#include <SDL2/SDL.h>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+enum DrawCommandType { DRAW_COMMAND_TEXTURE, DRAW_COMMAND_RECT };
+
+// A draw call as it was issued to the null backend
+struct DrawCommand {
+    DrawCommandType type;
+    SDL_Texture*    texture;
+    SDL_Texture*    target;
+    SDL_Rect        srcRect;
+    SDL_Rect        dstRect;
+    double          angle;
+    SDL_Color       color;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// NullRenderBackend
+////////////////////////////////////////////////////////////////////////////////
+// Does not draw anything, it records the draw commands of the current frame
+// and counts them. Textures are small placeholder objects that only remember
+// their size, the SDL_Texture pointers handed out are never given to SDL.
+////////////////////////////////////////////////////////////////////////////////
+class NullRenderBackend : public RenderBackend {
+private:
+    struct NullTexture {
+        int width;
+        int height;
+    };
+
+    std::unordered_map<SDL_Texture*, std::unique_ptr<NullTexture>> m_textures;
+
+    SDL_Texture*             m_target = nullptr;
+    std::vector<DrawCommand> m_commands;
+    std::vector<DrawCommand> m_lastFrameCommands;
+    long long                m_totalDrawCalls = 0;
+    int                      m_frameCount = 0;
+
+    SDL_Texture* MakeTexture(int width, int height);
+
+    void Copy(SDL_Texture* texture, const SDL_Rect* srcRect,
+              const SDL_Rect* dstRect, double angle,
+              SDL_Color color) override;
+    void Rect(const SDL_Rect& rect, SDL_Color color) override;
+    void PresentFrame() override;
+
+public:
+    NullRenderBackend() = default;
+    virtual ~NullRenderBackend() override = default;
+
+    bool Initialize(int width, int height) override;
+    void Destroy() override;
+
+    SDL_Texture* CreateTexture(SDL_Surface* surface) override;
+    SDL_Texture* CreateRenderTarget(int width, int height) override;
+    void         DestroyTexture(SDL_Texture* texture) override;
+    bool         SupportsRenderTargets() const override { return true; }
+    int          GetMaxTextureSize() const override { return 0; }
+
+    void SetRenderTarget(SDL_Texture* target) override { m_target = target; }
+    void Clear(SDL_Color color) override {}
+
+    // Commands issued between the last two Present() calls
+    const std::vector<DrawCommand>& GetFrameCommands() const {
+        return m_lastFrameCommands;
+    }
+    long long GetTotalDrawCalls() const { return m_totalDrawCalls; }
+    int       GetFrameCount() const { return m_frameCount; }
+};
+
+#endif // !NULL_RENDER_BACKEND_H
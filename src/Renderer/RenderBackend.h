@@ -0,0 +1,86 @@
+#ifndef RENDER_BACKEND_H
+#define RENDER_BACKEND_H
+
+#include <SDL2/SDL.h>
+
+enum RenderBackendType {
+    RENDER_BACKEND_SDL,
+    RENDER_BACKEND_SOFTWARE,
+    RENDER_BACKEND_CPU,
+    RENDER_BACKEND_NULL
+};
+
+// Draw color that leaves a texture untouched, any other one tints it
+const SDL_Color COLOR_WHITE = {255, 255, 255, 255};
+
+// Counters of a single frame, reset by every Present()
+struct RenderStats {
+    int drawCalls = 0;
+    int textureSwitches = 0;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// RenderBackend
+////////////////////////////////////////////////////////////////////////////////
+// Everything the engine draws goes through a render backend, so the same
+// frame can be presented to a window, to an offscreen surface or just be
+// recorded and counted on hosts without a GPU.
+////////////////////////////////////////////////////////////////////////////////
+class RenderBackend {
+private:
+    RenderStats  m_frameStats;
+    RenderStats  m_lastFrameStats;
+    SDL_Texture* m_lastTexture = nullptr;
+
+    virtual void Copy(SDL_Texture* texture, const SDL_Rect* srcRect,
+                      const SDL_Rect* dstRect, double angle,
+                      SDL_Color color) = 0;
+    virtual void Rect(const SDL_Rect& rect, SDL_Color color) = 0;
+    virtual void PresentFrame() = 0;
+
+public:
+    virtual ~RenderBackend() = default;
+
+    virtual bool Initialize(int width, int height) = 0;
+    virtual void Destroy() = 0;
+
+    // Textures are owned by the backend and released by Destroy() unless
+    // destroyed earlier
+    virtual SDL_Texture* CreateTexture(SDL_Surface* surface) = 0;
+    virtual SDL_Texture* CreateRenderTarget(int width, int height) = 0;
+    virtual void         DestroyTexture(SDL_Texture* texture) = 0;
+    virtual bool         SupportsRenderTargets() const = 0;
+    virtual int          GetMaxTextureSize() const = 0;
+
+    // Passing nullptr goes back to drawing on the screen
+    virtual void SetRenderTarget(SDL_Texture* target) = 0;
+    virtual void Clear(SDL_Color color) = 0;
+
+    void DrawTexture(SDL_Texture* texture, const SDL_Rect* srcRect,
+                     const SDL_Rect* dstRect, double angle = 0.0,
+                     SDL_Color color = COLOR_WHITE) {
+        m_frameStats.drawCalls++;
+        if (texture != m_lastTexture) {
+            m_frameStats.textureSwitches++;
+            m_lastTexture = texture;
+        }
+        Copy(texture, srcRect, dstRect, angle, color);
+    }
+
+    void DrawRect(const SDL_Rect& rect, SDL_Color color) {
+        m_frameStats.drawCalls++;
+        Rect(rect, color);
+    }
+
+    void Present() {
+        PresentFrame();
+        m_lastFrameStats = m_frameStats;
+        m_frameStats = RenderStats();
+        m_lastTexture = nullptr;
+    }
+
+    // Counters of the last presented frame
+    const RenderStats& GetFrameStats() const { return m_lastFrameStats; }
+};
+
+#endif // !RENDER_BACKEND_H
@@ -0,0 +1,52 @@
+#ifndef RENDER_SNAPSHOT_H
+#define RENDER_SNAPSHOT_H
+
+#include "../AssetStore/AssetStore.h"
+#include "../Threading/TripleBuffer.h"
+#include <SDL2/SDL.h>
+#include <vector>
+
+// A sprite or glyph copy resolved down to what the backend needs
+struct SpriteDrawCommand {
+    SDL_Texture* texture;
+    SDL_Rect     srcRect;
+    SDL_Rect     dstRect;
+    // Where dstRect was at the start of the tick, the sprite is drawn in
+    // between depending on how far the renderer is into the next tick
+    SDL_Point    previousPosition;
+    double       angle;
+    int          zIndex;
+    SDL_Color    color;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// RenderSnapshot
+////////////////////////////////////////////////////////////////////////////////
+// Everything needed to draw one simulated frame. It is built at the end of a
+// simulation tick and never changes afterwards, so it can be rendered while
+// the next tick is already running.
+////////////////////////////////////////////////////////////////////////////////
+struct RenderSnapshot {
+    SDL_Rect                       camera;
+    SDL_Rect                       previousCamera;
+    // Where the tile layer draws its tiles from, resolved by the simulation
+    // since the AssetStore is not read from the render thread
+    TextureRegion                  tileset;
+    // Sprites and text, sorted in draw order
+    std::vector<SpriteDrawCommand> sprites;
+    // Collider outlines, only filled in debug mode
+    std::vector<SDL_Rect> colliders;
+    // Performance counter when the tick that produced the snapshot started
+    Uint64 simulationStart = 0;
+    // Performance counter the simulation clock had reached once the tick was
+    // done, the time elapsed since tells how far to blend towards it
+    Uint64 simulationTime = 0;
+    // AssetStore frame the snapshot was built in, textures evicted up to it
+    // are no longer referenced
+    Uint64 assetFrame = 0;
+};
+
+// Hands snapshots from the simulation to the renderer
+using SnapshotBuffer = TripleBuffer<RenderSnapshot>;
+
+#endif // !RENDER_SNAPSHOT_H
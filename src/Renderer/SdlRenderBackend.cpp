@@ -0,0 +1,98 @@
+#include "./SdlRenderBackend.h"
+#include "../Logger/Logger.h"
+#include <algorithm>
+
+bool SdlRenderBackend::Initialize(int width, int height) {
+    m_window =
+        SDL_CreateWindow(NULL, SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED,
+                         width, height, SDL_WINDOW_BORDERLESS);
+    if (!m_window) {
+        Logger::Err("Error creating SDL window.");
+        return false;
+    }
+
+    m_renderer = SDL_CreateRenderer(m_window, -1, 0);
+    if (!m_renderer) {
+        Logger::Err("Error creating SDL renderer.");
+        return false;
+    }
+    SDL_SetWindowFullscreen(m_window, SDL_WINDOW_FULLSCREEN_DESKTOP);
+    SDL_RenderSetLogicalSize(m_renderer, width, height);
+    return true;
+}
+
+void SdlRenderBackend::Destroy() {
+    // Destroying the renderer releases every texture it created
+    if (m_renderer) {
+        SDL_DestroyRenderer(m_renderer);
+        m_renderer = nullptr;
+    }
+    if (m_window) {
+        SDL_DestroyWindow(m_window);
+        m_window = nullptr;
+    }
+}
+
+SDL_Texture* SdlRenderBackend::CreateTexture(SDL_Surface* surface) {
+    return SDL_CreateTextureFromSurface(m_renderer, surface);
+}
+
+SDL_Texture* SdlRenderBackend::CreateRenderTarget(int width, int height) {
+    SDL_Texture* texture =
+        SDL_CreateTexture(m_renderer, SDL_PIXELFORMAT_RGBA8888,
+                          SDL_TEXTUREACCESS_TARGET, width, height);
+    if (texture) {
+        SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+    }
+    return texture;
+}
+
+void SdlRenderBackend::DestroyTexture(SDL_Texture* texture) {
+    SDL_DestroyTexture(texture);
+}
+
+bool SdlRenderBackend::SupportsRenderTargets() const {
+    return SDL_RenderTargetSupported(m_renderer);
+}
+
+int SdlRenderBackend::GetMaxTextureSize() const {
+    SDL_RendererInfo info;
+    if (SDL_GetRendererInfo(m_renderer, &info) != 0 ||
+        info.max_texture_width <= 0) {
+        // The software renderer has no limit
+        return 0;
+    }
+    return std::min(info.max_texture_width, info.max_texture_height);
+}
+
+void SdlRenderBackend::SetRenderTarget(SDL_Texture* target) {
+    SDL_SetRenderTarget(m_renderer, target);
+}
+
+void SdlRenderBackend::Clear(SDL_Color color) {
+    SDL_SetRenderDrawColor(m_renderer, color.r, color.g, color.b, color.a);
+    SDL_RenderClear(m_renderer);
+}
+
+void SdlRenderBackend::Copy(SDL_Texture* texture, const SDL_Rect* srcRect,
+                            const SDL_Rect* dstRect, double angle,
+                            SDL_Color color) {
+    // The modulation is a property of the texture, set it on every copy so a
+    // tinted draw does not leak into the next one. SDL records it with the
+    // queued copy, batching is not affected.
+    SDL_SetTextureColorMod(texture, color.r, color.g, color.b);
+    SDL_SetTextureAlphaMod(texture, color.a);
+    if (angle == 0.0) {
+        SDL_RenderCopy(m_renderer, texture, srcRect, dstRect);
+    } else {
+        SDL_RenderCopyEx(m_renderer, texture, srcRect, dstRect, angle, NULL,
+                         SDL_FLIP_NONE);
+    }
+}
+
+void SdlRenderBackend::Rect(const SDL_Rect& rect, SDL_Color color) {
+    SDL_SetRenderDrawColor(m_renderer, color.r, color.g, color.b, color.a);
+    SDL_RenderDrawRect(m_renderer, &rect);
+}
+
+void SdlRenderBackend::PresentFrame() { SDL_RenderPresent(m_renderer); }
@@ -0,0 +1,36 @@
+#ifndef SDL_RENDER_BACKEND_H
+#define SDL_RENDER_BACKEND_H
+
+#include "./RenderBackend.h"
+#include <SDL2/SDL.h>
+
+// Draws with the default SDL_Renderer of a fullscreen borderless window
+class SdlRenderBackend : public RenderBackend {
+protected:
+    SDL_Window*   m_window = nullptr;
+    SDL_Renderer* m_renderer = nullptr;
+
+    void Copy(SDL_Texture* texture, const SDL_Rect* srcRect,
+              const SDL_Rect* dstRect, double angle,
+              SDL_Color color) override;
+    void Rect(const SDL_Rect& rect, SDL_Color color) override;
+    void PresentFrame() override;
+
+public:
+    SdlRenderBackend() = default;
+    virtual ~SdlRenderBackend() override = default;
+
+    bool Initialize(int width, int height) override;
+    void Destroy() override;
+
+    SDL_Texture* CreateTexture(SDL_Surface* surface) override;
+    SDL_Texture* CreateRenderTarget(int width, int height) override;
+    void         DestroyTexture(SDL_Texture* texture) override;
+    bool         SupportsRenderTargets() const override;
+    int          GetMaxTextureSize() const override;
+
+    void SetRenderTarget(SDL_Texture* target) override;
+    void Clear(SDL_Color color) override;
+};
+
+#endif // !SDL_RENDER_BACKEND_H
@@ -0,0 +1,56 @@
+#include "./SoftwareRenderBackend.h"
+#include "../Logger/Logger.h"
+#include <SDL2/SDL_image.h>
+#include <cstdio>
+
+SoftwareRenderBackend::SoftwareRenderBackend(
+    const std::string& captureDirectory) {
+    m_captureDirectory = captureDirectory;
+}
+
+bool SoftwareRenderBackend::Initialize(int width, int height) {
+    m_surface = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32,
+                                               SDL_PIXELFORMAT_ARGB8888);
+    if (!m_surface) {
+        Logger::Err("Error creating offscreen surface: " +
+                    std::string(SDL_GetError()));
+        return false;
+    }
+
+    m_renderer = SDL_CreateSoftwareRenderer(m_surface);
+    if (!m_renderer) {
+        Logger::Err("Error creating SDL software renderer: " +
+                    std::string(SDL_GetError()));
+        return false;
+    }
+    return true;
+}
+
+void SoftwareRenderBackend::Destroy() {
+    SdlRenderBackend::Destroy();
+    if (m_surface) {
+        SDL_FreeSurface(m_surface);
+        m_surface = nullptr;
+    }
+}
+
+bool SoftwareRenderBackend::CaptureFrame(const std::string& filePath) const {
+    if (IMG_SavePNG(m_surface, filePath.c_str()) != 0) {
+        Logger::Err("Error capturing frame to " + filePath + ": " +
+                    std::string(IMG_GetError()));
+        return false;
+    }
+    return true;
+}
+
+void SoftwareRenderBackend::PresentFrame() {
+    SDL_RenderPresent(m_renderer);
+
+    if (!m_captureDirectory.empty()) {
+        char fileName[32];
+        std::snprintf(fileName, sizeof(fileName), "/frame_%05d.png",
+                      m_frameNumber);
+        CaptureFrame(m_captureDirectory + fileName);
+    }
+    m_frameNumber++;
+}
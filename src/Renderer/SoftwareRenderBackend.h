@@ -0,0 +1,33 @@
+#ifndef SOFTWARE_RENDER_BACKEND_H
+#define SOFTWARE_RENDER_BACKEND_H
+
+#include "./SdlRenderBackend.h"
+#include <SDL2/SDL.h>
+#include <string>
+
+// Draws with SDL's software renderer into an offscreen surface, no window or
+// GPU needed. Presented frames can optionally be saved as PNG files.
+class SoftwareRenderBackend : public SdlRenderBackend {
+private:
+    SDL_Surface* m_surface = nullptr;
+    std::string  m_captureDirectory;
+    int          m_frameNumber = 0;
+
+protected:
+    void PresentFrame() override;
+
+public:
+    // Frames are captured to <captureDirectory>/frame_<number>.png, an empty
+    // directory disables the capture
+    SoftwareRenderBackend(const std::string& captureDirectory = "");
+    virtual ~SoftwareRenderBackend() override = default;
+
+    bool Initialize(int width, int height) override;
+    void Destroy() override;
+
+    // The offscreen surface holding the last presented frame
+    SDL_Surface* GetSurface() const { return m_surface; }
+    bool         CaptureFrame(const std::string& filePath) const;
+};
+
+#endif // !SOFTWARE_RENDER_BACKEND_H
@@ -0,0 +1,329 @@
+#include "./SpriteBlitter.h"
+#include <algorithm>
+#include <cstdint>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define SPRITE_BLITTER_AVX2
+#endif
+
+namespace {
+
+// Exact floor(x / 255) for x <= 255 * 255
+inline Uint32 DivideBy255(Uint32 x) { return (x + 1 + (x >> 8)) >> 8; }
+
+void BlendRowScalar(Uint32* dst, const Uint32* src, int count) {
+    for (int i = 0; i < count; i++) {
+        const Uint32 s = src[i];
+        const Uint32 d = dst[i];
+        const Uint32 srcA = s >> 24;
+        const Uint32 invA = 255 - srcA;
+
+        Uint32 result = (srcA + DivideBy255((d >> 24) * invA)) << 24;
+        for (int shift = 0; shift < 24; shift += 8) {
+            const Uint32 srcC = (s >> shift) & 0xFF;
+            const Uint32 dstC = (d >> shift) & 0xFF;
+            result |= (DivideBy255(srcC * srcA) + DivideBy255(dstC * invA))
+                      << shift;
+        }
+        dst[i] = result;
+    }
+}
+
+#if defined(__SSE2__)
+inline __m128i DivideBy255(__m128i x) {
+    const __m128i one = _mm_set1_epi16(1);
+    return _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(x, one),
+                                        _mm_srli_epi16(x, 8)),
+                          8);
+}
+
+// Blends two pixels unpacked to 16 bits per channel
+inline __m128i BlendPixels(__m128i s, __m128i d) {
+    const __m128i alphaLanes = _mm_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0);
+    const __m128i full = _mm_set1_epi16(255);
+
+    __m128i srcA = _mm_shufflelo_epi16(s, _MM_SHUFFLE(3, 3, 3, 3));
+    srcA = _mm_shufflehi_epi16(srcA, _MM_SHUFFLE(3, 3, 3, 3));
+    const __m128i invA = _mm_sub_epi16(full, srcA);
+
+    // The alpha channel itself is not premultiplied
+    const __m128i srcFactor = _mm_or_si128(_mm_andnot_si128(alphaLanes, srcA),
+                                           _mm_and_si128(alphaLanes, full));
+
+    return _mm_add_epi16(DivideBy255(_mm_mullo_epi16(s, srcFactor)),
+                         DivideBy255(_mm_mullo_epi16(d, invA)));
+}
+
+void BlendRowSse2(Uint32* dst, const Uint32* src, int count) {
+    const __m128i zero = _mm_setzero_si128();
+    int           i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m128i s =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        const __m128i d = _mm_loadu_si128(reinterpret_cast<__m128i*>(dst + i));
+
+        const __m128i lo = BlendPixels(_mm_unpacklo_epi8(s, zero),
+                                       _mm_unpacklo_epi8(d, zero));
+        const __m128i hi = BlendPixels(_mm_unpackhi_epi8(s, zero),
+                                       _mm_unpackhi_epi8(d, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i),
+                         _mm_packus_epi16(lo, hi));
+    }
+    BlendRowScalar(dst + i, src + i, count - i);
+}
+#endif
+
+#if defined(SPRITE_BLITTER_AVX2)
+__attribute__((target("avx2"))) inline __m256i DivideBy255Avx2(__m256i x) {
+    const __m256i one = _mm256_set1_epi16(1);
+    return _mm256_srli_epi16(
+        _mm256_add_epi16(_mm256_add_epi16(x, one), _mm256_srli_epi16(x, 8)),
+        8);
+}
+
+__attribute__((target("avx2"))) inline __m256i BlendPixelsAvx2(__m256i s,
+                                                                __m256i d) {
+    const __m256i alphaLanes = _mm256_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0, -1,
+                                                0, 0, 0, -1, 0, 0, 0);
+    const __m256i full = _mm256_set1_epi16(255);
+
+    __m256i srcA = _mm256_shufflelo_epi16(s, _MM_SHUFFLE(3, 3, 3, 3));
+    srcA = _mm256_shufflehi_epi16(srcA, _MM_SHUFFLE(3, 3, 3, 3));
+    const __m256i invA = _mm256_sub_epi16(full, srcA);
+
+    const __m256i srcFactor =
+        _mm256_or_si256(_mm256_andnot_si256(alphaLanes, srcA),
+                        _mm256_and_si256(alphaLanes, full));
+
+    return _mm256_add_epi16(
+        DivideBy255Avx2(_mm256_mullo_epi16(s, srcFactor)),
+        DivideBy255Avx2(_mm256_mullo_epi16(d, invA)));
+}
+
+__attribute__((target("avx2"))) void BlendRowAvx2(Uint32* dst,
+                                                  const Uint32* src,
+                                                  int           count) {
+    const __m256i zero = _mm256_setzero_si256();
+    int           i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m256i s =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        const __m256i d =
+            _mm256_loadu_si256(reinterpret_cast<__m256i*>(dst + i));
+
+        // Unpack and pack both work within 128-bit lanes, so the pixels come
+        // back in their original order
+        const __m256i lo = BlendPixelsAvx2(_mm256_unpacklo_epi8(s, zero),
+                                           _mm256_unpacklo_epi8(d, zero));
+        const __m256i hi = BlendPixelsAvx2(_mm256_unpackhi_epi8(s, zero),
+                                           _mm256_unpackhi_epi8(d, zero));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i),
+                            _mm256_packus_epi16(lo, hi));
+    }
+    BlendRowScalar(dst + i, src + i, count - i);
+}
+#endif
+
+using BlendRowFunction = void (*)(Uint32*, const Uint32*, int);
+
+struct BlendRowPath {
+    BlendRowFunction function;
+    const char*      name;
+};
+
+BlendRowPath PickBlendRowPath() {
+#if defined(SPRITE_BLITTER_AVX2)
+    if (__builtin_cpu_supports("avx2")) {
+        return {BlendRowAvx2, "avx2"};
+    }
+#endif
+#if defined(__SSE2__)
+    return {BlendRowSse2, "sse2"};
+#else
+    return {BlendRowScalar, "scalar"};
+#endif
+}
+
+const BlendRowPath s_blendRow = PickBlendRowPath();
+
+bool Intersect(const SDL_Rect& a, const SDL_Rect& b, SDL_Rect& result) {
+    const int x0 = std::max(a.x, b.x);
+    const int y0 = std::max(a.y, b.y);
+    const int x1 = std::min(a.x + a.w, b.x + b.w);
+    const int y1 = std::min(a.y + a.h, b.y + b.h);
+    result = {x0, y0, x1 - x0, y1 - y0};
+    return x1 > x0 && y1 > y0;
+}
+
+} // namespace
+
+SpriteBlitter::SpriteBlitter(int numThreads) {
+    if (numThreads <= 0) {
+        numThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    // The calling thread composites tiles too
+    for (int i = 1; i < numThreads; i++) {
+        m_workers.emplace_back(&SpriteBlitter::WorkerLoop, this);
+    }
+}
+
+SpriteBlitter::~SpriteBlitter() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_isStopping = true;
+    }
+    m_workAvailable.notify_all();
+    for (auto& worker : m_workers) {
+        worker.join();
+    }
+}
+
+const char* SpriteBlitter::GetSimdPath() { return s_blendRow.name; }
+
+void SpriteBlitter::BlitClipped(const BlitSurface& target,
+                                const BlitCommand& command,
+                                const SDL_Rect&    clipRect) {
+    const SDL_Rect& srcRect = command.srcRect;
+    const SDL_Rect& dstRect = command.dstRect;
+    if (srcRect.w <= 0 || srcRect.h <= 0) {
+        return;
+    }
+
+    SDL_Rect rect;
+    if (!Intersect(dstRect, clipRect, rect)) {
+        return;
+    }
+
+    // Nearest-neighbour stepping in 16.16 fixed point, sampling the centre of
+    // each destination pixel. The mapping is computed on the unclipped rect so
+    // the result does not depend on how the sprite was split across tiles.
+    const std::int64_t incX = (std::int64_t(srcRect.w) << 16) / dstRect.w;
+    const std::int64_t incY = (std::int64_t(srcRect.h) << 16) / dstRect.h;
+
+    thread_local std::vector<Uint32> rowBuffer;
+    if (incX != (1 << 16)) {
+        rowBuffer.resize(rect.w);
+    }
+
+    const BlitSurface& source = *command.source;
+    for (int y = rect.y; y < rect.y + rect.h; y++) {
+        const int srcY =
+            srcRect.y + static_cast<int>((incY / 2 + (y - dstRect.y) * incY) >>
+                                         16);
+        const Uint32* srcRow = source.pixels + srcY * source.pitch;
+        Uint32*       dstRow = target.pixels + y * target.pitch + rect.x;
+
+        const Uint32* srcPixels;
+        if (incX == (1 << 16)) {
+            srcPixels = srcRow + srcRect.x + (rect.x - dstRect.x);
+        } else {
+            std::int64_t posX = incX / 2 + (rect.x - dstRect.x) * incX;
+            for (int x = 0; x < rect.w; x++, posX += incX) {
+                rowBuffer[x] = srcRow[srcRect.x + (posX >> 16)];
+            }
+            srcPixels = rowBuffer.data();
+        }
+        s_blendRow.function(dstRow, srcPixels, rect.w);
+    }
+}
+
+void SpriteBlitter::CompositeTile(int tile) {
+    const int tileX = (tile % m_numTileCols) * BLIT_TILE_SIZE;
+    const int tileY = (tile / m_numTileCols) * BLIT_TILE_SIZE;
+    SDL_Rect  tileRect = {tileX, tileY,
+                          std::min(BLIT_TILE_SIZE, m_target->width - tileX),
+                          std::min(BLIT_TILE_SIZE, m_target->height - tileY)};
+
+    for (int index : m_bins[tile]) {
+        BlitClipped(*m_target, (*m_commands)[index], tileRect);
+    }
+}
+
+void SpriteBlitter::CompositeTiles() {
+    const int numTiles = m_numTileCols * m_numTileRows;
+    for (int tile = m_nextTile.fetch_add(1); tile < numTiles;
+         tile = m_nextTile.fetch_add(1)) {
+        if (!m_bins[tile].empty()) {
+            CompositeTile(tile);
+        }
+    }
+}
+
+void SpriteBlitter::WorkerLoop() {
+    int generation = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_workAvailable.wait(lock, [this, generation] {
+                return m_isStopping || m_generation != generation;
+            });
+            if (m_isStopping) {
+                return;
+            }
+            generation = m_generation;
+        }
+
+        CompositeTiles();
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (--m_busyWorkers == 0) {
+            m_workDone.notify_one();
+        }
+    }
+}
+
+void SpriteBlitter::Blit(const BlitSurface&              target,
+                         const std::vector<BlitCommand>& commands) {
+    if (commands.empty()) {
+        return;
+    }
+
+    // Bin every command into the tiles its destination overlaps
+    m_numTileCols = (target.width + BLIT_TILE_SIZE - 1) / BLIT_TILE_SIZE;
+    m_numTileRows = (target.height + BLIT_TILE_SIZE - 1) / BLIT_TILE_SIZE;
+    m_bins.resize(m_numTileCols * m_numTileRows);
+    for (auto& bin : m_bins) {
+        bin.clear();
+    }
+
+    const SDL_Rect screen = {0, 0, target.width, target.height};
+    for (int index = 0; index < static_cast<int>(commands.size()); index++) {
+        SDL_Rect rect;
+        if (!Intersect(commands[index].dstRect, screen, rect)) {
+            continue;
+        }
+        const int lastCol = (rect.x + rect.w - 1) / BLIT_TILE_SIZE;
+        const int lastRow = (rect.y + rect.h - 1) / BLIT_TILE_SIZE;
+        for (int row = rect.y / BLIT_TILE_SIZE; row <= lastRow; row++) {
+            for (int col = rect.x / BLIT_TILE_SIZE; col <= lastCol; col++) {
+                m_bins[row * m_numTileCols + col].push_back(index);
+            }
+        }
+    }
+
+    m_target = &target;
+    m_commands = &commands;
+    m_nextTile = 0;
+
+    if (m_workers.empty()) {
+        CompositeTiles();
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_busyWorkers = static_cast<int>(m_workers.size());
+        m_generation++;
+    }
+    m_workAvailable.notify_all();
+
+    CompositeTiles();
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_workDone.wait(lock, [this] { return m_busyWorkers == 0; });
+}
@@ -0,0 +1,152 @@
+#include "InputRecording.h"
+#include "../Logger/Logger.h"
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+static void WriteVarint(std::vector<char>& bytes, std::uint64_t value) {
+    while (value >= 0x80) {
+        bytes.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    bytes.push_back(static_cast<char>(value));
+}
+
+// Returns false past the end of the data or on a varint too long to be one
+static bool ReadVarint(const std::vector<char>& bytes, std::size_t& offset,
+                       std::uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (offset >= bytes.size()) {
+            return false;
+        }
+        const auto byte = static_cast<std::uint8_t>(bytes[offset++]);
+        value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void InputRecording::Start(int tickRate, int level, int hashInterval) {
+    m_tickRate = tickRate;
+    m_level = level;
+    m_hashInterval = hashInterval;
+    m_numTicks = 0;
+    m_keys.clear();
+    m_stateHashes.clear();
+    m_nextKey = 0;
+}
+
+void InputRecording::GetKeys(std::uint64_t tick,
+                             std::vector<SDL_Keycode>& keys) {
+    while (m_nextKey < m_keys.size() && m_keys[m_nextKey].tick <= tick) {
+        if (m_keys[m_nextKey].tick == tick) {
+            keys.push_back(m_keys[m_nextKey].key);
+        }
+        m_nextKey++;
+    }
+}
+
+bool InputRecording::Save(const std::string& filePath) const {
+    std::ofstream file(filePath, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        Logger::Err("Error creating input recording " + filePath);
+        return false;
+    }
+
+    InputRecordingHeader header = {};
+    std::memcpy(header.magic, INPUT_RECORDING_MAGIC, 4);
+    header.version = INPUT_RECORDING_VERSION;
+    header.tickRate = m_tickRate;
+    header.level = m_level;
+    header.hashInterval = m_hashInterval;
+    header.numKeys = m_keys.size();
+    header.numHashes = m_stateHashes.size();
+    header.numTicks = m_numTicks;
+
+    std::vector<char> body;
+    std::uint64_t     previousTick = 0;
+    for (const auto& key : m_keys) {
+        WriteVarint(body, key.tick - previousTick);
+        WriteVarint(body, static_cast<std::uint32_t>(key.key));
+        previousTick = key.tick;
+    }
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(body.data(), body.size());
+    file.write(reinterpret_cast<const char*>(m_stateHashes.data()),
+               m_stateHashes.size() * sizeof(std::uint64_t));
+    if (!file) {
+        Logger::Err("Error writing input recording " + filePath);
+        return false;
+    }
+    Logger::Log("Input recording of " + std::to_string(m_numTicks) +
+                " ticks, " + std::to_string(m_keys.size()) + " keys and " +
+                std::to_string(m_stateHashes.size()) +
+                " state hashes written to " + filePath);
+    return true;
+}
+
+bool InputRecording::Load(const std::string& filePath) {
+    std::ifstream file(filePath, std::ios::binary);
+    if (!file) {
+        Logger::Err("Error opening input recording " + filePath);
+        return false;
+    }
+    std::vector<char> bytes((std::istreambuf_iterator<char>(file)),
+                            std::istreambuf_iterator<char>());
+
+    InputRecordingHeader header;
+    if (bytes.size() < sizeof(header)) {
+        Logger::Err("Input recording " + filePath + " is truncated");
+        return false;
+    }
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    if (std::memcmp(header.magic, INPUT_RECORDING_MAGIC, 4) != 0 ||
+        header.version != INPUT_RECORDING_VERSION) {
+        Logger::Err(filePath + " is not an input recording of this version");
+        return false;
+    }
+
+    Start(header.tickRate, header.level, header.hashInterval);
+    m_numTicks = header.numTicks;
+
+    std::size_t   offset = sizeof(header);
+    std::uint64_t tick = 0;
+    // Every key takes at least 2 bytes, a corrupt count must not reserve
+    // more than the file could hold
+    if (header.numKeys > (bytes.size() - offset) / 2) {
+        Logger::Err("Input recording " + filePath + " is truncated");
+        return false;
+    }
+    m_keys.reserve(header.numKeys);
+    for (std::uint32_t i = 0; i < header.numKeys; i++) {
+        std::uint64_t tickDelta;
+        std::uint64_t key;
+        if (!ReadVarint(bytes, offset, tickDelta) ||
+            !ReadVarint(bytes, offset, key)) {
+            Logger::Err("Input recording " + filePath + " is truncated");
+            return false;
+        }
+        tick += tickDelta;
+        m_keys.push_back(
+            {tick, static_cast<SDL_Keycode>(static_cast<std::uint32_t>(key))});
+    }
+
+    if (bytes.size() - offset < header.numHashes * sizeof(std::uint64_t)) {
+        Logger::Err("Input recording " + filePath + " is truncated");
+        return false;
+    }
+    m_stateHashes.resize(header.numHashes);
+    std::memcpy(m_stateHashes.data(), bytes.data() + offset,
+                header.numHashes * sizeof(std::uint64_t));
+
+    Logger::Log("Input recording " + filePath + " loaded, " +
+                std::to_string(m_numTicks) + " ticks at " +
+                std::to_string(m_tickRate) + " Hz, level " +
+                std::to_string(m_level) + ", " +
+                std::to_string(m_keys.size()) + " keys");
+    return true;
+}
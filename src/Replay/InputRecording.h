@@ -0,0 +1,108 @@
+#ifndef INPUT_RECORDING_H
+#define INPUT_RECORDING_H
+
+#include <SDL2/SDL.h>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+// Input recording file format
+////////////////////////////////////////////////////////////////////////////////
+// A header, the keys pressed during the session and the state hashes taken
+// along it. Every key is two varints, the ticks since the previous key and the
+// key code, so a recording is a few bytes per key press. The hashes are
+// little-endian 64-bit values, one every hashInterval ticks.
+////////////////////////////////////////////////////////////////////////////////
+const char          INPUT_RECORDING_MAGIC[4] = {'G', 'R', 'E', 'C'};
+const std::uint32_t INPUT_RECORDING_VERSION = 1;
+
+struct InputRecordingHeader {
+    char          magic[4];
+    std::uint32_t version;
+    // The session only plays out the same at the same tick rate and level
+    std::uint32_t tickRate;
+    std::int32_t  level;
+    std::uint32_t hashInterval;
+    std::uint32_t numKeys;
+    std::uint32_t numHashes;
+    std::uint32_t reserved;
+    std::uint64_t numTicks;
+};
+
+static_assert(sizeof(InputRecordingHeader) == 40, "Recording header layout");
+
+// A key as the simulation turned it into a KeyPressedEvent
+struct RecordedKey {
+    std::uint64_t tick;
+    SDL_Keycode   key;
+};
+
+// FNV-1a over the bytes of the values added
+class StateHasher {
+private:
+    std::uint64_t m_hash = 14695981039346656037ULL;
+
+public:
+    void Add(const void* data, std::size_t numBytes) {
+        const auto* bytes = static_cast<const std::uint8_t*>(data);
+        for (std::size_t i = 0; i < numBytes; i++) {
+            m_hash = (m_hash ^ bytes[i]) * 1099511628211ULL;
+        }
+    }
+    template <typename T>
+    void Add(const T& value) {
+        Add(&value, sizeof(value));
+    }
+    std::uint64_t GetHash() const { return m_hash; }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// InputRecording
+////////////////////////////////////////////////////////////////////////////////
+// The input of a session tagged with the simulation tick it was handled on.
+// The simulation is deterministic given its input, so feeding the keys back
+// on the same ticks replays the session exactly; the state hashes recorded
+// along the way tell whether it did.
+////////////////////////////////////////////////////////////////////////////////
+class InputRecording {
+private:
+    std::uint32_t m_tickRate = 0;
+    std::int32_t  m_level = 0;
+    std::uint32_t m_hashInterval = 0;
+    std::uint64_t m_numTicks = 0;
+
+    // In tick order
+    std::vector<RecordedKey>   m_keys;
+    std::vector<std::uint64_t> m_stateHashes;
+    // First key not handed out yet while replaying
+    std::size_t m_nextKey = 0;
+
+public:
+    void Start(int tickRate, int level, int hashInterval);
+
+    int           GetTickRate() const { return m_tickRate; }
+    int           GetLevel() const { return m_level; }
+    int           GetHashInterval() const { return m_hashInterval; }
+    std::uint64_t GetNumTicks() const { return m_numTicks; }
+    void SetNumTicks(std::uint64_t numTicks) { m_numTicks = numTicks; }
+
+    void AddKey(std::uint64_t tick, SDL_Keycode key) {
+        m_keys.push_back({tick, key});
+    }
+    // Appends the keys recorded for the tick, ticks are asked for in order
+    void GetKeys(std::uint64_t tick, std::vector<SDL_Keycode>& keys);
+
+    // The hash after every hashInterval ticks, index 0 after the first
+    void AddStateHash(std::uint64_t hash) { m_stateHashes.push_back(hash); }
+    int  GetNumStateHashes() const { return m_stateHashes.size(); }
+    std::uint64_t GetStateHash(int index) const {
+        return m_stateHashes[index];
+    }
+
+    bool Save(const std::string& filePath) const;
+    bool Load(const std::string& filePath);
+};
+
+#endif // !INPUT_RECORDING_H
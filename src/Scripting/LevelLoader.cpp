@@ -0,0 +1,168 @@
+#include "./LevelLoader.h"
+#include "../Logger/Logger.h"
+
+// The helpers read a field of the table at the given stack index and leave
+// the stack as they found it
+
+static double GetNumber(lua_State* state, int table, const char* key,
+                        double fallback) {
+    lua_getfield(state, table, key);
+    double value = lua_isnumber(state, -1) ? lua_tonumber(state, -1) : fallback;
+    lua_pop(state, 1);
+    return value;
+}
+
+static bool GetBoolean(lua_State* state, int table, const char* key,
+                       bool fallback) {
+    lua_getfield(state, table, key);
+    bool value = lua_isnil(state, -1) ? fallback : lua_toboolean(state, -1);
+    lua_pop(state, 1);
+    return value;
+}
+
+static std::string GetString(lua_State* state, int table, const char* key) {
+    lua_getfield(state, table, key);
+    const char* value = lua_tostring(state, -1);
+    std::string result = value ? value : "";
+    lua_pop(state, 1);
+    return result;
+}
+
+static glm::vec2 GetVec2(lua_State* state, int table, const char* key,
+                         glm::vec2 fallback) {
+    lua_getfield(state, table, key);
+    if (lua_istable(state, -1)) {
+        int vector = lua_gettop(state);
+        fallback = glm::vec2(GetNumber(state, vector, "x", fallback.x),
+                             GetNumber(state, vector, "y", fallback.y));
+    }
+    lua_pop(state, 1);
+    return fallback;
+}
+
+// Pushes the field and returns its index if it is a table, pushes nothing
+// and returns 0 otherwise
+static int PushTable(lua_State* state, int table, const char* key) {
+    lua_getfield(state, table, key);
+    if (!lua_istable(state, -1)) {
+        lua_pop(state, 1);
+        return 0;
+    }
+    return lua_gettop(state);
+}
+
+static void ReadEntity(lua_State* state, int entity,
+                       const ScriptEngine& scriptEngine,
+                       const AssetStore& assetStore, EntityRecord& record) {
+    record.group = GetString(state, entity, "group");
+
+    const int components = PushTable(state, entity, "components");
+    if (!components) {
+        return;
+    }
+
+    if (int table = PushTable(state, components, "transform")) {
+        record.transform.emplace(
+            GetVec2(state, table, "position", glm::vec2(0)),
+            GetVec2(state, table, "scale", glm::vec2(1)),
+            GetNumber(state, table, "rotation", 0.0));
+        lua_pop(state, 1);
+    }
+    if (int table = PushTable(state, components, "rigidbody")) {
+        record.rigidBody.emplace(
+            GetVec2(state, table, "velocity", glm::vec2(0)));
+        lua_pop(state, 1);
+    }
+    if (int table = PushTable(state, components, "sprite")) {
+        record.sprite.emplace(
+            assetStore.GetTextureHandle(
+                GetString(state, table, "texture_asset_id")),
+            GetNumber(state, table, "width", 0),
+            GetNumber(state, table, "height", 0),
+            GetNumber(state, table, "z_index", 0),
+            GetBoolean(state, table, "fixed", false),
+            GetNumber(state, table, "src_rect_x", 0),
+            GetNumber(state, table, "src_rect_y", 0));
+        lua_pop(state, 1);
+    }
+    if (int table = PushTable(state, components, "animation")) {
+        record.animation.emplace(GetNumber(state, table, "num_frames", 1),
+                                 GetNumber(state, table, "speed_rate", 1),
+                                 GetBoolean(state, table, "loop", true));
+        lua_pop(state, 1);
+    }
+    if (int table = PushTable(state, components, "boxcollider")) {
+        record.boxCollider.emplace(
+            GetNumber(state, table, "width", 0),
+            GetNumber(state, table, "height", 0),
+            GetVec2(state, table, "offset", glm::vec2(0)));
+        lua_pop(state, 1);
+    }
+    if (int table = PushTable(state, components, "health")) {
+        record.health.emplace(
+            GetNumber(state, table, "health_percentage", 100));
+        lua_pop(state, 1);
+    }
+    if (int table = PushTable(state, components, "projectile_emitter")) {
+        std::string sound = GetString(state, table, "sound_asset_id");
+        record.projectileEmitter.emplace(
+            GetVec2(state, table, "projectile_velocity", glm::vec2(0)),
+            GetNumber(state, table, "repeat_frequency", 0),
+            GetNumber(state, table, "projectile_duration", 10000),
+            GetNumber(state, table, "hit_percentage_damage", 10),
+            GetBoolean(state, table, "friendly", false),
+            assetStore.GetTextureHandle(
+                GetString(state, table, "texture_asset_id")),
+            sound.empty() ? INVALID_SOUND_HANDLE
+                          : assetStore.GetSoundHandle(sound));
+        lua_pop(state, 1);
+    }
+    if (int table = PushTable(state, components, "script")) {
+        std::string name = GetString(state, table, "behaviour");
+        int         behaviour = scriptEngine.GetBehaviour(name);
+        if (behaviour < 0) {
+            Logger::Err("Behaviour " + name + " was not found");
+        }
+        record.script.emplace(behaviour);
+        lua_pop(state, 1);
+    }
+
+    lua_pop(state, 1);
+}
+
+bool LevelLoader::Load(ScriptEngine& scriptEngine, const AssetStore& assetStore,
+                       const std::string&         filePath,
+                       std::vector<EntityRecord>& records) {
+    if (!scriptEngine.RunFile(filePath)) {
+        return false;
+    }
+
+    lua_State* state = scriptEngine.GetState();
+    const int  top = lua_gettop(state);
+    lua_getglobal(state, "Level");
+    if (!lua_istable(state, -1)) {
+        Logger::Err("Level script " + filePath + " has no Level table");
+        lua_settop(state, top);
+        return false;
+    }
+
+    const int entities = PushTable(state, top + 1, "entities");
+    if (entities) {
+        // Any key order works, pikuma style levels start counting at 0
+        records.reserve(records.size() + lua_rawlen(state, entities) + 1);
+        lua_pushnil(state);
+        while (lua_next(state, entities) != 0) {
+            if (lua_istable(state, -1)) {
+                records.emplace_back();
+                ReadEntity(state, lua_gettop(state), scriptEngine, assetStore,
+                           records.back());
+            }
+            lua_pop(state, 1);
+        }
+    }
+    lua_settop(state, top);
+
+    Logger::Log("Level script " + filePath + " describes " +
+                std::to_string(records.size()) + " entities");
+    return true;
+}
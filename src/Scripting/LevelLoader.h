@@ -0,0 +1,41 @@
+#ifndef LEVEL_LOADER_H
+#define LEVEL_LOADER_H
+
+#include "../AssetStore/AssetStore.h"
+#include "../World/EntityRecord.h"
+#include "./ScriptEngine.h"
+#include <string>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+// LevelLoader
+////////////////////////////////////////////////////////////////////////////////
+// Reads the entities of a level description written in Lua into records, the
+// game hands them to the world streaming system that spawns them cell by
+// cell. The description is a global table:
+//
+//     Level = {
+//         entities = {
+//             {
+//                 group = "enemies",
+//                 components = {
+//                     transform = { position = { x = 500, y = 10 } },
+//                     sprite = { texture_asset_id = "tank-image",
+//                                width = 32, height = 32, z_index = 1 },
+//                     script = { behaviour = "patrol" },
+//                 },
+//             },
+//         },
+//     }
+//
+// The file runs as a regular script first, so it can register behaviours
+// and build the entity list with loops.
+////////////////////////////////////////////////////////////////////////////////
+class LevelLoader {
+public:
+    static bool Load(ScriptEngine& scriptEngine, const AssetStore& assetStore,
+                     const std::string&         filePath,
+                     std::vector<EntityRecord>& records);
+};
+
+#endif // !LEVEL_LOADER_H
@@ -0,0 +1,207 @@
+#include "./ScriptEngine.h"
+#include "../Components/HealthComponent.h"
+#include "../Components/RigidBodyComponent.h"
+#include "../Components/TransformComponent.h"
+#include "../Logger/Logger.h"
+
+// Arrays of a view, in the order they sit on the stack after the view
+static const char* const s_viewFields[] = {"id", "x",        "y",     "vx",
+                                           "vy", "rotation", "health"};
+static const int         NUM_VIEW_FIELDS = 7;
+
+ScriptEngine::~ScriptEngine() { Destroy(); }
+
+bool ScriptEngine::Initialize() {
+    m_state = luaL_newstate();
+    if (!m_state) {
+        Logger::Err("Error creating the Lua state");
+        return false;
+    }
+    luaL_openlibs(m_state);
+
+    // behaviour(name, function) finds the engine through its upvalue
+    lua_pushlightuserdata(m_state, this);
+    lua_pushcclosure(m_state, &ScriptEngine::RegisterBehaviour, 1);
+    lua_setglobal(m_state, "behaviour");
+    return true;
+}
+
+void ScriptEngine::Destroy() {
+    if (m_state) {
+        lua_close(m_state);
+    }
+    m_state = nullptr;
+    m_behaviours.clear();
+    m_behaviourIds.clear();
+}
+
+int ScriptEngine::RegisterBehaviour(lua_State* state) {
+    auto* engine =
+        static_cast<ScriptEngine*>(lua_touserdata(state, lua_upvalueindex(1)));
+    std::string name = luaL_checkstring(state, 1);
+    luaL_checktype(state, 2, LUA_TFUNCTION);
+
+    // Registering a name again replaces the function, entities keep their id
+    auto existing = engine->m_behaviourIds.find(name);
+    if (existing != engine->m_behaviourIds.end()) {
+        Behaviour& behaviour = engine->m_behaviours[existing->second];
+        luaL_unref(state, LUA_REGISTRYINDEX, behaviour.function);
+        lua_pushvalue(state, 2);
+        behaviour.function = luaL_ref(state, LUA_REGISTRYINDEX);
+        return 0;
+    }
+
+    Behaviour behaviour;
+    behaviour.name = name;
+    lua_pushvalue(state, 2);
+    behaviour.function = luaL_ref(state, LUA_REGISTRYINDEX);
+
+    lua_createtable(state, 0, NUM_VIEW_FIELDS + 1);
+    for (auto field : s_viewFields) {
+        lua_newtable(state);
+        lua_setfield(state, -2, field);
+    }
+    lua_pushinteger(state, 0);
+    lua_setfield(state, -2, "count");
+    behaviour.view = luaL_ref(state, LUA_REGISTRYINDEX);
+
+    engine->m_behaviourIds.emplace(name, engine->m_behaviours.size());
+    engine->m_behaviours.push_back(behaviour);
+    return 0;
+}
+
+bool ScriptEngine::Call(int numArgs, const std::string& context) {
+    if (lua_pcall(m_state, numArgs, 0, 0) != LUA_OK) {
+        Logger::Err("Lua error in " + context + ": " +
+                    std::string(lua_tostring(m_state, -1)));
+        lua_pop(m_state, 1);
+        return false;
+    }
+    return true;
+}
+
+bool ScriptEngine::RunFile(const std::string& filePath) {
+    if (luaL_loadfile(m_state, filePath.c_str()) != LUA_OK) {
+        Logger::Err("Error loading script " + filePath + ": " +
+                    std::string(lua_tostring(m_state, -1)));
+        lua_pop(m_state, 1);
+        return false;
+    }
+    return Call(0, filePath);
+}
+
+bool ScriptEngine::RunString(const std::string& code) {
+    if (luaL_loadstring(m_state, code.c_str()) != LUA_OK) {
+        Logger::Err("Error loading script: " +
+                    std::string(lua_tostring(m_state, -1)));
+        lua_pop(m_state, 1);
+        return false;
+    }
+    return Call(0, "script");
+}
+
+int ScriptEngine::GetBehaviour(const std::string& name) const {
+    auto behaviour = m_behaviourIds.find(name);
+    if (behaviour == m_behaviourIds.end()) {
+        return -1;
+    }
+    return behaviour->second;
+}
+
+void ScriptEngine::RunBehaviour(int behaviourId,
+                                const std::vector<Entity>& entities,
+                                double                     deltaTime) {
+    Behaviour& behaviour = m_behaviours[behaviourId];
+    if (behaviour.function == LUA_NOREF || entities.empty()) {
+        return;
+    }
+    Uint64 start = SDL_GetPerformanceCounter();
+
+    // The view and its arrays stay on the stack for the whole call
+    const int top = lua_gettop(m_state);
+    lua_rawgeti(m_state, LUA_REGISTRYINDEX, behaviour.view);
+    const int view = top + 1;
+    for (auto field : s_viewFields) {
+        lua_getfield(m_state, view, field);
+    }
+    const int ids = view + 1;
+
+    lua_pushinteger(m_state, entities.size());
+    lua_setfield(m_state, view, "count");
+    for (size_t i = 0; i < entities.size(); i++) {
+        const Entity entity = entities[i];
+        const auto&  tf = entity.GetComponent<TransformComponent>();
+        glm::vec2    velocity(0);
+        if (entity.HasComponent<RigidBodyComponent>()) {
+            velocity = entity.GetComponent<RigidBodyComponent>().velocity;
+        }
+        int health = 0;
+        if (entity.HasComponent<HealthComponent>()) {
+            health = entity.GetComponent<HealthComponent>().healthPercentage;
+        }
+
+        const lua_Integer index = i + 1;
+        lua_pushinteger(m_state, entity.GetId());
+        lua_rawseti(m_state, ids, index);
+        lua_pushnumber(m_state, tf.position.x);
+        lua_rawseti(m_state, ids + 1, index);
+        lua_pushnumber(m_state, tf.position.y);
+        lua_rawseti(m_state, ids + 2, index);
+        lua_pushnumber(m_state, velocity.x);
+        lua_rawseti(m_state, ids + 3, index);
+        lua_pushnumber(m_state, velocity.y);
+        lua_rawseti(m_state, ids + 4, index);
+        lua_pushnumber(m_state, tf.rotation);
+        lua_rawseti(m_state, ids + 5, index);
+        lua_pushinteger(m_state, health);
+        lua_rawseti(m_state, ids + 6, index);
+    }
+
+    lua_rawgeti(m_state, LUA_REGISTRYINDEX, behaviour.function);
+    lua_pushvalue(m_state, view);
+    lua_pushnumber(m_state, deltaTime);
+    if (!Call(2, behaviour.name)) {
+        Logger::Err("Behaviour " + behaviour.name + " disabled");
+        luaL_unref(m_state, LUA_REGISTRYINDEX, behaviour.function);
+        behaviour.function = LUA_NOREF;
+        lua_settop(m_state, top);
+        return;
+    }
+
+    // Read back everything but the ids
+    for (size_t i = 0; i < entities.size(); i++) {
+        const Entity      entity = entities[i];
+        const lua_Integer index = i + 1;
+        double            values[NUM_VIEW_FIELDS];
+        for (int field = 1; field < NUM_VIEW_FIELDS; field++) {
+            lua_rawgeti(m_state, ids + field, index);
+            values[field] = lua_tonumber(m_state, -1);
+            lua_pop(m_state, 1);
+        }
+
+        auto& tf = entity.GetComponent<TransformComponent>();
+        tf.position = glm::vec2(values[1], values[2]);
+        tf.rotation = values[5];
+        if (entity.HasComponent<RigidBodyComponent>()) {
+            entity.GetComponent<RigidBodyComponent>().velocity =
+                glm::vec2(values[3], values[4]);
+        }
+        if (entity.HasComponent<HealthComponent>()) {
+            entity.GetComponent<HealthComponent>().healthPercentage =
+                static_cast<int>(values[6]);
+        }
+    }
+    lua_settop(m_state, top);
+
+    behaviour.stats.numCalls++;
+    behaviour.stats.numEntities += entities.size();
+    behaviour.stats.ticks += SDL_GetPerformanceCounter() - start;
+}
+
+std::size_t ScriptEngine::GetMemoryUsage() const {
+    if (!m_state) {
+        return 0;
+    }
+    return static_cast<std::size_t>(lua_gc(m_state, LUA_GCCOUNT, 0)) * 1024 +
+           lua_gc(m_state, LUA_GCCOUNTB, 0);
+}
@@ -0,0 +1,90 @@
+#ifndef SCRIPT_ENGINE_H
+#define SCRIPT_ENGINE_H
+
+#include "../ECS/ECS.h"
+#include <SDL2/SDL.h>
+#include <lua5.3/lua.hpp>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Counters of one behaviour since the engine was initialized
+struct BehaviourStats {
+    long long numCalls = 0;
+    long long numEntities = 0;
+    // Performance counter ticks spent filling the view, running the script
+    // and writing the view back
+    Uint64 ticks = 0;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// ScriptEngine
+////////////////////////////////////////////////////////////////////////////////
+// Owns the Lua state. Scripts register behaviours with
+//
+//     behaviour("name", function(view, dt) ... end)
+//
+// and a behaviour is called once per tick for all the entities using it. The
+// view holds one array per field (id, x, y, vx, vy, rotation, health) and the
+// number of entities in count, so the script loops over plain Lua arrays and
+// never calls back into C++. Views are created once per behaviour and their
+// arrays reused every tick, running behaviours allocates nothing once the
+// arrays reached their size.
+////////////////////////////////////////////////////////////////////////////////
+class ScriptEngine {
+private:
+    struct Behaviour {
+        std::string name;
+        // Registry references to the function and its view table
+        int            function;
+        int            view;
+        BehaviourStats stats;
+    };
+
+    lua_State*                           m_state = nullptr;
+    std::vector<Behaviour>               m_behaviours;
+    std::unordered_map<std::string, int> m_behaviourIds;
+
+    static int RegisterBehaviour(lua_State* state);
+
+    // Runs the chunk on top of the stack, logging the error if it fails
+    bool Call(int numArgs, const std::string& context);
+
+public:
+    ScriptEngine() = default;
+    ~ScriptEngine();
+
+    ScriptEngine(const ScriptEngine&) = delete;
+    ScriptEngine& operator=(const ScriptEngine&) = delete;
+
+    bool Initialize();
+    void Destroy();
+
+    lua_State* GetState() const { return m_state; }
+
+    bool RunFile(const std::string& filePath);
+    bool RunString(const std::string& code);
+
+    // -1 if no script registered the behaviour
+    int GetBehaviour(const std::string& name) const;
+
+    // Fills the view with the entities, calls the behaviour and writes the
+    // view back into their components. A behaviour raising an error is
+    // disabled.
+    void RunBehaviour(int behaviour, const std::vector<Entity>& entities,
+                      double deltaTime);
+
+    int GetNumBehaviours() const { return m_behaviours.size(); }
+
+    const std::string& GetBehaviourName(int behaviour) const {
+        return m_behaviours[behaviour].name;
+    }
+    const BehaviourStats& GetBehaviourStats(int behaviour) const {
+        return m_behaviours[behaviour].stats;
+    }
+
+    // Bytes in use by the Lua state
+    std::size_t GetMemoryUsage() const;
+};
+
+#endif // !SCRIPT_ENGINE_H
@@ -4,7 +4,7 @@
 #include "../Components/AnimationComponent.h"
 #include "../Components/SpriteComponent.h"
 #include "../ECS/ECS.h"
-#include <SDL2/SDL.h>
+#include "../Profiler/Profiler.h"
 
 class AnimationSystem : public System {
 public:
@@ -13,12 +13,17 @@ public:
         RequireComponent<SpriteComponent>();
     }
 
-    void Update() {
+    // The frame shown only depends on the simulation time, in milliseconds
+    void Update(int simulationTime) {
+        PROFILE_ZONE("AnimationSystem::Update");
         for (auto entity : GetSystemEntities()) {
             auto& animation = entity.GetComponent<AnimationComponent>();
             auto& sprite = entity.GetComponent<SpriteComponent>();
 
-            animation.currentFrame = ((SDL_GetTicks() - animation.startTime) *
+            if (animation.startTime < 0) {
+                animation.startTime = simulationTime;
+            }
+            animation.currentFrame = ((simulationTime - animation.startTime) *
                                       animation.frameRateSpeed / 1000) %
                                      animation.numFrames;
             sprite.srcRect.x = animation.currentFrame * sprite.width;
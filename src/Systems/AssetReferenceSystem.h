@@ -0,0 +1,100 @@
+#ifndef ASSET_REFERENCE_SYSTEM_H
+#define ASSET_REFERENCE_SYSTEM_H
+
+#include "../AssetStore/AssetStore.h"
+#include "../Components/ProjectileEmitterComponent.h"
+#include "../Components/SpriteComponent.h"
+#include "../Components/TextLabelComponent.h"
+#include "../Components/TilemapComponent.h"
+#include "../ECS/ECS.h"
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+// AssetReferenceSystem
+////////////////////////////////////////////////////////////////////////////////
+// Holds a reference to every asset the components of an active entity refer
+// to, so the AssetStore only evicts what no entity in the world uses. The
+// references are taken when the entity joins the systems, spawned or reused
+// from its pool, and given back when it is recycled, killed or streamed out.
+// What was acquired is remembered, components changed in the meantime do not
+// unbalance the counts.
+////////////////////////////////////////////////////////////////////////////////
+class AssetReferenceSystem : public System {
+private:
+    struct EntityAssets {
+        TextureHandle sprite = INVALID_TEXTURE_HANDLE;
+        TextureHandle tileset = INVALID_TEXTURE_HANDLE;
+        TextureHandle projectileTexture = INVALID_TEXTURE_HANDLE;
+        SoundHandle   projectileSound = INVALID_SOUND_HANDLE;
+        FontHandle    font = INVALID_FONT_HANDLE;
+    };
+
+    AssetStore&               m_assetStore;
+    // [Vector index = entity id]
+    std::vector<EntityAssets> m_entityAssets;
+
+    void AcquireTexture(TextureHandle handle) {
+        if (handle != INVALID_TEXTURE_HANDLE) {
+            m_assetStore.AcquireTexture(handle);
+        }
+    }
+
+    void ReleaseTexture(TextureHandle handle) {
+        if (handle != INVALID_TEXTURE_HANDLE) {
+            m_assetStore.ReleaseTexture(handle);
+        }
+    }
+
+public:
+    // No required component, every entity goes through the system
+    AssetReferenceSystem(AssetStore& assetStore) : m_assetStore(assetStore) {}
+
+    void OnEntityActivated(Entity entity) override {
+        const auto entityId = entity.GetId();
+        if (entityId >= static_cast<int>(m_entityAssets.size())) {
+            m_entityAssets.resize(entityId + 1);
+        }
+
+        EntityAssets& assets = m_entityAssets[entityId];
+        if (entity.HasComponent<SpriteComponent>()) {
+            assets.sprite = entity.GetComponent<SpriteComponent>().texture;
+            AcquireTexture(assets.sprite);
+        }
+        if (entity.HasComponent<TilemapComponent>()) {
+            assets.tileset = entity.GetComponent<TilemapComponent>().tileset;
+            AcquireTexture(assets.tileset);
+        }
+        if (entity.HasComponent<ProjectileEmitterComponent>()) {
+            const auto& projectileEmitter =
+                entity.GetComponent<ProjectileEmitterComponent>();
+            assets.projectileTexture = projectileEmitter.projectileTexture;
+            assets.projectileSound = projectileEmitter.projectileSound;
+            AcquireTexture(assets.projectileTexture);
+            if (assets.projectileSound != INVALID_SOUND_HANDLE) {
+                m_assetStore.AcquireSound(assets.projectileSound);
+            }
+        }
+        if (entity.HasComponent<TextLabelComponent>()) {
+            assets.font = entity.GetComponent<TextLabelComponent>().font;
+            if (assets.font != INVALID_FONT_HANDLE) {
+                m_assetStore.AcquireFont(assets.font);
+            }
+        }
+    }
+
+    void OnEntityDeactivated(Entity entity) override {
+        EntityAssets& assets = m_entityAssets[entity.GetId()];
+        ReleaseTexture(assets.sprite);
+        ReleaseTexture(assets.tileset);
+        ReleaseTexture(assets.projectileTexture);
+        if (assets.projectileSound != INVALID_SOUND_HANDLE) {
+            m_assetStore.ReleaseSound(assets.projectileSound);
+        }
+        if (assets.font != INVALID_FONT_HANDLE) {
+            m_assetStore.ReleaseFont(assets.font);
+        }
+        assets = EntityAssets();
+    }
+};
+
+#endif // !ASSET_REFERENCE_SYSTEM_H
@@ -7,6 +7,7 @@
 #include "../EventBus/EventBus.h"
 #include "../Game/Game.h"
 #include "../Logger/Logger.h"
+#include "../Profiler/Profiler.h"
 #include <SDL2/SDL.h>
 #include <glm/glm.hpp>
 
@@ -18,6 +19,7 @@ public:
     }
 
     void Update(SDL_Rect& camera) {
+        PROFILE_ZONE("CameraMovementSystem::Update");
         for (auto entity : GetSystemEntities()) {
             const auto& tf = entity.GetComponent<TransformComponent>();
 
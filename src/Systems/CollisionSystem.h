@@ -7,8 +7,14 @@
 #include "../EventBus/EventBus.h"
 #include "../Events/CollisionEvent.h"
 #include "../Logger/Logger.h"
+#include "../Profiler/Profiler.h"
 
 class CollisionSystem : public System {
+private:
+    // Counted over the last Update()
+    int m_numPairsTested = 0;
+    int m_numCollisions = 0;
+
 public:
     CollisionSystem() {
         RequireComponent<BoxColliderComponent>();
@@ -16,7 +22,10 @@ public:
     }
 
     void Update(std::unique_ptr<EventBus>& eventBus) {
+        PROFILE_ZONE("CollisionSystem::Update");
         auto entities = GetSystemEntities();
+        m_numPairsTested = 0;
+        m_numCollisions = 0;
 
         for (auto i = entities.begin(); i != entities.end(); i++) {
             Entity a = *i;
@@ -33,6 +42,7 @@ public:
                 }
                 auto bTf = b.GetComponent<TransformComponent>();
                 auto bCollider = b.GetComponent<BoxColliderComponent>();
+                m_numPairsTested++;
 
                 bool hasCollision = CheckAABCCollision(
                     aTf.position.x + aCollider.offset.x * aTf.scale.x,
@@ -45,9 +55,10 @@ public:
                     bCollider.height * bTf.scale.y);
 
                 if (hasCollision) {
-                    Logger::Log("Entity " + std::to_string(a.GetId()) +
-                                " is colliding with entity " +
-                                std::to_string(b.GetId()));
+                    m_numCollisions++;
+                    LOG_FORMAT(LOG_DEBUG,
+                               "Entity {} is colliding with entity {}",
+                               a.GetId(), b.GetId());
 
                     eventBus->EmitEvent<CollisionEvent>(a, b);
                 }
@@ -59,6 +70,9 @@ public:
                             double bX, double bY, double bW, double bH) {
         return aX < bX + bW && aX + aW > bX && aY < bY + bH && aY + aH > bY;
     }
+
+    int GetNumPairsTested() const { return m_numPairsTested; }
+    int GetNumCollisions() const { return m_numCollisions; }
 };
 
 #endif // !COLLISION_SYSTEM_H
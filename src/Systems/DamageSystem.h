@@ -22,9 +22,15 @@ public:
         Entity a = event.a;
         Entity b = event.b;
 
-        Logger::Log(
-            "The DamageSystem received an event collision between entities " +
-            std::to_string(a.GetId()) + " and " + std::to_string(b.GetId()));
+        LOG_FORMAT(LOG_DEBUG,
+                   "The DamageSystem received an event collision between "
+                   "entities {} and {}",
+                   a.GetId(), b.GetId());
+
+        // A projectile recycled by an earlier collision of the same tick
+        if (a.IsRecycled() || b.IsRecycled()) {
+            return;
+        }
 
         if (a.BelongsToGroup("projectiles") && b.HasTag("player")) {
             OnProjectileHitsPlayer(a, b);
@@ -57,8 +63,8 @@ public:
                 player.Kill();
             }
 
-            // Kill the projectile
-            projectile.Kill();
+            // The projectile goes back to the pool
+            projectile.Recycle();
         }
     }
 
@@ -76,8 +82,8 @@ public:
                 enemy.Kill();
             }
 
-            // Kill the projectile
-            projectile.Kill();
+            // The projectile goes back to the pool
+            projectile.Recycle();
         }
     }
 
@@ -4,6 +4,7 @@
 #include "../Components/RigidBodyComponent.h"
 #include "../Components/TransformComponent.h"
 #include "../ECS/ECS.h"
+#include "../Profiler/Profiler.h"
 
 class MovementSystem : public System {
 public:
@@ -13,6 +14,7 @@ public:
     }
 
     void Update(double deltaTime) {
+        PROFILE_ZONE("MovementSystem::Update");
         // Loop all entities that the system is interested in
         for (auto entity : GetSystemEntities()) {
             // Update entity position based on its velocity
@@ -8,19 +8,58 @@
 #include "../Components/RigidBodyComponent.h"
 #include "../Components/SpriteComponent.h"
 #include "../Components/TransformComponent.h"
+#include "../Audio/AudioMixer.h"
 #include "../ECS/ECS.h"
 #include "../EventBus/EventBus.h"
 #include "../Events/KeyPressedEvent.h"
+#include "../Profiler/Profiler.h"
+#include "../Timers/TimerWheel.h"
 #include <SDL2/SDL.h>
 #include <glm/glm.hpp>
+#include <vector>
 
 class ProjectileEmitSystem : public System {
+private:
+    struct EmittedSound {
+        SoundHandle sound;
+        glm::vec2   position;
+    };
+
+    TimerWheel&               m_timers;
+    // Shots fired from key presses, played on the next Update()
+    std::vector<EmittedSound> m_emittedSounds;
+
+    void ScheduleEmission(Entity                      entity,
+                          ProjectileEmitterComponent& projectileEmitter) {
+        // Same as polling for the first tick more than repeatFrequency after
+        // the last emission
+        projectileEmitter.emissionTimer = m_timers.Schedule(
+            TIMER_PROJECTILE_EMISSION,
+            projectileEmitter.lastEmissionTime +
+                projectileEmitter.repeatFrequency + 1,
+            entity);
+    }
+
 public:
-    ProjectileEmitSystem() {
+    ProjectileEmitSystem(TimerWheel& timers) : m_timers(timers) {
         RequireComponent<ProjectileEmitterComponent>();
         RequireComponent<TransformComponent>();
     }
 
+    // Emitters that fire on their own schedule their first emission, the
+    // ones streamed back in keep the time of their last
+    void OnEntityActivated(Entity entity) override {
+        auto& projectileEmitter =
+            entity.GetComponent<ProjectileEmitterComponent>();
+        if (projectileEmitter.repeatFrequency == 0) {
+            return;
+        }
+        if (projectileEmitter.lastEmissionTime < 0) {
+            projectileEmitter.lastEmissionTime = m_timers.GetTime();
+        }
+        ScheduleEmission(entity, projectileEmitter);
+    }
+
     void SubscribeToEvents(std::unique_ptr<EventBus>& eventBus) {
         eventBus->SubscribeToEvent<KeyPressedEvent>(
             this, &ProjectileEmitSystem::OnKeyPressed);
@@ -72,65 +111,83 @@ public:
                             0.0, -projectileEmitter.projectileVelocity.y);
                     }
 
-                    Entity projectile = entity.registry->CreateEntity();
-                    projectile.Group("projectiles");
+                    // A recycled projectile when there is one, its
+                    // components are overwritten in place
+                    Entity projectile =
+                        entity.registry->CreatePooledEntity("projectiles");
                     projectile.AddComponent<TransformComponent>(
                         projectilePos, glm::vec2(1.0, 1.0), 0.0);
                     projectile.AddComponent<RigidBodyComponent>(
                         projectileVelocity);
-                    projectile.AddComponent<SpriteComponent>("bullet-image", 4,
-                                                             4, 4);
+                    projectile.AddComponent<SpriteComponent>(
+                        projectileEmitter.projectileTexture, 4, 4, 4);
                     projectile.AddComponent<BoxColliderComponent>(4, 4);
                     projectile.AddComponent<ProjectileComponent>(
                         projectileEmitter.isFriendly,
                         projectileEmitter.hitPercentDamage,
                         projectileEmitter.projectileDuration);
+                    m_emittedSounds.push_back(
+                        {projectileEmitter.projectileSound, projectilePos});
                 }
             }
         }
     }
 
-    void Update(std::unique_ptr<Registry>& registry) {
-        for (auto entity : GetSystemEntities()) {
+    void Update(std::unique_ptr<Registry>&   registry,
+                std::unique_ptr<AudioMixer>& audioMixer, int simulationTime) {
+        PROFILE_ZONE("ProjectileEmitSystem::Update");
+        for (const auto& emitted : m_emittedSounds) {
+            if (emitted.sound != INVALID_SOUND_HANDLE) {
+                audioMixer->Play(emitted.sound, emitted.position,
+                                 SOUND_PRIORITY_HIGH);
+            }
+        }
+        m_emittedSounds.clear();
+
+        for (const auto& timer :
+             m_timers.GetDueTimers(TIMER_PROJECTILE_EMISSION)) {
+            // The timers of emitters gone since are stale
+            Entity entity = timer.entity;
+            if (!IsEntityActive(entity)) {
+                continue;
+            }
             const auto& tf = entity.GetComponent<TransformComponent>();
             auto&       projectileEmitter =
                 entity.GetComponent<ProjectileEmitterComponent>();
-
-            if (projectileEmitter.repeatFrequency == 0) {
+            if (projectileEmitter.emissionTimer != timer.id) {
                 continue;
             }
 
-            // Check if its time to re-emit a new projectile
-            if (static_cast<int>(SDL_GetTicks()) -
-                    projectileEmitter.lastEmissionTime >
-                projectileEmitter.repeatFrequency) {
-                // Calculate projectile position
-                glm::vec2 projectilePos = tf.position;
-                if (entity.HasComponent<SpriteComponent>()) {
-                    const auto& sprite = entity.GetComponent<SpriteComponent>();
-                    projectilePos = glm::vec2(
-                        tf.position.x +
-                            static_cast<int>(sprite.width / 2) * tf.scale.x,
-                        tf.position.y +
-                            static_cast<int>(sprite.height / 2) * tf.scale.y);
-                }
+            // Calculate projectile position
+            glm::vec2 projectilePos = tf.position;
+            if (entity.HasComponent<SpriteComponent>()) {
+                const auto& sprite = entity.GetComponent<SpriteComponent>();
+                projectilePos = glm::vec2(
+                    tf.position.x +
+                        static_cast<int>(sprite.width / 2) * tf.scale.x,
+                    tf.position.y +
+                        static_cast<int>(sprite.height / 2) * tf.scale.y);
+            }
 
-                Entity projectile = registry->CreateEntity();
-                projectile.Group("projectiles");
-                projectile.AddComponent<TransformComponent>(
-                    projectilePos, glm::vec2(1.0, 1.0));
-                projectile.AddComponent<RigidBodyComponent>(
-                    projectileEmitter.projectileVelocity);
-                projectile.AddComponent<SpriteComponent>("bullet-image", 4, 4,
-                                                         4);
-                projectile.AddComponent<BoxColliderComponent>(4, 4);
-                projectile.AddComponent<ProjectileComponent>(
-                    projectileEmitter.isFriendly,
-                    projectileEmitter.hitPercentDamage,
-                    projectileEmitter.projectileDuration);
-
-                projectileEmitter.lastEmissionTime = SDL_GetTicks();
+            Entity projectile = registry->CreatePooledEntity("projectiles");
+            projectile.AddComponent<TransformComponent>(projectilePos,
+                                                        glm::vec2(1.0, 1.0));
+            projectile.AddComponent<RigidBodyComponent>(
+                projectileEmitter.projectileVelocity);
+            projectile.AddComponent<SpriteComponent>(
+                projectileEmitter.projectileTexture, 4, 4, 4);
+            projectile.AddComponent<BoxColliderComponent>(4, 4);
+            projectile.AddComponent<ProjectileComponent>(
+                projectileEmitter.isFriendly,
+                projectileEmitter.hitPercentDamage,
+                projectileEmitter.projectileDuration);
+            if (projectileEmitter.projectileSound != INVALID_SOUND_HANDLE) {
+                audioMixer->Play(projectileEmitter.projectileSound,
+                                 projectilePos);
             }
+
+            projectileEmitter.lastEmissionTime = simulationTime;
+            ScheduleEmission(entity, projectileEmitter);
         }
     }
 };
@@ -3,18 +3,42 @@
 
 #include "../Components/ProjectileComponent.h"
 #include "../ECS/ECS.h"
+#include "../Profiler/Profiler.h"
+#include "../Timers/TimerWheel.h"
 
 class ProjectileLifecycleSystem : public System {
+private:
+    TimerWheel& m_timers;
+
 public:
-    ProjectileLifecycleSystem() { RequireComponent<ProjectileComponent>(); }
+    ProjectileLifecycleSystem(TimerWheel& timers) : m_timers(timers) {
+        RequireComponent<ProjectileComponent>();
+    }
+
+    // Fired, or fired again from the pool: the projectile expires once its
+    // duration went by
+    void OnEntityActivated(Entity entity) override {
+        auto& projectile = entity.GetComponent<ProjectileComponent>();
+        projectile.startTime = m_timers.GetTime();
+        projectile.expiryTimer =
+            m_timers.Schedule(TIMER_PROJECTILE_EXPIRY,
+                              projectile.startTime + projectile.duration + 1,
+                              entity);
+    }
 
     void Update() {
-        for (auto entity : GetSystemEntities()) {
-            auto& projectile = entity.GetComponent<ProjectileComponent>();
-            if (static_cast<int>(SDL_GetTicks()) - projectile.startTime >
-                projectile.duration) {
-                entity.Kill();
+        PROFILE_ZONE("ProjectileLifecycleSystem::Update");
+        for (const auto& timer :
+             m_timers.GetDueTimers(TIMER_PROJECTILE_EXPIRY)) {
+            // The timers of projectiles gone or fired again since are stale
+            Entity entity = timer.entity;
+            if (!IsEntityActive(entity) ||
+                entity.GetComponent<ProjectileComponent>().expiryTimer !=
+                    timer.id) {
+                continue;
             }
+            // Back to the pool, the next shot reuses the entity
+            entity.Recycle();
         }
     }
 };
@@ -4,16 +4,25 @@
 #include "../Components/BoxColliderComponent.h"
 #include "../Components/TransformComponent.h"
 #include "../ECS/ECS.h"
+#include "../Profiler/Profiler.h"
+#include "../Renderer/RenderBackend.h"
 #include <SDL2/SDL.h>
 
 class RenderColliderSystem : public System {
+private:
+    std::vector<SDL_Rect> m_rects;
+
 public:
     RenderColliderSystem() {
         RequireComponent<TransformComponent>();
         RequireComponent<BoxColliderComponent>();
     }
 
-    void Update(SDL_Renderer* renderer, const SDL_Rect& camera) {
+    // Collects the on-screen outline of every collider
+    void BuildRenderCommands(const SDL_Rect&        camera,
+                             std::vector<SDL_Rect>& rects) {
+        PROFILE_ZONE("RenderColliderSystem::BuildRenderCommands");
+        rects.clear();
         for (auto entity : GetSystemEntities()) {
             const auto& collider = entity.GetComponent<BoxColliderComponent>();
             const auto& tf = entity.GetComponent<TransformComponent>();
@@ -23,11 +32,23 @@ public:
                 static_cast<int>(tf.position.y + collider.offset.y - camera.y),
                 static_cast<int>(collider.width * tf.scale.x),
                 static_cast<int>(collider.height * tf.scale.y)};
+            rects.push_back(rect);
+        }
+    }
 
-            SDL_SetRenderDrawColor(renderer, 255, 0, 0, 255);
-            SDL_RenderDrawRect(renderer, &rect);
+    void Submit(std::unique_ptr<RenderBackend>& renderer,
+                const std::vector<SDL_Rect>&    rects) {
+        PROFILE_ZONE("RenderColliderSystem::Submit");
+        for (const auto& rect : rects) {
+            renderer->DrawRect(rect, {255, 0, 0, 255});
         }
     }
+
+    void Update(std::unique_ptr<RenderBackend>& renderer,
+                const SDL_Rect&                 camera) {
+        BuildRenderCommands(camera, m_rects);
+        Submit(renderer, m_rects);
+    }
 };
 
 #endif // !RENDER_COLLIDER_SYSTEM_H
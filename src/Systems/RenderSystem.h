@@ -5,68 +5,120 @@
 #include "../Components/SpriteComponent.h"
 #include "../Components/TransformComponent.h"
 #include "../ECS/ECS.h"
+#include "../Profiler/Profiler.h"
+#include "../Renderer/RenderBackend.h"
+#include "../Renderer/RenderSnapshot.h"
 #include <SDL2/SDL.h>
 #include <bits/stdc++.h>
 
 class RenderSystem : public System {
+private:
+    // Scratch list reused by the immediate Update()
+    std::vector<SpriteDrawCommand> m_commands;
+
 public:
     RenderSystem() {
         RequireComponent<TransformComponent>();
         RequireComponent<SpriteComponent>();
     }
 
-    void Update(SDL_Renderer* renderer, std::unique_ptr<AssetStore>& assetStore,
-                const SDL_Rect& camera) {
-        // Create a vector with both Sprite and Transform components of all
-        // entities
-        struct RenderableEntity {
-            TransformComponent transformComponent;
-            SpriteComponent    spriteComponent;
-        };
-
-        std::vector<RenderableEntity> renderableEntities;
+    // Called at the start of every tick, before anything moves
+    void SavePreviousPositions() {
         for (auto entity : GetSystemEntities()) {
-            RenderableEntity renderableEntity;
-            renderableEntity.spriteComponent =
-                entity.GetComponent<SpriteComponent>();
-            renderableEntity.transformComponent =
-                entity.GetComponent<TransformComponent>();
-            renderableEntities.emplace_back(renderableEntity);
+            auto& tf = entity.GetComponent<TransformComponent>();
+            tf.previousPosition = tf.position;
         }
+    }
 
-        // Sort the vector by the z-index value
-        std::sort(
-            renderableEntities.begin(), renderableEntities.end(),
-            [](const RenderableEntity& first, const RenderableEntity& second) {
-                return first.spriteComponent.zIndex <
-                       second.spriteComponent.zIndex;
-            });
+    // Resolves every sprite into a draw command, the commands are in draw
+    // order once sorted with SortRenderCommands()
+    void BuildRenderCommands(std::unique_ptr<AssetStore>&    assetStore,
+                             const SDL_Rect&                 camera,
+                             const SDL_Rect&                 previousCamera,
+                             std::vector<SpriteDrawCommand>& commands) {
+        PROFILE_ZONE("RenderSystem::BuildRenderCommands");
+        commands.clear();
 
         // Loop all entities that the system is interested in
-        for (auto entity : renderableEntities) {
-            const auto& tf = entity.transformComponent;
-            const auto& sprite = entity.spriteComponent;
+        for (auto entity : GetSystemEntities()) {
+            const auto& tf = entity.GetComponent<TransformComponent>();
+            const auto& sprite = entity.GetComponent<SpriteComponent>();
+            const auto& region = assetStore->GetTextureRegion(sprite.texture);
+
+            // An evicted texture starts reloading and draws the placeholder
+            // until it is back
+            if (!region.texture) {
+                assetStore->RequestTexture(sprite.texture);
+            }
+            assetStore->TouchTexture(sprite.texture);
 
-            // Set the source rectangle of our original sprite texture
+            // Set the source rectangle of our original sprite texture, moved
+            // to where the texture was packed inside its atlas page
             SDL_Rect srcRect = sprite.srcRect;
+            srcRect.x += region.rect.x;
+            srcRect.y += region.rect.y;
 
             // Set the destination rectangle with the x,y position to be
             // rendered
             // Optimization: instead of ternary operator
             int cameraOffsetX = !sprite.isFixed * camera.x;
             int cameraOffsetY = !sprite.isFixed * camera.y;
+            int previousOffsetX = !sprite.isFixed * previousCamera.x;
+            int previousOffsetY = !sprite.isFixed * previousCamera.y;
 
             SDL_Rect dstRect = {static_cast<int>(tf.position.x - cameraOffsetX),
                                 static_cast<int>(tf.position.y - cameraOffsetY),
                                 static_cast<int>(sprite.width * tf.scale.x),
                                 static_cast<int>(sprite.height * tf.scale.y)};
+            SDL_Point previousPosition = {
+                static_cast<int>(tf.previousPosition.x - previousOffsetX),
+                static_cast<int>(tf.previousPosition.y - previousOffsetY)};
+
+            commands.push_back({region.texture, srcRect, dstRect,
+                                previousPosition, tf.rotation, sprite.zIndex,
+                                COLOR_WHITE});
+        }
+    }
+
+    // Sort the commands by the z-index value, sprites on the same layer are
+    // grouped by atlas page so consecutive draws share a texture
+    static void SortRenderCommands(std::vector<SpriteDrawCommand>& commands) {
+        std::sort(commands.begin(), commands.end(),
+                  [](const SpriteDrawCommand& first,
+                     const SpriteDrawCommand& second) {
+                      if (first.zIndex != second.zIndex) {
+                          return first.zIndex < second.zIndex;
+                      }
+                      return first.texture < second.texture;
+                  });
+    }
 
-            // Draw the texture on the destination renderer
-            SDL_RenderCopyEx(renderer, assetStore->GetTexture(sprite.assetId),
-                             &srcRect, &dstRect, tf.rotation, NULL,
-                             SDL_FLIP_NONE);
+    // Draws the sprites alpha of the way from their previous position to
+    // the current one, 1 draws them where they are
+    void Submit(std::unique_ptr<RenderBackend>&       renderer,
+                const std::vector<SpriteDrawCommand>& commands,
+                double                                alpha = 1.0) {
+        PROFILE_ZONE("RenderSystem::Submit");
+        for (const auto& command : commands) {
+            SDL_Rect dstRect = command.dstRect;
+            dstRect.x = command.previousPosition.x +
+                        static_cast<int>(std::lround(
+                            (dstRect.x - command.previousPosition.x) * alpha));
+            dstRect.y = command.previousPosition.y +
+                        static_cast<int>(std::lround(
+                            (dstRect.y - command.previousPosition.y) * alpha));
+            renderer->DrawTexture(command.texture, &command.srcRect, &dstRect,
+                                  command.angle, command.color);
         }
     }
+
+    void Update(std::unique_ptr<RenderBackend>& renderer,
+                std::unique_ptr<AssetStore>&    assetStore,
+                const SDL_Rect&                 camera) {
+        BuildRenderCommands(assetStore, camera, camera, m_commands);
+        SortRenderCommands(m_commands);
+        Submit(renderer, m_commands);
+    }
 };
 
 #endif // !RENDER_SYSTEM_H
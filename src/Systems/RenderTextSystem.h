@@ -0,0 +1,133 @@
+#ifndef RENDER_TEXT_SYSTEM_H
+#define RENDER_TEXT_SYSTEM_H
+
+#include "../AssetStore/AssetStore.h"
+#include "../Components/TextLabelComponent.h"
+#include "../ECS/ECS.h"
+#include "../Profiler/Profiler.h"
+#include "../Renderer/RenderSnapshot.h"
+#include <SDL2/SDL.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Layouts kept before the cache is flushed, labels showing changing numbers
+// would otherwise grow it forever
+const size_t MAX_CACHED_TEXT_LAYOUTS = 4096;
+
+// A glyph of a laid out string, relative to the glyph sheet and to the start
+// of the string
+struct GlyphQuad {
+    SDL_Rect srcRect;
+    SDL_Rect dstRect;
+};
+
+class RenderTextSystem : public System {
+private:
+    // Laid out strings [Map key = font handle bytes followed by the text]
+    std::unordered_map<std::string, std::vector<GlyphQuad>> m_layouts;
+    std::string                                             m_key;
+
+    const std::vector<GlyphQuad>& GetLayout(const GlyphAtlas&  atlas,
+                                            FontHandle         font,
+                                            const std::string& text) {
+        m_key.assign(reinterpret_cast<const char*>(&font), sizeof(font));
+        m_key += text;
+
+        auto layout = m_layouts.find(m_key);
+        if (layout != m_layouts.end()) {
+            return layout->second;
+        }
+        if (m_layouts.size() >= MAX_CACHED_TEXT_LAYOUTS) {
+            m_layouts.clear();
+        }
+
+        std::vector<GlyphQuad> quads;
+        int                    penX = 0;
+        int                    penY = 0;
+        for (char ch : text) {
+            if (ch == '\n') {
+                penX = 0;
+                penY += atlas.lineSkip;
+                continue;
+            }
+            const Glyph& glyph = atlas.GetGlyph(ch);
+            if (glyph.rect.w > 0) {
+                quads.push_back(
+                    {glyph.rect, {penX, penY, glyph.rect.w, glyph.rect.h}});
+            }
+            penX += glyph.advance;
+        }
+        return m_layouts.emplace(m_key, std::move(quads)).first->second;
+    }
+
+public:
+    RenderTextSystem() { RequireComponent<TextLabelComponent>(); }
+
+    // Appends a command per glyph of the text, drawn at position on screen
+    void BuildTextCommands(std::unique_ptr<AssetStore>& assetStore,
+                           FontHandle font, const std::string& text,
+                           SDL_Point position, SDL_Point previousPosition,
+                           int zIndex, SDL_Color color,
+                           std::vector<SpriteDrawCommand>& commands) {
+        const auto& atlas = assetStore->GetGlyphAtlas(font);
+
+        // An evicted glyph sheet is rasterized again, the text is skipped
+        // while the sheet is on its way to the renderer
+        if (atlas.texture == INVALID_TEXTURE_HANDLE) {
+            return;
+        }
+        assetStore->RequestTexture(atlas.texture);
+        if (assetStore->IsTextureLoading(atlas.texture)) {
+            return;
+        }
+        const auto& region = assetStore->GetTextureRegion(atlas.texture);
+        assetStore->TouchTexture(atlas.texture);
+
+        for (const auto& quad : GetLayout(atlas, font, text)) {
+            SDL_Rect srcRect = quad.srcRect;
+            srcRect.x += region.rect.x;
+            srcRect.y += region.rect.y;
+
+            SDL_Rect dstRect = quad.dstRect;
+            dstRect.x += position.x;
+            dstRect.y += position.y;
+
+            SDL_Point previousQuad = {previousPosition.x + quad.dstRect.x,
+                                      previousPosition.y + quad.dstRect.y};
+
+            commands.push_back({region.texture, srcRect, dstRect, previousQuad,
+                                0.0, zIndex, color});
+        }
+    }
+
+    // Appends a command per glyph of every label, they go through the same
+    // sort and submit as the sprites
+    void BuildRenderCommands(std::unique_ptr<AssetStore>&    assetStore,
+                             const SDL_Rect&                 camera,
+                             const SDL_Rect&                 previousCamera,
+                             std::vector<SpriteDrawCommand>& commands) {
+        PROFILE_ZONE("RenderTextSystem::BuildRenderCommands");
+        for (auto entity : GetSystemEntities()) {
+            const auto& label = entity.GetComponent<TextLabelComponent>();
+
+            SDL_Point position = {
+                static_cast<int>(label.position.x) - !label.isFixed * camera.x,
+                static_cast<int>(label.position.y) - !label.isFixed * camera.y};
+            // Labels stand still, only the camera moves them between ticks
+            SDL_Point previousPosition = {
+                static_cast<int>(label.position.x) -
+                    !label.isFixed * previousCamera.x,
+                static_cast<int>(label.position.y) -
+                    !label.isFixed * previousCamera.y};
+
+            BuildTextCommands(assetStore, label.font, label.text, position,
+                              previousPosition, label.zIndex, label.color,
+                              commands);
+        }
+    }
+
+    int GetNumCachedLayouts() const { return m_layouts.size(); }
+};
+
+#endif // !RENDER_TEXT_SYSTEM_H
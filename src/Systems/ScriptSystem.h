@@ -0,0 +1,48 @@
+#ifndef SCRIPT_SYSTEM_H
+#define SCRIPT_SYSTEM_H
+
+#include "../Components/ScriptComponent.h"
+#include "../Components/TransformComponent.h"
+#include "../ECS/ECS.h"
+#include "../Profiler/Profiler.h"
+#include "../Scripting/ScriptEngine.h"
+#include <vector>
+
+class ScriptSystem : public System {
+private:
+    // Entities of every behaviour, the vectors keep their capacity between
+    // ticks [Vector index = behaviour id]
+    std::vector<std::vector<Entity>> m_entitiesPerBehaviour;
+
+public:
+    ScriptSystem() {
+        RequireComponent<ScriptComponent>();
+        RequireComponent<TransformComponent>();
+    }
+
+    // Every behaviour is called once with all of its entities
+    void Update(ScriptEngine& scriptEngine, double deltaTime) {
+        PROFILE_ZONE("ScriptSystem::Update");
+        for (auto& entities : m_entitiesPerBehaviour) {
+            entities.clear();
+        }
+
+        for (auto entity : GetSystemEntities()) {
+            const int behaviour =
+                entity.GetComponent<ScriptComponent>().behaviour;
+            if (behaviour < 0) {
+                continue;
+            }
+            if (behaviour >= static_cast<int>(m_entitiesPerBehaviour.size())) {
+                m_entitiesPerBehaviour.resize(behaviour + 1);
+            }
+            m_entitiesPerBehaviour[behaviour].push_back(entity);
+        }
+
+        for (size_t i = 0; i < m_entitiesPerBehaviour.size(); i++) {
+            scriptEngine.RunBehaviour(i, m_entitiesPerBehaviour[i], deltaTime);
+        }
+    }
+};
+
+#endif // !SCRIPT_SYSTEM_H
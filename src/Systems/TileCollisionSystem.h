@@ -0,0 +1,73 @@
+#ifndef TILE_COLLISION_SYSTEM_H
+#define TILE_COLLISION_SYSTEM_H
+
+#include "../Components/BoxColliderComponent.h"
+#include "../Components/ProjectileComponent.h"
+#include "../Components/RigidBodyComponent.h"
+#include "../Components/TilemapComponent.h"
+#include "../Components/TransformComponent.h"
+#include "../ECS/ECS.h"
+#include "../Profiler/Profiler.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// TileCollisionSystem
+////////////////////////////////////////////////////////////////////////////////
+// Tests moving colliders against the solid tiles of the map. Only the tiles
+// under each collider are looked up in the grid, the cost does not depend on
+// the size of the map. Projectiles hitting a solid tile are destroyed, other
+// entities are moved back out of it one axis at a time so they slide along
+// walls.
+////////////////////////////////////////////////////////////////////////////////
+class TileCollisionSystem : public System {
+public:
+    TileCollisionSystem() {
+        RequireComponent<BoxColliderComponent>();
+        RequireComponent<RigidBodyComponent>();
+        RequireComponent<TransformComponent>();
+    }
+
+    void Update(const TilemapComponent& tilemap, double deltaTime) {
+        PROFILE_ZONE("TileCollisionSystem::Update");
+        const double tileWorldSize = tilemap.GetTileWorldSize();
+
+        for (auto entity : GetSystemEntities()) {
+            auto&       tf = entity.GetComponent<TransformComponent>();
+            const auto& rb = entity.GetComponent<RigidBodyComponent>();
+            const auto& collider = entity.GetComponent<BoxColliderComponent>();
+
+            if (rb.velocity == glm::vec2(0)) {
+                continue;
+            }
+
+            auto overlapsSolid = [&](const glm::vec2& position) {
+                return tilemap.tilemap->OverlapsSolid(
+                    position.x + collider.offset.x * tf.scale.x,
+                    position.y + collider.offset.y * tf.scale.y,
+                    collider.width * tf.scale.x, collider.height * tf.scale.y,
+                    tileWorldSize);
+            };
+            if (!overlapsSolid(tf.position)) {
+                continue;
+            }
+
+            if (entity.HasComponent<ProjectileComponent>()) {
+                entity.Recycle();
+                continue;
+            }
+
+            // Undo the last step along x, then along y, then both
+            glm::vec2 step = rb.velocity * static_cast<float>(deltaTime);
+            glm::vec2 backX(tf.position.x - step.x, tf.position.y);
+            glm::vec2 backY(tf.position.x, tf.position.y - step.y);
+            if (!overlapsSolid(backX)) {
+                tf.position = backX;
+            } else if (!overlapsSolid(backY)) {
+                tf.position = backY;
+            } else {
+                tf.position -= step;
+            }
+        }
+    }
+};
+
+#endif // !TILE_COLLISION_SYSTEM_H
@@ -0,0 +1,197 @@
+#ifndef WORLD_STREAMING_SYSTEM_H
+#define WORLD_STREAMING_SYSTEM_H
+
+#include "../Components/StreamedComponent.h"
+#include "../Components/TransformComponent.h"
+#include "../ECS/ECS.h"
+#include "../Profiler/Profiler.h"
+#include "../World/EntityRecord.h"
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <deque>
+#include <vector>
+
+// Cells closer than this to the camera, in world pixels, are loaded
+const int STREAMING_MARGIN = 512;
+
+// Most entities spawned per tick, loading cells is spread over several ticks
+const int STREAMING_SPAWN_BUDGET = 64;
+
+////////////////////////////////////////////////////////////////////////////////
+// WorldStreamingSystem
+////////////////////////////////////////////////////////////////////////////////
+// Splits the world in square cells and keeps only the cells around the camera
+// alive. Entering cells spawn their entities a few per tick, leaving cells
+// save the state of their entities into records and destroy them. Cells are
+// unloaded half a cell further than they are loaded so the camera moving back
+// and forth over a border does not reload them every tick.
+////////////////////////////////////////////////////////////////////////////////
+class WorldStreamingSystem : public System {
+private:
+    enum CellState { CELL_UNLOADED, CELL_LOADING, CELL_LOADED };
+
+    struct Cell {
+        CellState                 state;
+        std::vector<EntityRecord> records;
+    };
+
+    int               m_cellSize = 1;
+    int               m_numCellCols = 0;
+    int               m_numCellRows = 0;
+    std::vector<Cell> m_cells;
+
+    // Cells loading or loaded, and the ones still spawning entities
+    std::vector<int> m_residentCells;
+    std::deque<int>  m_loadQueue;
+
+    int GetCellAt(const glm::vec2& position) const {
+        int x = std::clamp(static_cast<int>(position.x) / m_cellSize, 0,
+                           m_numCellCols - 1);
+        int y = std::clamp(static_cast<int>(position.y) / m_cellSize, 0,
+                           m_numCellRows - 1);
+        return y * m_numCellCols + x;
+    }
+
+    bool IsCellInside(int cell, const SDL_Rect& area) const {
+        int x = (cell % m_numCellCols) * m_cellSize;
+        int y = (cell / m_numCellCols) * m_cellSize;
+        return x < area.x + area.w && x + m_cellSize > area.x &&
+               y < area.y + area.h && y + m_cellSize > area.y;
+    }
+
+    void LoadCell(int cell) {
+        m_cells[cell].state = CELL_LOADING;
+        m_residentCells.push_back(cell);
+        m_loadQueue.push_back(cell);
+    }
+
+    // Spawns the records of the queued cells until the budget is spent
+    void SpawnQueuedCells(Registry& registry) {
+        int budget = STREAMING_SPAWN_BUDGET;
+        while (!m_loadQueue.empty() && budget > 0) {
+            Cell& cell = m_cells[m_loadQueue.front()];
+            // Unloaded again before it was done loading
+            if (cell.state != CELL_LOADING) {
+                m_loadQueue.pop_front();
+                continue;
+            }
+
+            while (!cell.records.empty() && budget > 0) {
+                Entity entity = cell.records.back().Spawn(registry);
+                entity.AddComponent<StreamedComponent>(m_loadQueue.front());
+                cell.records.pop_back();
+                budget--;
+            }
+            if (cell.records.empty()) {
+                cell.state = CELL_LOADED;
+                m_loadQueue.pop_front();
+            }
+        }
+    }
+
+public:
+    WorldStreamingSystem() {
+        RequireComponent<StreamedComponent>();
+        RequireComponent<TransformComponent>();
+    }
+
+    // Drops every cell and record, meant for level loading
+    void SetWorldSize(int width, int height, int cellSize) {
+        m_cellSize = std::max(1, cellSize);
+        m_numCellCols = std::max(1, (width + m_cellSize - 1) / m_cellSize);
+        m_numCellRows = std::max(1, (height + m_cellSize - 1) / m_cellSize);
+        m_cells.assign(m_numCellCols * m_numCellRows, {CELL_UNLOADED, {}});
+        m_residentCells.clear();
+        m_loadQueue.clear();
+    }
+
+    // Adds an entity to the cell it stands in, spawned when the cell loads
+    void AddEntity(const EntityRecord& record) {
+        if (!record.transform) {
+            Logger::Err("Streamed entities need a transform");
+            return;
+        }
+        int   index = GetCellAt(record.transform->position);
+        Cell& cell = m_cells[index];
+        cell.records.push_back(record);
+        if (cell.state == CELL_LOADED) {
+            cell.state = CELL_LOADING;
+            m_loadQueue.push_back(index);
+        }
+    }
+
+    // Runs after the registry update, so entities killed last tick are gone
+    // and not saved again
+    void Update(std::unique_ptr<Registry>& registry, const SDL_Rect& camera) {
+        PROFILE_ZONE("WorldStreamingSystem::Update");
+        if (m_cells.empty()) {
+            return;
+        }
+
+        const SDL_Rect loadArea = {
+            camera.x - STREAMING_MARGIN, camera.y - STREAMING_MARGIN,
+            camera.w + 2 * STREAMING_MARGIN, camera.h + 2 * STREAMING_MARGIN};
+        const SDL_Rect keepArea = {loadArea.x - m_cellSize / 2,
+                                   loadArea.y - m_cellSize / 2,
+                                   loadArea.w + m_cellSize,
+                                   loadArea.h + m_cellSize};
+
+        for (size_t i = 0; i < m_residentCells.size();) {
+            const int cell = m_residentCells[i];
+            if (IsCellInside(cell, keepArea)) {
+                i++;
+                continue;
+            }
+            m_cells[cell].state = CELL_UNLOADED;
+            m_residentCells[i] = m_residentCells.back();
+            m_residentCells.pop_back();
+        }
+
+        // Entities carry their state to the cell they moved to. The ones
+        // standing in an unloaded cell are saved there, that also covers the
+        // ones that walked out of the loaded area.
+        for (auto entity : GetSystemEntities()) {
+            auto& streamed = entity.GetComponent<StreamedComponent>();
+            streamed.cell =
+                GetCellAt(entity.GetComponent<TransformComponent>().position);
+            if (m_cells[streamed.cell].state != CELL_UNLOADED) {
+                continue;
+            }
+            EntityRecord record;
+            record.Save(entity);
+            m_cells[streamed.cell].records.push_back(record);
+            entity.Kill();
+        }
+
+        const int firstCol = std::max(0, loadArea.x / m_cellSize);
+        const int firstRow = std::max(0, loadArea.y / m_cellSize);
+        const int lastCol = std::min(m_numCellCols - 1,
+                                     (loadArea.x + loadArea.w) / m_cellSize);
+        const int lastRow = std::min(m_numCellRows - 1,
+                                     (loadArea.y + loadArea.h) / m_cellSize);
+        for (int y = firstRow; y <= lastRow; y++) {
+            for (int x = firstCol; x <= lastCol; x++) {
+                if (m_cells[y * m_numCellCols + x].state == CELL_UNLOADED) {
+                    LoadCell(y * m_numCellCols + x);
+                }
+            }
+        }
+
+        SpawnQueuedCells(*registry);
+    }
+
+    int GetNumCells() const { return m_cells.size(); }
+    int GetNumResidentCells() const { return m_residentCells.size(); }
+    int GetNumLiveEntities() const { return GetSystemEntities().size(); }
+
+    // Entities waiting in cells that are not loaded
+    size_t GetNumRecords() const {
+        size_t numRecords = 0;
+        for (const auto& cell : m_cells) {
+            numRecords += cell.records.size();
+        }
+        return numRecords;
+    }
+};
+
+#endif // !WORLD_STREAMING_SYSTEM_H
@@ -0,0 +1,72 @@
+#ifndef TRIPLE_BUFFER_H
+#define TRIPLE_BUFFER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+////////////////////////////////////////////////////////////////////////////////
+// TripleBuffer
+////////////////////////////////////////////////////////////////////////////////
+// Lock-free triple buffer between one producer (simulation) and one consumer
+// (renderer, exporter). The producer always has a slot to write into and the
+// consumer always gets the newest published snapshot, neither waits for the
+// other. The slot returned by Acquire() stays the consumer's until the next
+// call that returns a snapshot.
+////////////////////////////////////////////////////////////////////////////////
+template <typename TSnapshot>
+class TripleBuffer {
+private:
+    static const int INDEX_MASK = 3;
+    static const int FRESH_BIT = 4;
+
+    TSnapshot m_snapshots[3];
+    int            m_writeIndex = 0;
+    int            m_readIndex = 1;
+    // Slot of the last published snapshot, FRESH_BIT is set until it is read
+    std::atomic<int> m_readyIndex{2};
+
+    // Only used to let the consumer sleep until something is published
+    std::mutex              m_mutex;
+    std::condition_variable m_published;
+
+public:
+    TSnapshot& GetWriteSnapshot() { return m_snapshots[m_writeIndex]; }
+
+    void Publish() {
+        int previous = m_readyIndex.exchange(m_writeIndex | FRESH_BIT,
+                                             std::memory_order_acq_rel);
+        m_writeIndex = previous & INDEX_MASK;
+
+        // Taking the lock makes sure a consumer about to wait sees the flag
+        { std::lock_guard<std::mutex> lock(m_mutex); }
+        m_published.notify_one();
+    }
+
+    // Returns the newest snapshot, or nullptr if nothing was published since
+    // the last call
+    const TSnapshot* Acquire() {
+        if (!(m_readyIndex.load(std::memory_order_acquire) & FRESH_BIT)) {
+            return nullptr;
+        }
+        int previous =
+            m_readyIndex.exchange(m_readIndex, std::memory_order_acq_rel);
+        m_readIndex = previous & INDEX_MASK;
+        return &m_snapshots[m_readIndex];
+    }
+
+    const TSnapshot* WaitAndAcquire(int timeoutMs) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_published.wait_for(
+                lock, std::chrono::milliseconds(timeoutMs), [this] {
+                    return m_readyIndex.load(std::memory_order_acquire) &
+                           FRESH_BIT;
+                });
+        }
+        return Acquire();
+    }
+};
+
+#endif // !TRIPLE_BUFFER_H
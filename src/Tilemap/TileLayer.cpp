@@ -0,0 +1,225 @@
+#include "./TileLayer.h"
+#include "../Logger/Logger.h"
+#include <algorithm>
+
+TileLayer::TileLayer(RenderBackend& renderer, std::shared_ptr<Tilemap> tilemap,
+                     double tileScale, TextureHandle tileset) {
+    m_renderer = &renderer;
+    m_tilemap = tilemap;
+    m_numCols = tilemap->GetNumCols();
+    m_numRows = tilemap->GetNumRows();
+    m_tileSize = tilemap->GetTileSize();
+    m_tileScale = tileScale;
+    m_tileset = tileset;
+
+    m_chunkTiles = std::max(1, TILE_CHUNK_SIZE / GetScaledTileSize());
+    m_numChunkCols = (m_numCols + m_chunkTiles - 1) / m_chunkTiles;
+    m_numChunkRows = (m_numRows + m_chunkTiles - 1) / m_chunkTiles;
+    m_chunks.resize(m_numChunkCols * m_numChunkRows, {nullptr, true});
+
+    Logger::Log("TileLayer created with " +
+                std::to_string(m_numChunkCols * m_numChunkRows) + " chunks");
+}
+
+TileLayer::~TileLayer() {
+    for (auto& chunk : m_chunks) {
+        if (chunk.texture) {
+            m_renderer->DestroyTexture(chunk.texture);
+        }
+    }
+}
+
+int TileLayer::GetScaledTileSize() const {
+    return static_cast<int>(m_tileSize * m_tileScale);
+}
+
+void TileLayer::GetChunkRange(const SDL_Rect& area, int& firstChunkX,
+                              int& firstChunkY, int& lastChunkX,
+                              int& lastChunkY) const {
+    const int chunkPixels = m_chunkTiles * GetScaledTileSize();
+    firstChunkX = std::max(0, area.x / chunkPixels);
+    firstChunkY = std::max(0, area.y / chunkPixels);
+    lastChunkX =
+        std::min(m_numChunkCols - 1, (area.x + area.w) / chunkPixels);
+    lastChunkY =
+        std::min(m_numChunkRows - 1, (area.y + area.h) / chunkPixels);
+}
+
+void TileLayer::SetTile(int x, int y, std::uint16_t tile) {
+    m_tilemap->SetTile(x, y, tile);
+    m_chunks[(y / m_chunkTiles) * m_numChunkCols + x / m_chunkTiles].isDirty =
+        true;
+}
+
+std::uint16_t TileLayer::GetTile(int x, int y) const {
+    return m_tilemap->GetTile(x, y);
+}
+
+void TileLayer::Invalidate() {
+    for (auto& chunk : m_chunks) {
+        chunk.isDirty = true;
+    }
+}
+
+void TileLayer::DrawTiles(const TextureRegion& tileset, int firstCol,
+                          int firstRow, int lastCol, int lastRow, int offsetX,
+                          int offsetY) const {
+    const int tilesetCols = std::max(1, tileset.rect.w / m_tileSize);
+    const int scaledTileSize = GetScaledTileSize();
+
+    for (int y = firstRow; y < lastRow; y++) {
+        for (int x = firstCol; x < lastCol; x++) {
+            const std::uint16_t tile = m_tilemap->GetTile(x, y);
+            if (tile == EMPTY_TILE) {
+                continue;
+            }
+
+            SDL_Rect srcRect = {
+                tileset.rect.x + (tile % tilesetCols) * m_tileSize,
+                tileset.rect.y + (tile / tilesetCols) * m_tileSize, m_tileSize,
+                m_tileSize};
+            SDL_Rect dstRect = {x * scaledTileSize - offsetX,
+                                y * scaledTileSize - offsetY, scaledTileSize,
+                                scaledTileSize};
+            m_renderer->DrawTexture(tileset.texture, &srcRect, &dstRect);
+        }
+    }
+}
+
+bool TileLayer::BakeChunk(const TextureRegion& tileset, int chunkX,
+                          int chunkY) {
+    Chunk&    chunk = m_chunks[chunkY * m_numChunkCols + chunkX];
+    const int chunkPixels = m_chunkTiles * GetScaledTileSize();
+
+    if (!chunk.texture) {
+        if (m_frame < m_nextTextureFrame) {
+            return false;
+        }
+        chunk.texture =
+            m_renderer->CreateRenderTarget(chunkPixels, chunkPixels);
+        if (!chunk.texture) {
+            Logger::Err("Error creating tile chunk texture: " +
+                        std::string(SDL_GetError()));
+            m_nextTextureFrame = m_frame + TILE_CHUNK_RETRY_FRAMES;
+            return false;
+        }
+        m_bakedChunks.push_back(chunkY * m_numChunkCols + chunkX);
+    }
+
+    m_renderer->SetRenderTarget(chunk.texture);
+    m_renderer->Clear({0, 0, 0, 0});
+
+    const int firstCol = chunkX * m_chunkTiles;
+    const int firstRow = chunkY * m_chunkTiles;
+    DrawTiles(tileset, firstCol, firstRow,
+              std::min(firstCol + m_chunkTiles, m_numCols),
+              std::min(firstRow + m_chunkTiles, m_numRows),
+              firstCol * GetScaledTileSize(), firstRow * GetScaledTileSize());
+
+    m_renderer->SetRenderTarget(nullptr);
+    chunk.isDirty = false;
+    return true;
+}
+
+void TileLayer::Bake(const TextureRegion& tileset, const SDL_Rect& area) {
+    if (!m_renderer->SupportsRenderTargets()) {
+        return;
+    }
+
+    int firstChunkX, firstChunkY, lastChunkX, lastChunkY;
+    GetChunkRange(area, firstChunkX, firstChunkY, lastChunkX, lastChunkY);
+    for (int chunkY = firstChunkY; chunkY <= lastChunkY; chunkY++) {
+        for (int chunkX = firstChunkX; chunkX <= lastChunkX; chunkX++) {
+            if (m_chunks[chunkY * m_numChunkCols + chunkX].isDirty) {
+                BakeChunk(tileset, chunkX, chunkY);
+            }
+        }
+    }
+}
+
+void TileLayer::ReleaseFarChunks(const SDL_Rect& camera) {
+    const int      chunkPixels = m_chunkTiles * GetScaledTileSize();
+    const int      margin = 2 * TILE_CHUNK_MARGIN;
+    const SDL_Rect keep = {camera.x - margin, camera.y - margin,
+                           camera.w + 2 * margin, camera.h + 2 * margin};
+
+    for (size_t i = 0; i < m_bakedChunks.size();) {
+        const int index = m_bakedChunks[i];
+        const int x = (index % m_numChunkCols) * chunkPixels;
+        const int y = (index / m_numChunkCols) * chunkPixels;
+        if (x < keep.x + keep.w && x + chunkPixels > keep.x &&
+            y < keep.y + keep.h && y + chunkPixels > keep.y) {
+            i++;
+            continue;
+        }
+
+        Chunk& chunk = m_chunks[index];
+        m_renderer->DestroyTexture(chunk.texture);
+        chunk.texture = nullptr;
+        chunk.isDirty = true;
+        m_bakedChunks[i] = m_bakedChunks.back();
+        m_bakedChunks.pop_back();
+    }
+}
+
+void TileLayer::Render(const TextureRegion& tileset, const SDL_Rect& camera) {
+    const int scaledTileSize = GetScaledTileSize();
+    m_frame++;
+
+    // Renderers without render targets fall back to drawing the visible
+    // tiles one by one
+    if (!m_renderer->SupportsRenderTargets()) {
+        const int lastCol = (camera.x + camera.w) / scaledTileSize + 1;
+        const int lastRow = (camera.y + camera.h) / scaledTileSize + 1;
+        DrawTiles(tileset, std::max(0, camera.x / scaledTileSize),
+                  std::max(0, camera.y / scaledTileSize),
+                  std::min(m_numCols, lastCol), std::min(m_numRows, lastRow),
+                  camera.x, camera.y);
+        return;
+    }
+
+    const int chunkPixels = m_chunkTiles * scaledTileSize;
+    int       firstChunkX, firstChunkY, lastChunkX, lastChunkY;
+    GetChunkRange(camera, firstChunkX, firstChunkY, lastChunkX, lastChunkY);
+
+    for (int chunkY = firstChunkY; chunkY <= lastChunkY; chunkY++) {
+        for (int chunkX = firstChunkX; chunkX <= lastChunkX; chunkX++) {
+            Chunk& chunk = m_chunks[chunkY * m_numChunkCols + chunkX];
+            if (chunk.isDirty && !BakeChunk(tileset, chunkX, chunkY)) {
+                // No texture for the chunk, its tiles are drawn one by one
+                const int firstCol = chunkX * m_chunkTiles;
+                const int firstRow = chunkY * m_chunkTiles;
+                DrawTiles(tileset, firstCol, firstRow,
+                          std::min(firstCol + m_chunkTiles, m_numCols),
+                          std::min(firstRow + m_chunkTiles, m_numRows),
+                          camera.x, camera.y);
+                continue;
+            }
+
+            SDL_Rect dstRect = {chunkX * chunkPixels - camera.x,
+                                chunkY * chunkPixels - camera.y, chunkPixels,
+                                chunkPixels};
+            m_renderer->DrawTexture(chunk.texture, NULL, &dstRect);
+        }
+    }
+
+    // Bake a few of the chunks about to be seen, so moving the camera does
+    // not bake a whole row of chunks in one frame
+    const SDL_Rect margin = {
+        camera.x - TILE_CHUNK_MARGIN, camera.y - TILE_CHUNK_MARGIN,
+        camera.w + 2 * TILE_CHUNK_MARGIN, camera.h + 2 * TILE_CHUNK_MARGIN};
+    GetChunkRange(margin, firstChunkX, firstChunkY, lastChunkX, lastChunkY);
+    int numBakes = TILE_CHUNK_BAKES_PER_FRAME;
+    for (int chunkY = firstChunkY; chunkY <= lastChunkY && numBakes > 0;
+         chunkY++) {
+        for (int chunkX = firstChunkX; chunkX <= lastChunkX && numBakes > 0;
+             chunkX++) {
+            if (m_chunks[chunkY * m_numChunkCols + chunkX].isDirty) {
+                BakeChunk(tileset, chunkX, chunkY);
+                numBakes--;
+            }
+        }
+    }
+
+    ReleaseFarChunks(camera);
+}
@@ -0,0 +1,102 @@
+#ifndef TILE_LAYER_H
+#define TILE_LAYER_H
+
+#include "../AssetStore/AssetStore.h"
+#include "../Renderer/RenderBackend.h"
+#include "./Tilemap.h"
+#include <SDL2/SDL.h>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Side of a baked chunk in world pixels
+const int TILE_CHUNK_SIZE = 512;
+
+// Chunks within this distance of the camera are baked ahead of being seen, a
+// few per frame, and the baked chunks further than twice that are released
+const int TILE_CHUNK_MARGIN = 512;
+const int TILE_CHUNK_BAKES_PER_FRAME = 2;
+
+// Frames to wait before creating a chunk texture again after it failed, the
+// chunks without a texture draw their tiles one by one meanwhile
+const int TILE_CHUNK_RETRY_FRAMES = 60;
+
+////////////////////////////////////////////////////////////////////////////////
+// TileLayer
+////////////////////////////////////////////////////////////////////////////////
+// Draws a tilemap from a single tileset. The map is split in chunks that are
+// baked into render target textures as they get close to the camera, so each
+// frame only the chunks overlapping the camera are copied to the screen. Far
+// away chunks are released, the textures alive stay the same however large
+// the map is. Changing a tile marks its chunk dirty and it gets baked again
+// before the next draw. The layer may draw on the render thread, so it never
+// reads the AssetStore: the caller passes in the tileset region it resolved
+// on the simulation thread.
+////////////////////////////////////////////////////////////////////////////////
+class TileLayer {
+private:
+    struct Chunk {
+        SDL_Texture* texture;
+        bool         isDirty;
+    };
+
+    // Chunk textures are released through the backend that created them
+    RenderBackend* m_renderer;
+
+    std::shared_ptr<Tilemap> m_tilemap;
+    int                      m_numCols;
+    int                      m_numRows;
+    int                      m_tileSize;
+    double                   m_tileScale;
+    TextureHandle            m_tileset;
+
+    // Number of tiles along one side of a chunk
+    int                m_chunkTiles;
+    int                m_numChunkCols;
+    int                m_numChunkRows;
+    std::vector<Chunk> m_chunks;
+
+    // Chunks holding a texture [Vector value = chunk index]
+    std::vector<int> m_bakedChunks;
+
+    // Frames rendered, and the first one that may create a chunk texture
+    int m_frame = 0;
+    int m_nextTextureFrame = 0;
+
+    int  GetScaledTileSize() const;
+    void GetChunkRange(const SDL_Rect& area, int& firstChunkX,
+                       int& firstChunkY, int& lastChunkX,
+                       int& lastChunkY) const;
+    void ReleaseFarChunks(const SDL_Rect& camera);
+    void DrawTiles(const TextureRegion& tileset, int firstCol, int firstRow,
+                   int lastCol, int lastRow, int offsetX, int offsetY) const;
+    // Returns false if the chunk has no texture to bake into
+    bool BakeChunk(const TextureRegion& tileset, int chunkX, int chunkY);
+
+public:
+    TileLayer(RenderBackend& renderer, std::shared_ptr<Tilemap> tilemap,
+              double tileScale, TextureHandle tileset);
+    ~TileLayer();
+
+    // Tile indices count tileset cells left to right, top to bottom
+    void          SetTile(int x, int y, std::uint16_t tile);
+    std::uint16_t GetTile(int x, int y) const;
+
+    TextureHandle GetTileset() const { return m_tileset; }
+
+    int GetWidth() const { return m_numCols * GetScaledTileSize(); }
+    int GetHeight() const { return m_numRows * GetScaledTileSize(); }
+
+    // Bakes the dirty chunks overlapping the area, ahead of their first draw
+    void Bake(const TextureRegion& tileset, const SDL_Rect& area);
+
+    // Forces every chunk to be baked again, needed when the renderer drops
+    // the content of its render targets
+    void Invalidate();
+
+    void Render(const TextureRegion& tileset, const SDL_Rect& camera);
+
+    int GetNumBakedChunks() const { return m_bakedChunks.size(); }
+};
+
+#endif // !TILE_LAYER_H
@@ -0,0 +1,239 @@
+#include "./Tilemap.h"
+#include "../Logger/Logger.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+Tilemap::~Tilemap() { Destroy(); }
+
+void Tilemap::Destroy() {
+    if (m_mapping) {
+        munmap(m_mapping, m_mappingSize);
+    }
+    m_mapping = nullptr;
+    m_mappingSize = 0;
+    m_tiles = nullptr;
+    m_ownedTiles.clear();
+    m_ownedTiles.shrink_to_fit();
+    m_tileFlags.clear();
+    m_numCols = 0;
+    m_numRows = 0;
+}
+
+void Tilemap::SetLayout(int numCols, int numRows, int tileSize,
+                        int chunkTiles) {
+    m_numCols = numCols;
+    m_numRows = numRows;
+    m_tileSize = tileSize;
+    m_chunkShift = 0;
+    while ((1 << m_chunkShift) < chunkTiles) {
+        m_chunkShift++;
+    }
+    m_numChunkCols = (numCols + chunkTiles - 1) / chunkTiles;
+    m_numChunkRows = (numRows + chunkTiles - 1) / chunkTiles;
+}
+
+std::size_t Tilemap::GetNumBytes() const {
+    return static_cast<std::size_t>(m_numChunkCols) * m_numChunkRows *
+           GetChunkTiles() * GetChunkTiles() * sizeof(std::uint16_t);
+}
+
+void Tilemap::Create(int numCols, int numRows, int tileSize) {
+    Destroy();
+    SetLayout(numCols, numRows, tileSize, TILEMAP_CHUNK_TILES);
+    m_ownedTiles.assign(GetNumBytes() / sizeof(std::uint16_t), EMPTY_TILE);
+    m_tiles = m_ownedTiles.data();
+}
+
+bool Tilemap::Load(const std::string& filePath) {
+    Destroy();
+
+    int file = open(filePath.c_str(), O_RDONLY);
+    if (file < 0) {
+        Logger::Err("Error opening tilemap " + filePath);
+        return false;
+    }
+
+    struct stat fileStat;
+    if (fstat(file, &fileStat) != 0 ||
+        fileStat.st_size < static_cast<off_t>(sizeof(TilemapHeader))) {
+        Logger::Err("Tilemap " + filePath + " is too small");
+        close(file);
+        return false;
+    }
+
+    // Private and writable: edited tiles are copied on write, the file never
+    // changes
+    void* data = mmap(nullptr, fileStat.st_size, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE, file, 0);
+    close(file);
+    if (data == MAP_FAILED) {
+        Logger::Err("Error mapping tilemap " + filePath);
+        return false;
+    }
+    m_mapping = data;
+    m_mappingSize = fileStat.st_size;
+
+    const auto* header = static_cast<const TilemapHeader*>(data);
+    const int   chunkTiles = header->chunkTiles;
+    const bool  isValidHeader =
+        std::memcmp(header->magic, TILEMAP_MAGIC, 4) == 0 &&
+        header->version == TILEMAP_VERSION && header->numCols > 0 &&
+        header->numRows > 0 && header->numCols <= 65536 &&
+        header->numRows <= 65536 && header->tileSize > 0 &&
+        header->tileSize <= 4096 && chunkTiles > 0 && chunkTiles <= 1024 &&
+        (chunkTiles & (chunkTiles - 1)) == 0 && header->numTileTypes <= 65536;
+    if (!isValidHeader) {
+        Logger::Err("Tilemap " + filePath + " has an invalid header");
+        Destroy();
+        return false;
+    }
+    SetLayout(header->numCols, header->numRows, header->tileSize, chunkTiles);
+
+    // The tiles start on the first 16 byte boundary after the flags
+    const std::size_t tilesOffset =
+        (sizeof(TilemapHeader) + header->numTileTypes + 15) & ~std::size_t(15);
+    if (tilesOffset + GetNumBytes() > m_mappingSize) {
+        Logger::Err("Tilemap " + filePath + " is truncated");
+        Destroy();
+        return false;
+    }
+
+    const auto* flags =
+        static_cast<const std::uint8_t*>(data) + sizeof(TilemapHeader);
+    m_tileFlags.assign(flags, flags + header->numTileTypes);
+    m_tiles = reinterpret_cast<std::uint16_t*>(
+        static_cast<std::uint8_t*>(data) + tilesOffset);
+
+    Logger::Log("Tilemap " + filePath + " mapped with " +
+                std::to_string(m_numCols) + "x" + std::to_string(m_numRows) +
+                " tiles");
+    return true;
+}
+
+bool Tilemap::Save(const std::string& filePath) const {
+    std::ofstream file(filePath, std::ios::binary);
+    if (!file) {
+        Logger::Err("Error creating tilemap " + filePath);
+        return false;
+    }
+
+    TilemapHeader header = {};
+    std::memcpy(header.magic, TILEMAP_MAGIC, 4);
+    header.version = TILEMAP_VERSION;
+    header.numCols = m_numCols;
+    header.numRows = m_numRows;
+    header.tileSize = m_tileSize;
+    header.chunkTiles = GetChunkTiles();
+    header.numTileTypes = m_tileFlags.size();
+
+    std::vector<char> flags(
+        ((sizeof(header) + m_tileFlags.size() + 15) & ~std::size_t(15)) -
+            sizeof(header),
+        0);
+    std::copy(m_tileFlags.begin(), m_tileFlags.end(), flags.begin());
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(flags.data(), flags.size());
+    file.write(reinterpret_cast<const char*>(m_tiles), GetNumBytes());
+    if (!file) {
+        Logger::Err("Error writing tilemap " + filePath);
+        return false;
+    }
+    return true;
+}
+
+bool Tilemap::LoadText(const std::string& filePath, int tileSize,
+                       int tilesetCols) {
+    std::ifstream file(filePath);
+    if (!file) {
+        Logger::Err("Error opening tilemap " + filePath);
+        return false;
+    }
+
+    // The size of the map is only known once every line is read
+    std::vector<std::vector<std::uint16_t>> rows;
+    std::string                             line;
+    int                                     numCols = 0;
+    while (std::getline(file, line)) {
+        std::vector<std::uint16_t> row;
+        std::size_t                start = 0;
+        while (start < line.size()) {
+            std::size_t end = line.find(',', start);
+            if (end == std::string::npos) {
+                end = line.size();
+            }
+            std::string token = line.substr(start, end - start);
+            token.erase(0, token.find_first_not_of(" \t\r"));
+            token.erase(token.find_last_not_of(" \t\r") + 1);
+            start = end + 1;
+            if (token.empty()) {
+                continue;
+            }
+
+            if (token.size() != 2 || !std::isdigit(token[0]) ||
+                !std::isdigit(token[1])) {
+                Logger::Err("Invalid tile '" + token + "' in tilemap " +
+                            filePath);
+                return false;
+            }
+            row.push_back((token[0] - '0') * tilesetCols + (token[1] - '0'));
+        }
+        if (!row.empty()) {
+            numCols = std::max(numCols, static_cast<int>(row.size()));
+            rows.push_back(std::move(row));
+        }
+    }
+    if (rows.empty()) {
+        Logger::Err("Tilemap " + filePath + " is empty");
+        return false;
+    }
+
+    Create(numCols, rows.size(), tileSize);
+    for (std::size_t y = 0; y < rows.size(); y++) {
+        for (std::size_t x = 0; x < rows[y].size(); x++) {
+            SetTile(x, y, rows[y][x]);
+        }
+    }
+    return true;
+}
+
+void Tilemap::SetTileFlags(std::uint16_t tile, std::uint8_t flags) {
+    if (tile >= m_tileFlags.size()) {
+        m_tileFlags.resize(tile + 1, 0);
+    }
+    m_tileFlags[tile] = flags;
+}
+
+bool Tilemap::OverlapsSolid(double x, double y, double width, double height,
+                            double tileWorldSize) const {
+    if (m_tileFlags.empty()) {
+        return false;
+    }
+
+    // Only the tiles under the area are tested, the right and bottom edges
+    // are exclusive
+    const int firstCol = std::max(0, static_cast<int>(x / tileWorldSize));
+    const int firstRow = std::max(0, static_cast<int>(y / tileWorldSize));
+    const int lastCol = std::min(
+        m_numCols - 1,
+        static_cast<int>(std::ceil((x + width) / tileWorldSize)) - 1);
+    const int lastRow = std::min(
+        m_numRows - 1,
+        static_cast<int>(std::ceil((y + height) / tileWorldSize)) - 1);
+
+    for (int row = firstRow; row <= lastRow; row++) {
+        for (int col = firstCol; col <= lastCol; col++) {
+            if (GetTileFlags(GetTile(col, row)) & TILE_FLAG_SOLID) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
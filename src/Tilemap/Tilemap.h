@@ -0,0 +1,135 @@
+#ifndef TILEMAP_H
+#define TILEMAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+// Tilemap file format
+////////////////////////////////////////////////////////////////////////////////
+// A header, one flags byte per tile index and the tile indices of the map as
+// dense square chunks, each chunk row-major and the chunks themselves in row
+// order. Chunks on the right and bottom edges are padded with EMPTY_TILE. The
+// file is mapped and used as it is, without parsing. Written offline by
+// tools/TilemapConverter.cpp.
+////////////////////////////////////////////////////////////////////////////////
+const char          TILEMAP_MAGIC[4] = {'G', 'M', 'A', 'P'};
+const std::uint32_t TILEMAP_VERSION = 1;
+
+// Tiles along one side of a chunk, a power of two
+const int TILEMAP_CHUNK_TILES = 32;
+
+const std::uint16_t EMPTY_TILE = 0xFFFF;
+
+enum TileFlags : std::uint8_t { TILE_FLAG_SOLID = 1 << 0 };
+
+struct TilemapHeader {
+    char          magic[4];
+    std::uint32_t version;
+    std::uint32_t numCols;
+    std::uint32_t numRows;
+    std::uint32_t tileSize;
+    std::uint32_t chunkTiles;
+    // Entries in the flags table, tile indices past it have no flags
+    std::uint32_t numTileTypes;
+    std::uint32_t reserved;
+};
+
+static_assert(sizeof(TilemapHeader) == 32, "Tilemap header layout");
+
+////////////////////////////////////////////////////////////////////////////////
+// Tilemap
+////////////////////////////////////////////////////////////////////////////////
+// Grid of tile indices stored chunk by chunk, so a chunk is one contiguous
+// block whether it is drawn or tested for collisions. The grid is either
+// mapped from a tilemap file, copy on write, or built in memory.
+////////////////////////////////////////////////////////////////////////////////
+class Tilemap {
+private:
+    int m_numCols = 0;
+    int m_numRows = 0;
+    int m_tileSize = 0;
+
+    int m_chunkShift = 0;
+    int m_numChunkCols = 0;
+    int m_numChunkRows = 0;
+
+    // Points into the mapping or into m_ownedTiles
+    std::uint16_t*             m_tiles = nullptr;
+    std::vector<std::uint16_t> m_ownedTiles;
+    void*                      m_mapping = nullptr;
+    std::size_t                m_mappingSize = 0;
+
+    // Flags per tile index, small enough to always be copied
+    std::vector<std::uint8_t> m_tileFlags;
+
+    void SetLayout(int numCols, int numRows, int tileSize, int chunkTiles);
+
+public:
+    Tilemap() = default;
+    ~Tilemap();
+
+    Tilemap(const Tilemap&) = delete;
+    Tilemap& operator=(const Tilemap&) = delete;
+
+    // Every tile starts empty
+    void Create(int numCols, int numRows, int tileSize);
+
+    // Maps a tilemap file, SetTile() changes stay in memory
+    bool Load(const std::string& filePath);
+    bool Save(const std::string& filePath) const;
+
+    // Parses a text map of comma separated tiles, one map row per line. A
+    // tile is two digits, the row and the column of the tile in the tileset.
+    bool LoadText(const std::string& filePath, int tileSize, int tilesetCols);
+
+    void Destroy();
+
+    int GetNumCols() const { return m_numCols; }
+    int GetNumRows() const { return m_numRows; }
+    int GetTileSize() const { return m_tileSize; }
+    int GetChunkTiles() const { return 1 << m_chunkShift; }
+
+    bool IsInside(int x, int y) const {
+        return x >= 0 && y >= 0 && x < m_numCols && y < m_numRows;
+    }
+
+    std::uint16_t GetTile(int x, int y) const {
+        return m_tiles[GetTileIndex(x, y)];
+    }
+    void SetTile(int x, int y, std::uint16_t tile) {
+        m_tiles[GetTileIndex(x, y)] = tile;
+    }
+
+    // Offset of the tile from the start of the grid
+    std::size_t GetTileIndex(int x, int y) const {
+        const int         chunkMask = (1 << m_chunkShift) - 1;
+        const std::size_t chunk =
+            static_cast<std::size_t>(y >> m_chunkShift) * m_numChunkCols +
+            (x >> m_chunkShift);
+        return (chunk << (2 * m_chunkShift)) +
+               ((y & chunkMask) << m_chunkShift) + (x & chunkMask);
+    }
+
+    void         SetTileFlags(std::uint16_t tile, std::uint8_t flags);
+    std::uint8_t GetTileFlags(std::uint16_t tile) const {
+        return tile < m_tileFlags.size() ? m_tileFlags[tile] : 0;
+    }
+
+    // Tiles outside the map are never solid
+    bool IsSolid(int x, int y) const {
+        return IsInside(x, y) &&
+               (GetTileFlags(GetTile(x, y)) & TILE_FLAG_SOLID);
+    }
+
+    // True if the area overlaps any solid tile, with the area in world pixels
+    // and the tiles drawn tileWorldSize pixels wide
+    bool OverlapsSolid(double x, double y, double width, double height,
+                       double tileWorldSize) const;
+
+    std::size_t GetNumBytes() const;
+};
+
+#endif // !TILEMAP_H
@@ -0,0 +1,71 @@
+#include "TimerWheel.h"
+#include "../Profiler/Profiler.h"
+#include <algorithm>
+
+void TimerWheel::Insert(const Timer& timer) {
+    const int time = std::max(timer.time, m_nextTime);
+
+    // The lowest level whose current span also holds the due time
+    int level = 0;
+    while (level < TIMER_WHEEL_LEVELS - 1) {
+        const int shift = TIMER_WHEEL_SLOT_BITS * (level + 1);
+        if ((time >> shift) == (m_nextTime >> shift)) {
+            break;
+        }
+        level++;
+    }
+    const int slot = (time >> (TIMER_WHEEL_SLOT_BITS * level)) &
+                     (TIMER_WHEEL_SLOTS - 1);
+    m_slots[level][slot].push_back(timer);
+}
+
+void TimerWheel::Cascade() {
+    int level = 1;
+    while (level < TIMER_WHEEL_LEVELS - 1 &&
+           (m_nextTime &
+            ((1 << (TIMER_WHEEL_SLOT_BITS * (level + 1))) - 1)) == 0) {
+        level++;
+    }
+
+    // From the top so what comes down from a level is cascaded again by the
+    // level below
+    for (; level >= 1; level--) {
+        const int slot = (m_nextTime >> (TIMER_WHEEL_SLOT_BITS * level)) &
+                         (TIMER_WHEEL_SLOTS - 1);
+        m_cascadedTimers.swap(m_slots[level][slot]);
+        for (const auto& timer : m_cascadedTimers) {
+            Insert(timer);
+        }
+        m_cascadedTimers.clear();
+    }
+}
+
+std::uint32_t TimerWheel::Schedule(TimerType type, int time, Entity entity) {
+    Timer timer = {entity, time, m_nextId++, type};
+    Insert(timer);
+    m_numTimers++;
+    return timer.id;
+}
+
+void TimerWheel::Advance(int time) {
+    PROFILE_ZONE("TimerWheel::Advance");
+    for (auto& dueTimers : m_dueTimers) {
+        dueTimers.clear();
+    }
+    m_numDueTimers = 0;
+
+    while (m_nextTime <= time) {
+        if ((m_nextTime & (TIMER_WHEEL_SLOTS - 1)) == 0) {
+            Cascade();
+        }
+        auto& slot = m_slots[0][m_nextTime & (TIMER_WHEEL_SLOTS - 1)];
+        for (const auto& timer : slot) {
+            m_dueTimers[timer.type].push_back(timer);
+        }
+        m_numDueTimers += slot.size();
+        m_numTimers -= slot.size();
+        slot.clear();
+        m_nextTime++;
+    }
+    m_time = time;
+}
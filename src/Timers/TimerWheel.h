@@ -0,0 +1,76 @@
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include "../ECS/ECS.h"
+#include <cstdint>
+#include <vector>
+
+// Each level of the wheel spans 256 times the span of the level below, four
+// levels cover every simulation time in milliseconds
+const int TIMER_WHEEL_SLOT_BITS = 8;
+const int TIMER_WHEEL_SLOTS = 1 << TIMER_WHEEL_SLOT_BITS;
+const int TIMER_WHEEL_LEVELS = 4;
+
+enum TimerType {
+    TIMER_PROJECTILE_EMISSION,
+    TIMER_PROJECTILE_EXPIRY,
+    NUM_TIMER_TYPES
+};
+
+struct Timer {
+    Entity        entity;
+    // Simulation time in milliseconds the timer is due at
+    int           time;
+    // Unique per timer, the component that scheduled it keeps the id to tell
+    // its current timer from the ones it outlived
+    std::uint32_t id;
+    TimerType     type;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// TimerWheel
+////////////////////////////////////////////////////////////////////////////////
+// Hierarchical timer wheel keyed on simulation time. A timer is filed in the
+// slot of its due time on the lowest level whose span still holds it, and is
+// moved down a level whenever the wheel below turns over, so advancing the
+// wheel only touches the timers that are due and the few that cascade. Timers
+// are never cancelled: whoever handles a due timer checks its id against the
+// one it scheduled last and ignores the stale ones.
+////////////////////////////////////////////////////////////////////////////////
+class TimerWheel {
+private:
+    std::vector<Timer> m_slots[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS];
+    std::vector<Timer> m_dueTimers[NUM_TIMER_TYPES];
+    // Scratch list for the timers moved down a level
+    std::vector<Timer> m_cascadedTimers;
+
+    // Time of the last Advance(), and the first millisecond whose slot has
+    // not been emptied yet
+    int           m_time = 0;
+    int           m_nextTime = 0;
+    std::uint32_t m_nextId = 1;
+    int           m_numTimers = 0;
+    int           m_numDueTimers = 0;
+
+    void Insert(const Timer& timer);
+    // Moves the timers of the span starting at m_nextTime down from the
+    // levels that turned over
+    void Cascade();
+
+public:
+    // Returns the id of the timer. A time already past is due on the next
+    // Advance().
+    std::uint32_t Schedule(TimerType type, int time, Entity entity);
+
+    // Replaces the due timers with every timer due up to the time
+    void Advance(int time);
+    const std::vector<Timer>& GetDueTimers(TimerType type) const {
+        return m_dueTimers[type];
+    }
+
+    int GetTime() const { return m_time; }
+    int GetNumTimers() const { return m_numTimers; }
+    int GetNumDueTimers() const { return m_numDueTimers; }
+};
+
+#endif // !TIMER_WHEEL_H
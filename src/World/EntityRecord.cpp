@@ -0,0 +1,46 @@
+#include "./EntityRecord.h"
+
+template <typename TComponent>
+static void SaveComponent(Entity entity, std::optional<TComponent>& record) {
+    if (entity.HasComponent<TComponent>()) {
+        record = entity.GetComponent<TComponent>();
+    } else {
+        record.reset();
+    }
+}
+
+template <typename TComponent>
+static void SpawnComponent(Entity                           entity,
+                           const std::optional<TComponent>& record) {
+    if (record) {
+        entity.AddComponent<TComponent>(*record);
+    }
+}
+
+void EntityRecord::Save(Entity entity) {
+    group = entity.registry->GetEntityGroup(entity);
+    SaveComponent(entity, transform);
+    SaveComponent(entity, rigidBody);
+    SaveComponent(entity, sprite);
+    SaveComponent(entity, animation);
+    SaveComponent(entity, boxCollider);
+    SaveComponent(entity, health);
+    SaveComponent(entity, projectileEmitter);
+    SaveComponent(entity, script);
+}
+
+Entity EntityRecord::Spawn(Registry& registry) const {
+    Entity entity = registry.CreateEntity();
+    if (!group.empty()) {
+        entity.Group(group);
+    }
+    SpawnComponent(entity, transform);
+    SpawnComponent(entity, rigidBody);
+    SpawnComponent(entity, sprite);
+    SpawnComponent(entity, animation);
+    SpawnComponent(entity, boxCollider);
+    SpawnComponent(entity, health);
+    SpawnComponent(entity, projectileEmitter);
+    SpawnComponent(entity, script);
+    return entity;
+}
@@ -0,0 +1,41 @@
+#ifndef ENTITY_RECORD_H
+#define ENTITY_RECORD_H
+
+#include "../Components/AnimationComponent.h"
+#include "../Components/BoxColliderComponent.h"
+#include "../Components/HealthComponent.h"
+#include "../Components/ProjectileEmitterComponent.h"
+#include "../Components/RigidBodyComponent.h"
+#include "../Components/ScriptComponent.h"
+#include "../Components/SpriteComponent.h"
+#include "../Components/TransformComponent.h"
+#include "../ECS/ECS.h"
+#include <optional>
+#include <string>
+
+////////////////////////////////////////////////////////////////////////////////
+// EntityRecord
+////////////////////////////////////////////////////////////////////////////////
+// The components of an entity that is not alive in the registry, either not
+// spawned yet or saved when its world cell was unloaded
+////////////////////////////////////////////////////////////////////////////////
+struct EntityRecord {
+    std::string group;
+
+    std::optional<TransformComponent>         transform;
+    std::optional<RigidBodyComponent>         rigidBody;
+    std::optional<SpriteComponent>            sprite;
+    std::optional<AnimationComponent>         animation;
+    std::optional<BoxColliderComponent>       boxCollider;
+    std::optional<HealthComponent>            health;
+    std::optional<ProjectileEmitterComponent> projectileEmitter;
+    std::optional<ScriptComponent>            script;
+
+    // Captures the components of a live entity
+    void Save(Entity entity);
+
+    // Creates a new entity with the recorded components
+    Entity Spawn(Registry& registry) const;
+};
+
+#endif // !ENTITY_RECORD_H
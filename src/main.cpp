@@ -1,9 +1,97 @@
 #include "./Game/Game.h"
+#include "./Logger/Logger.h"
+#include <cstdlib>
+#include <string>
+
+// Usage: gameengine [--renderer sdl|software|cpu|null] [--headless]
+//                   [--capture <directory>] [--frames <count>] [--pipelined]
+//                   [--archive <file>] [--asset-budget <megabytes>]
+//                   [--tick-rate <hz>] [--max-catch-up <ticks>] [--uncapped]
+//                   [--ticks <count>] [--level <number>] [--trace <file>]
+//                   [--metrics <file>] [--metrics-port <port>]
+//                   [--metrics-socket <path>] [--perf-counters]
+//                   [--record <file>] [--replay <file>]
+//                   [--replay-report <file>] [--hash-interval <ticks>]
+//                   [--log-level debug|info|warning|error]
+GameOptions ParseOptions(int argc, char* argv[]) {
+    GameOptions options;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool        hasValue = i + 1 < argc;
+
+        if (arg == "--renderer" && hasValue) {
+            std::string renderer = argv[++i];
+            if (renderer == "software") {
+                options.renderBackend = RENDER_BACKEND_SOFTWARE;
+            } else if (renderer == "cpu") {
+                options.renderBackend = RENDER_BACKEND_CPU;
+            } else if (renderer == "null") {
+                options.renderBackend = RENDER_BACKEND_NULL;
+            } else {
+                options.renderBackend = RENDER_BACKEND_SDL;
+            }
+        } else if (arg == "--headless") {
+            options.isHeadless = true;
+        } else if (arg == "--ticks" && hasValue) {
+            options.maxTicks = std::atoi(argv[++i]);
+        } else if (arg == "--log-level" && hasValue) {
+            std::string level = argv[++i];
+            if (level == "info") {
+                options.logLevel = LOG_INFO;
+            } else if (level == "warning") {
+                options.logLevel = LOG_WARNING;
+            } else if (level == "error") {
+                options.logLevel = LOG_ERROR;
+            } else {
+                options.logLevel = LOG_DEBUG;
+            }
+        } else if (arg == "--level" && hasValue) {
+            options.level = std::atoi(argv[++i]);
+        } else if (arg == "--metrics" && hasValue) {
+            options.metricsPath = argv[++i];
+        } else if (arg == "--metrics-port" && hasValue) {
+            options.metricsPort = std::atoi(argv[++i]);
+        } else if (arg == "--metrics-socket" && hasValue) {
+            options.metricsSocket = argv[++i];
+        } else if (arg == "--perf-counters") {
+            options.isPerfCounters = true;
+        } else if (arg == "--record" && hasValue) {
+            options.recordPath = argv[++i];
+        } else if (arg == "--replay" && hasValue) {
+            options.replayPath = argv[++i];
+        } else if (arg == "--replay-report" && hasValue) {
+            options.replayReportPath = argv[++i];
+        } else if (arg == "--hash-interval" && hasValue) {
+            options.hashInterval = std::atoi(argv[++i]);
+        } else if (arg == "--trace" && hasValue) {
+            options.tracePath = argv[++i];
+        } else if (arg == "--capture" && hasValue) {
+            options.captureDirectory = argv[++i];
+        } else if (arg == "--frames" && hasValue) {
+            options.maxFrames = std::atoi(argv[++i]);
+        } else if (arg == "--pipelined") {
+            options.isPipelined = true;
+        } else if (arg == "--archive" && hasValue) {
+            options.assetArchive = argv[++i];
+        } else if (arg == "--asset-budget" && hasValue) {
+            options.assetBudgetMb = std::atoi(argv[++i]);
+        } else if (arg == "--tick-rate" && hasValue) {
+            options.tickRate = std::atoi(argv[++i]);
+        } else if (arg == "--max-catch-up" && hasValue) {
+            options.maxCatchUpSteps = std::atoi(argv[++i]);
+        } else if (arg == "--uncapped") {
+            options.isUncapped = true;
+        } else {
+            Logger::Err("Unknown option " + arg);
+        }
+    }
+    return options;
+}
 
 int main(int argc, char* argv[]) {
     Game game;
 
-    game.Initialize();
+    game.Initialize(ParseOptions(argc, argv));
     game.Run();
     game.Destroy();
 
@@ -0,0 +1,196 @@
+////////////////////////////////////////////////////////////////////////////////
+// AssetPacker
+////////////////////////////////////////////////////////////////////////////////
+// Decodes images once, offline, and writes them to an asset archive the game
+// maps with --archive. With --residency it instead reports how much of each
+// file is in the page cache, to compare the archive with the loose images
+// after a cold start.
+//
+// Usage: assetpack [--lz4] <archive> <image>...
+//        assetpack --residency <file>...
+////////////////////////////////////////////////////////////////////////////////
+#include "../src/AssetStore/AssetArchive.h"
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+#ifdef ASSET_ARCHIVE_LZ4
+#include <lz4hc.h>
+#endif
+
+std::uint64_t AlignOffset(std::uint64_t offset) {
+    return (offset + ASSET_ARCHIVE_ALIGNMENT - 1) &
+           ~(ASSET_ARCHIVE_ALIGNMENT - 1);
+}
+
+// Returns the RGBA32 pixels of the image, tightly packed
+bool DecodeImage(const std::string& filePath, int& width, int& height,
+                 std::vector<char>& pixels) {
+    SDL_Surface* surface = IMG_Load(filePath.c_str());
+    if (!surface) {
+        std::fprintf(stderr, "Error loading %s: %s\n", filePath.c_str(),
+                     IMG_GetError());
+        return false;
+    }
+    SDL_Surface* converted =
+        SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_RGBA32, 0);
+    SDL_FreeSurface(surface);
+    if (!converted) {
+        std::fprintf(stderr, "Error converting %s: %s\n", filePath.c_str(),
+                     SDL_GetError());
+        return false;
+    }
+
+    width = converted->w;
+    height = converted->h;
+    pixels.resize(static_cast<size_t>(width) * height * 4);
+    for (int y = 0; y < height; y++) {
+        std::memcpy(&pixels[static_cast<size_t>(y) * width * 4],
+                    static_cast<char*>(converted->pixels) +
+                        y * converted->pitch,
+                    width * 4);
+    }
+    SDL_FreeSurface(converted);
+    return true;
+}
+
+int Pack(const std::string& archivePath, const std::vector<std::string>& files,
+         bool isCompressed) {
+#ifndef ASSET_ARCHIVE_LZ4
+    if (isCompressed) {
+        std::fprintf(stderr, "Built without LZ4, rebuild with make LZ4=1\n");
+        return 1;
+    }
+#endif
+
+    std::vector<AssetArchiveEntry> entries(files.size());
+    std::vector<std::vector<char>> blobs(files.size());
+    std::uint64_t                  offset = AlignOffset(
+        sizeof(AssetArchiveHeader) + files.size() * sizeof(AssetArchiveEntry));
+    std::uint64_t rawBytes = 0;
+
+    for (size_t i = 0; i < files.size(); i++) {
+        std::string path = AssetArchive::NormalizePath(files[i]);
+        if (path.size() >= static_cast<size_t>(ASSET_ARCHIVE_PATH_SIZE)) {
+            std::fprintf(stderr, "Path too long: %s\n", path.c_str());
+            return 1;
+        }
+
+        int width;
+        int height;
+        if (!DecodeImage(files[i], width, height, blobs[i])) {
+            return 1;
+        }
+        // The game refuses archives holding bigger images
+        if (width > static_cast<int>(ASSET_ARCHIVE_MAX_IMAGE_SIZE) ||
+            height > static_cast<int>(ASSET_ARCHIVE_MAX_IMAGE_SIZE)) {
+            std::fprintf(stderr, "Image too big: %s\n", path.c_str());
+            return 1;
+        }
+        rawBytes += blobs[i].size();
+
+        AssetArchiveEntry& entry = entries[i];
+        std::memset(&entry, 0, sizeof(entry));
+        std::strcpy(entry.path, path.c_str());
+        entry.width = width;
+        entry.height = height;
+        entry.compression = ASSET_COMPRESSION_NONE;
+
+#ifdef ASSET_ARCHIVE_LZ4
+        if (isCompressed) {
+            const int         rawSize = static_cast<int>(blobs[i].size());
+            std::vector<char> compressed(LZ4_compressBound(rawSize));
+            const int         size =
+                LZ4_compress_HC(blobs[i].data(), compressed.data(), rawSize,
+                                compressed.size(), LZ4HC_CLEVEL_MAX);
+            // Keep the raw pixels when compressing does not pay off, they can
+            // be used straight from the mapping
+            if (size > 0 && size < rawSize) {
+                compressed.resize(size);
+                blobs[i].swap(compressed);
+                entry.compression = ASSET_COMPRESSION_LZ4;
+            }
+        }
+#endif
+
+        entry.offset = offset;
+        entry.size = blobs[i].size();
+        offset = AlignOffset(offset + entry.size);
+    }
+
+    std::ofstream archive(archivePath, std::ios::binary | std::ios::trunc);
+    if (!archive) {
+        std::fprintf(stderr, "Error creating %s\n", archivePath.c_str());
+        return 1;
+    }
+
+    AssetArchiveHeader header;
+    std::memcpy(header.magic, ASSET_ARCHIVE_MAGIC, 4);
+    header.version = ASSET_ARCHIVE_VERSION;
+    header.numEntries = entries.size();
+    header.reserved = 0;
+    archive.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    archive.write(reinterpret_cast<const char*>(entries.data()),
+                  entries.size() * sizeof(AssetArchiveEntry));
+
+    for (size_t i = 0; i < entries.size(); i++) {
+        std::vector<char> padding(entries[i].offset - archive.tellp(), 0);
+        archive.write(padding.data(), padding.size());
+        archive.write(blobs[i].data(), blobs[i].size());
+        std::printf("%-48s %5ux%-5u %9zu bytes%s\n", entries[i].path,
+                    entries[i].width, entries[i].height, blobs[i].size(),
+                    entries[i].compression == ASSET_COMPRESSION_LZ4 ? " lz4"
+                                                                   : "");
+    }
+    if (!archive) {
+        std::fprintf(stderr, "Error writing %s\n", archivePath.c_str());
+        return 1;
+    }
+
+    std::printf("Packed %zu images, %llu bytes of pixels into %llu bytes\n",
+                entries.size(), static_cast<unsigned long long>(rawBytes),
+                static_cast<unsigned long long>(archive.tellp()));
+    return 0;
+}
+
+int Residency(const std::vector<std::string>& files) {
+    size_t total = 0;
+    for (auto& file : files) {
+        size_t numBytes = AssetArchive::GetResidentBytes(file);
+        total += numBytes;
+        std::printf("%-48s %9zu bytes resident\n", file.c_str(), numBytes);
+    }
+    std::printf("Total %zu bytes resident\n", total);
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    bool                     isCompressed = false;
+    bool                     isResidency = false;
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--lz4") {
+            isCompressed = true;
+        } else if (arg == "--residency") {
+            isResidency = true;
+        } else {
+            files.push_back(arg);
+        }
+    }
+
+    if (isResidency) {
+        return Residency(files);
+    }
+    if (files.size() < 2) {
+        std::fprintf(stderr, "Usage: assetpack [--lz4] <archive> <image>...\n"
+                             "       assetpack --residency <file>...\n");
+        return 1;
+    }
+
+    std::vector<std::string> images(files.begin() + 1, files.end());
+    return Pack(files[0], images, isCompressed);
+}
@@ -0,0 +1,113 @@
+////////////////////////////////////////////////////////////////////////////////
+// TilemapConverter
+////////////////////////////////////////////////////////////////////////////////
+// Converts text maps to the binary tilemap format the game maps as it is.
+// Tiles listed with --solid block movement. With --generate it writes a map of
+// the given size instead, to measure how long large maps take to load.
+//
+// Usage: tilemapconv [--tile-size <pixels>] [--tileset-cols <count>]
+//                    [--solid <tile>,...] <text map> <tilemap>
+//        tilemapconv --generate <cols> <rows> <tilemap>
+////////////////////////////////////////////////////////////////////////////////
+#include "../src/Tilemap/Tilemap.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Maps the file back and reports how long it took
+int Verify(const std::string& filePath) {
+    auto    start = std::chrono::steady_clock::now();
+    Tilemap tilemap;
+    if (!tilemap.Load(filePath)) {
+        return 1;
+    }
+    double loadMs = std::chrono::duration<double, std::milli>(
+                        std::chrono::steady_clock::now() - start)
+                        .count();
+
+    std::printf("%s: %dx%d tiles, %zu bytes of tiles, loaded in %.3f ms\n",
+                filePath.c_str(), tilemap.GetNumCols(), tilemap.GetNumRows(),
+                tilemap.GetNumBytes(), loadMs);
+    return 0;
+}
+
+int Generate(int numCols, int numRows, const std::string& filePath) {
+    if (numCols <= 0 || numRows <= 0 || numCols > 65536 || numRows > 65536) {
+        std::fprintf(stderr, "Invalid map size %dx%d\n", numCols, numRows);
+        return 1;
+    }
+
+    // Ground with a solid border around the map
+    const std::uint16_t groundTile = 0;
+    const std::uint16_t wallTile = 1;
+    Tilemap             tilemap;
+    tilemap.Create(numCols, numRows, 32);
+    tilemap.SetTileFlags(wallTile, TILE_FLAG_SOLID);
+    for (int y = 0; y < numRows; y++) {
+        for (int x = 0; x < numCols; x++) {
+            bool isBorder =
+                x == 0 || y == 0 || x == numCols - 1 || y == numRows - 1;
+            tilemap.SetTile(x, y, isBorder ? wallTile : groundTile);
+        }
+    }
+
+    if (!tilemap.Save(filePath)) {
+        return 1;
+    }
+    return Verify(filePath);
+}
+
+int main(int argc, char* argv[]) {
+    int                      tileSize = 32;
+    int                      tilesetCols = 10;
+    std::vector<int>         solidTiles;
+    bool                     isGenerate = false;
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--tile-size" && i + 1 < argc) {
+            tileSize = std::atoi(argv[++i]);
+        } else if (arg == "--tileset-cols" && i + 1 < argc) {
+            tilesetCols = std::atoi(argv[++i]);
+        } else if (arg == "--solid" && i + 1 < argc) {
+            std::stringstream tiles(argv[++i]);
+            std::string       tile;
+            while (std::getline(tiles, tile, ',')) {
+                solidTiles.push_back(std::atoi(tile.c_str()));
+            }
+        } else if (arg == "--generate") {
+            isGenerate = true;
+        } else {
+            files.push_back(arg);
+        }
+    }
+
+    if (isGenerate && files.size() == 3) {
+        return Generate(std::atoi(files[0].c_str()),
+                        std::atoi(files[1].c_str()), files[2]);
+    }
+    if (isGenerate || files.size() != 2 || tileSize <= 0 || tilesetCols <= 0) {
+        std::fprintf(stderr,
+                     "Usage: tilemapconv [--tile-size <pixels>] "
+                     "[--tileset-cols <count>]\n"
+                     "                   [--solid <tile>,...] <text map> "
+                     "<tilemap>\n"
+                     "       tilemapconv --generate <cols> <rows> <tilemap>\n");
+        return 1;
+    }
+
+    Tilemap tilemap;
+    if (!tilemap.LoadText(files[0], tileSize, tilesetCols)) {
+        return 1;
+    }
+    for (int tile : solidTiles) {
+        tilemap.SetTileFlags(tile, TILE_FLAG_SOLID);
+    }
+    if (!tilemap.Save(files[1])) {
+        return 1;
+    }
+    return Verify(files[1]);
+}